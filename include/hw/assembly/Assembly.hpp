@@ -6,6 +6,7 @@
 #include <exception>
 
 #include <hw/utility/MMap.hpp>
+#include <hw/utility/Metrics.hpp>
 #include <hw/utility/Format.hpp>
 #include <hw/type/TypeList.hpp>
 #include <hw/assembly/Context.hpp>
@@ -40,7 +41,10 @@ public:
     mp_for_each<mp_iota_c<DISPATCHER_CNT>>( [this] (auto idx) {
       using DispatcherType = mp_at_c<DispatcherList, idx>;
       static_assert(std::is_same_v<EtherType, typename DispatcherType::EtherType>, "Ether mismatch");
-      std::get<idx>(_dispatchers).reset(new DispatcherType(_assembly, _context, _ether));
+      // optional pinning: "cpu_affinity": { "<dispatcher name>": core }
+      const std::string dispatcherName(type::TypeName<DispatcherType>());
+      const int core = _context.template getConfig<int>("cpu_affinity", dispatcherName, "-1");
+      std::get<idx>(_dispatchers).reset(new DispatcherType(_assembly, _context, _ether, core));
     });
   }
 
@@ -88,7 +92,9 @@ class Assembly {
   static constexpr size_t COMPARTMENT_CNT = mp_size<CompartmentList>::value;
 
 public:
-  Assembly(AppContext & context) : _context(context)
+  // "metrics": { "file": path } publishes the metrics registry to a file hw_metrics can read
+  Assembly(AppContext & context)
+    : _context(context), _metrics(_context.template getConfig<std::string>("metrics", "file", ""))
   {
     mp_for_each<mp_iota_c<COMPARTMENT_CNT>>( [this] (auto idx) {
       // instantiate ether
@@ -155,6 +161,8 @@ public:
 
   LocalClock & clock() { return _clock; }
 
+  MetricsRegistry & metrics() { return _metrics; }
+
 
   template <typename EtherType>
   std::shared_ptr<EtherType> getEther() {
@@ -165,6 +173,7 @@ public:
 
 private:
   AppContext &                        _context;
+  MetricsRegistry                     _metrics;
   EtherSet                            _ethers;
   CompartmentSet                      _compartments;
   std::unique_ptr<Shmem>              _shmem[COMPARTMENT_CNT];
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <functional>
 #include <string>
+#include <string_view>
 
 #include <hw/type/TypeList.hpp>
 #include <hw/type/NamedType.hpp>
 #include <hw/utility/Clock.hpp>
+#include <hw/utility/Metrics.hpp>
 #include <hw/assembly/Timer.hpp>
 
 namespace hw::assembly {
@@ -22,7 +25,7 @@ struct ComponentBase : public type::NamedType<Name, ComponentBase<Component, Nam
                 "Input list must be subset of Ether message list");
 
 ComponentBase(Dispatcher &dispatcher, AppContext & context)
-  : _dispatcher (dispatcher), _context(context), _clock(_dispatcher.clock()), _name (Name) {
+  : _dispatcher (dispatcher), _context(context), _clock(_dispatcher.clock()), _name (Name.toString()) {
   }
 
   ~ComponentBase() {
@@ -60,6 +63,16 @@ ComponentBase(Dispatcher &dispatcher, AppContext & context)
       return _dispatcher.template commitMsg (msg);
   }
 
+  template <typename MsgType>
+  void abortMsg(MsgType & msg) noexcept {
+    _dispatcher.template abortMsg (msg);
+  }
+
+  template <typename Ingest, typename Parse>
+  int ingest(Ingest & ingest, int fd, Parse && parse) {
+    return _dispatcher.ingest(ingest, fd, std::forward<Parse>(parse));
+  }
+
   template <typename EtherType>
   std::shared_ptr<EtherType> getEther() {
     return _dispatcher.template getEther<EtherType>();
@@ -76,11 +89,36 @@ ComponentBase(Dispatcher &dispatcher, AppContext & context)
 
   LocalClock & clock () const { return _clock; }
 
+  // Metrics named "<component>.<name>" in the dispatcher's shard; update from the dispatcher thread only.
+  utility::Counter counter(std::string_view name) {
+    return _dispatcher.metrics().counter(metricName(name));
+  }
+
+  utility::Gauge gauge(std::string_view name) {
+    return _dispatcher.metrics().gauge(metricName(name));
+  }
+
+  utility::Histogram histogram(std::string_view name) {
+    return _dispatcher.metrics().histogram(metricName(name));
+  }
+
+  // Called on the dispatcher thread about every 10ms, e.g. to publish a table's load into a gauge.
+  void probe(std::function<void()> callback) {
+    _dispatcher.addProbe(std::move(callback));
+  }
+
+  // Scratch memory valid until the end of the current batch; no free required.
+  utility::BumpArena & scratch () { return _dispatcher.scratch(); }
+
   void processBegin     () {}
   void processEnd       () {}
   void processBatchEnd  () {}
 
 private:
+  std::string metricName(std::string_view name) const {
+    return _name + "." + std::string(name);
+  }
+
   Dispatcher & _dispatcher;
   AppContext & _context;
   LocalClock & _clock;
@@ -1,17 +1,27 @@
 #pragma once
+#include <new>
 #include <thread>
+#include <vector>
+#include <functional>
 #include <stdexcept>
 #include <immintrin.h>
 #include <string_view>
 
 #include <hw/utility/CPU.hpp>
+#include <hw/utility/Arena.hpp>
 #include <hw/utility/Clock.hpp>
 #include <hw/utility/Buffer.hpp>
 #include <hw/utility/EPoller.hpp>
+#include <hw/utility/URingPoller.hpp>
 #include <hw/utility/Format.hpp>
+#include <hw/utility/MMap.hpp>
+#include <hw/utility/Metrics.hpp>
+#include <hw/utility/PerfCounters.hpp>
 #include <hw/type/NamedType.hpp>
 #include <hw/type/TypeList.hpp>
 #include <hw/assembly/Timer.hpp>
+#include <hw/assembly/EtherIngest.hpp>
+#include <hw/assembly/PerfStats.hpp>
 
 namespace hw::assembly {
 
@@ -31,8 +41,12 @@ struct EtherPlaceholder {
 
 struct DispatcherWithTimer {};
 struct DispatcherWithEpoll {};
+struct DispatcherWithURing : DispatcherWithEpoll {};          // io_uring backend instead of epoll
+struct DispatcherWithURingSQPoll : DispatcherWithURing {};    // plus kernel submission polling thread
+struct DispatcherWithBusyPoll : DispatcherWithEpoll {};       // epoll only for accept/connect, sockets read directly
 struct DispatcherWithBatchEnd {};
 struct DispatcherNonCritical {};
+struct DispatcherWithPerfCounters {};                        // hardware counters per component and message type, see PerfStats
 struct DefaultDispatcherTraits : DispatcherWithBatchEnd {};
 
 template<type::NameTag Name, typename AppContext, typename Ether, typename ComponentList, typename Traits = DefaultDispatcherTraits>
@@ -50,20 +64,39 @@ public:
   using EtherMsgList    = Ether::MsgList;
   using ComponentSet	  = mp_transform<type::make_unique_ptr_t, typename ComponentList::tuple_type>;
   using LocalClock      = utility::SystemClockTSC;
-  using EPoller         = utility::EPoller;
+  using EPoller         = std::conditional_t<std::is_base_of_v<DispatcherWithURing, Traits>,
+                                             utility::URingPoller, utility::EPoller>;
 
   static constexpr size_t COMPONENT_CNT = mp_size<ComponentList>::value;
   static constexpr bool USING_ETHER = false == std::is_same_v<EtherType, EtherPlaceholder>;
   static constexpr bool USING_TIMER = std::is_base_of_v<DispatcherWithTimer, Traits>;
   static constexpr bool USING_EPOLL = std::is_base_of_v<DispatcherWithEpoll, Traits>;
+  static constexpr bool USING_URING = std::is_base_of_v<DispatcherWithURing, Traits>;
+  static constexpr bool USING_SQPOLL = std::is_base_of_v<DispatcherWithURingSQPoll, Traits>;
+  static constexpr bool USING_BUSY_POLL = std::is_base_of_v<DispatcherWithBusyPoll, Traits>;
   static constexpr bool USING_BATCH_END = std::is_base_of_v<DispatcherWithBatchEnd, Traits>;
   static constexpr bool USING_YIELD = std::is_base_of_v<DispatcherNonCritical, Traits>;
+  static constexpr bool USING_PERF = std::is_base_of_v<DispatcherWithPerfCounters, Traits>;
+  static constexpr size_t SCRATCH_CHUNK_SIZE = 64 * 1024;
+  static constexpr size_t PROBE_CHECK_PERIOD = 64;                 // loop iterations between clock reads
+  static constexpr utility::Timestamp PROBE_INTERVAL = 10'000'000; // ns between probe runs
+  using PerfStatsType   = PerfStats<COMPONENT_CNT, mp_size<EtherMsgList>::value>;
 
 	Dispatcher(AssemblyType & assembly, AppContext & context, EtherType & ether, int core = -1)
     : _assembly(assembly), _context (context), _ether(ether), _cursor (ether),
-      _clock(_assembly.clock()), _core(core), _name (Name)
+      _clock(_assembly.clock()), _core(core), _name (Name.toString()),
+      _metrics(_assembly.metrics().shard(_name))
   {
-    if (USING_EPOLL) {
+    // before the components, so their constructors can declare metrics and probes
+    initMetrics();
+
+    if constexpr (USING_URING) {
+      _epoller = std::make_unique<EPoller> (utility::URingConfig{.sqpoll = USING_SQPOLL});
+    }
+    else if constexpr (USING_BUSY_POLL) {
+      _epoller = std::make_unique<EPoller> (utility::BusyPollConfig{.enabled = true});
+    }
+    else if constexpr (USING_EPOLL) {
       _epoller = std::make_unique<EPoller> ();
     }
 
@@ -71,6 +104,10 @@ public:
       using ComponentType = mp_at_c<ComponentList, idx>;
       std::get<idx>(_components).reset(new ComponentType(*this, _context));
     });
+
+    if constexpr (USING_PERF) {
+      initPerfStats();
+    }
   }
 
   Dispatcher (const Dispatcher &) = delete;
@@ -83,6 +120,10 @@ public:
 
   template <typename MsgType, typename ... Args>
   MsgType & allocMsg(Args &&... args) noexcept {
+    if (!_cursor.template canPublish<MsgType>()) [[unlikely]] {
+      fatalExit(frmt::format("message type #{} is unknown to a binary attached to the ether; it knows {} type(s)",
+        mp_find<typename EtherType::MsgList, MsgType>::value, _ether.peerMsgCnt()));
+    }
     return _cursor.template allocMsg<MsgType>(std::forward<Args>(args)...);
   }
 
@@ -91,10 +132,22 @@ public:
     return _cursor.template commitMsg (msg) ;
   }
 
+  template <typename MsgType>
+  void abortMsg(MsgType & msg) noexcept {
+    _cursor.template abortMsg (msg);
+  }
+
+  // Zero-copy receive: datagrams land in ether slots and are parsed in place (see EtherIngest).
+  template <typename Ingest, typename Parse>
+  int ingest(Ingest & ingest, int fd, Parse && parse) {
+    return ingest.receive(_cursor, fd, std::forward<Parse>(parse));
+  }
+
   void setTimer(std::chrono::system_clock::time_point when, std::function<void()> callback) {
     if(!_timers.scheduleAt(when, std:: move(callback))) {
       fatalExit("Failed to schedule timer: queue full");
     }
+    _timersScheduled.add();
   }
 
   template <typename Rep, typename Period>
@@ -102,10 +155,23 @@ public:
     if(!_timers.scheduleAfter(type, wait, std::move(callback))) {
       fatalExit("Failed to schedule timer: queue full");
     }
+    _timersScheduled.add();
+  }
+
+  // This dispatcher's slice of the assembly metrics; updated from the dispatcher thread only.
+  utility::MetricShard & metrics() { return _metrics; }
+
+  // Runs on the dispatcher thread every PROBE_INTERVAL and once on exit; for publishing state
+  // kept elsewhere (table load, limiter rejects) without touching the hot path.
+  void addProbe(std::function<void()> probe) {
+    _probes.push_back(std::move(probe));
   }
 
   LocalClock & clock() const { return _clock; }
 
+  // Per-batch scratch memory; released in bulk at the end of every loop iteration.
+  utility::BumpArena & scratch() { return _scratch; }
+
   void run (int core) {
     if (core >= 0) {
       if (utility::setCpuAffinity(core) != 0) {
@@ -113,6 +179,10 @@ public:
       }
     }
 
+    if constexpr (USING_PERF) {
+      // counters belong to the thread that opens them
+      startPerfCounters();
+    }
 
 
     // 1024 for Epoll/BatchEnd (prioritize latency).
@@ -131,11 +201,18 @@ public:
       int msgRead = 0;
 
       while (!_stop) {
+        if constexpr (USING_PERF) {
+          beginPerfBatch();
+        }
         if constexpr (USING_ETHER) {
           msgRead = poll(batchSize);
           if (msgRead < 0) [[unlikely]] {
             break;
           }
+          if (msgRead > 0) {
+            _etherMessages.add(static_cast<uint64_t>(msgRead));
+            _etherBatchSize.record(static_cast<uint64_t>(msgRead));
+          }
           if (_cursor.queueLength() > (batchSize << 3)) [[unlikely]] {
             batchSize = std::min(maxBatchSize, batchSize << 1);
           } else if (msgRead < batchSize && batchSize > initialBatchSize) [[unlikely]] {
@@ -146,11 +223,16 @@ public:
           _epoller->poll() ;
         }
         if constexpr (USING_TIMER) {
-          _timers.poll();
+          _timersFired.add(_timers.poll());
         }
         if constexpr (USING_BATCH_END) {
           processBatchEnd();
         }
+        if constexpr (USING_EPOLL) {
+          // writes queued by this batch go out together (framed sends, io_uring submissions)
+          _epoller->flush();
+        }
+        _scratch.reset();
 
         if (msgRead == 0) {
           if constexpr (USING_YIELD) {
@@ -169,7 +251,20 @@ public:
         }
 
         processEnd();
+
+        if constexpr (USING_PERF) {
+          endPerfBatch();
+        }
+
+        _batches.add();
+        if ((++_loopNo % PROBE_CHECK_PERIOD) == 0) [[unlikely]] {
+          if (const utility::Timestamp now = _clock.now(); now >= _nextProbe) {
+            _nextProbe = now + PROBE_INTERVAL;
+            runProbes();
+          }
+        }
       }
+      runProbes();
     }
     catch (const std::exception & ex) {
       fatalExit(ex.what());
@@ -187,10 +282,14 @@ public:
     }
   }
 
-  utility::EPoller & epoller() requires (USING_EPOLL) {
+  EPoller & epoller() requires (USING_EPOLL) {
     return *_epoller;
   }
 
+  const PerfStatsType & perfStats() const requires (USING_PERF) {
+    return *_perfStats;
+  }
+
 private:
   template <typename MsgType>
   void dispatchMsg(const MsgType & msg) noexcept {
@@ -198,6 +297,16 @@ private:
       using ComponentType = mp_at_c<ComponentList, idx>;
       ComponentType & component = *std::get<idx>(_components);
       if constexpr (ComponentType::template ToCall<MsgType>::value) {
+        if constexpr (USING_PERF) {
+          if (_perfSampling) [[unlikely]] {
+            utility::PerfSample before, after;
+            _perf->read(before);
+            component.template forwardMsg(msg);
+            _perf->read(after);
+            _perfStats->cells[idx][mp_find<EtherMsgList, MsgType>::value].add(before, after);
+            return;
+          }
+        }
         component.template forwardMsg(msg);
       }
     });
@@ -248,10 +357,105 @@ private:
     mp_for_each<mp_iota_c<COMPONENT_CNT>> ( [this] (auto idx) {
       using ComponentType = mp_at_c<ComponentList, idx>;
       ComponentType & component = *std::get<idx>(_components);
+      if constexpr (USING_PERF) {
+        if (_perfSampling) [[unlikely]] {
+          utility::PerfSample before, after;
+          _perf->read(before);
+          component.processBatchEnd();
+          _perf->read(after);
+          _perfStats->cells[idx][PerfStatsType::BATCH_END].add(before, after);
+          return;
+        }
+      }
       component.processBatchEnd();
     });
   }
 
+  void initMetrics () {
+    _batches = _metrics.counter("dispatcher.batches");
+    if constexpr (USING_ETHER) {
+      _etherMessages = _metrics.counter("ether.messages");
+      _etherBatchSize = _metrics.histogram("ether.batch_size");
+      _etherLag = _metrics.gauge("ether.lag");
+    }
+    if constexpr (USING_TIMER) {
+      _timersFired = _metrics.counter("timer.fired");
+      _timersScheduled = _metrics.counter("timer.scheduled");
+    }
+    if constexpr (USING_PERF) {
+      for (size_t i = 0; i < utility::PERF_EVENT_CNT; ++i) {
+        _perfTotals[i] = _metrics.counter(std::string("perf.") + std::string(utility::PERF_EVENT_NAMES[i]));
+      }
+    }
+  }
+
+  void runProbes () {
+    if constexpr (USING_ETHER) {
+      _etherLag.set(static_cast<int64_t>(_cursor.queueLength()));
+    }
+    if constexpr (USING_PERF) {
+      for (size_t i = 0; i < utility::PERF_EVENT_CNT; ++i) {
+        _perfTotals[i].set(_perfStats->total.counts[i]);
+      }
+    }
+    for (auto & probe : _probes) {
+      probe();
+    }
+  }
+
+  // Stats go to the file named by "perf_stats": { "<dispatcher name>": path } when configured.
+  void initPerfStats () {
+    const std::string path = _context.template getConfig<std::string>("perf_stats", _name, "");
+    if (path.empty()) {
+      _perfStatsOwned = std::make_unique<PerfStatsType>();
+      _perfStats = _perfStatsOwned.get();
+    }
+    else {
+      _perfFile = std::make_unique<utility::WritableMmap>(path, sizeof(PerfStatsType), true);
+      _perfStats = new (_perfFile->data()) PerfStatsType();
+    }
+    PerfStatsType::setName(_perfStats->dispatcher, _name);
+    for (size_t i = 0; i < utility::PERF_EVENT_CNT; ++i) {
+      PerfStatsType::setName(_perfStats->events[i], utility::PERF_EVENT_NAMES[i]);
+    }
+    mp_for_each<mp_iota_c<COMPONENT_CNT>>( [this] (auto idx) {
+      PerfStatsType::setName(_perfStats->components[idx], type::TypeName<mp_at_c<ComponentList, idx>>());
+    });
+    mp_for_each<mp_iota_c<mp_size<EtherMsgList>::value>>( [this] (auto idx) {
+      PerfStatsType::setName(_perfStats->messages[idx], type::TypeName<mp_at_c<EtherMsgList, idx>>());
+    });
+  }
+
+  // Without counters (no PMU, perf_event_paranoid) the dispatcher runs unmeasured.
+  void startPerfCounters () {
+    _perf = std::make_unique<utility::PerfCounterGroup>();
+    if (!_perf->error().empty()) {
+      std::cerr << frmt::format("Dispatcher '{}' perf counters: {}", _name, _perf->error()) << std::endl;
+    }
+    for (size_t i = 0; i < utility::PERF_EVENT_CNT; ++i) {
+      if (_perf->available(static_cast<utility::PerfEvent>(i))) {
+        _perfStats->available |= 1u << i;
+      }
+    }
+    _perfEnabled = _perf->available();
+    if (_perfEnabled) {
+      _perf->read(_perfSample);
+    }
+  }
+
+  void beginPerfBatch () noexcept {
+    _perfSampling = _perfEnabled && (++_perfBatchNo % PerfStatsType::SAMPLE_PERIOD) == 0;
+  }
+
+  // _perfSample holds the previous batch boundary, so a batch costs a single read.
+  void endPerfBatch () noexcept {
+    if (_perfEnabled) [[likely]] {
+      const utility::PerfSample start = _perfSample;
+      _perf->read(_perfSample);
+      _perfStats->total.add(start, _perfSample);
+    }
+  }
+
   void fatalExit(const std:: string & errmsg) {
     std::cerr << frmt::format ("Dispatcher '{}'  fatal error '{}'",  _name, errmsg) << std::endl;
     exit (1);
@@ -267,8 +471,28 @@ private:
   std::thread	              _thread;
   const int	                _core;
   std::string	              _name;
+  utility::MetricShard &    _metrics;
   TimerQueue<1<<10>         _timers;
   std::unique_ptr<EPoller>  _epoller;
+  utility::BumpArena        _scratch {SCRATCH_CHUNK_SIZE};
+  std::unique_ptr<utility::PerfCounterGroup>  _perf;
+  std::unique_ptr<utility::WritableMmap>      _perfFile;
+  std::unique_ptr<PerfStatsType>              _perfStatsOwned;
+  PerfStatsType *           _perfStats = nullptr;
+  utility::PerfSample       _perfSample {};
+  uint64_t                  _perfBatchNo = 0;
+  bool                      _perfEnabled = false;
+  bool                      _perfSampling = false;
+  utility::Counter          _batches;
+  utility::Counter          _etherMessages;
+  utility::Histogram        _etherBatchSize;
+  utility::Gauge            _etherLag;
+  utility::Counter          _timersFired;
+  utility::Counter          _timersScheduled;
+  std::array<utility::Counter, utility::PERF_EVENT_CNT> _perfTotals;
+  std::vector<std::function<void()>>  _probes;
+  uint64_t                  _loopNo = 0;
+  utility::Timestamp        _nextProbe = 0;
 };
 
 }
@@ -1,10 +1,13 @@
 #pragma once
 
 #include <atomic>
+#include <cassert>
 #include <chrono>
 #include <stdexcept>
 #include <functional>
 #include <cstring>
+#include <string>
+#include <type_traits>
 
 #include <hw/type/NamedType.hpp>
 #include <hw/type/TypeList.hpp>
@@ -50,11 +53,12 @@ public:
 
   static constexpr bool SHARED_ETHER = std::is_base_of_v<SharedEther, Traits>;
   static constexpr SeqNo CAPACITY = static_cast<SeqNo> (MaxMsgCnt);
+  static constexpr size_t SLOT_SIZE = MsgList::SIZE;
   static constexpr size_t MAX_MSG_SIZE = (sizeof(EtherMsg) + ALIGNAS) & ~ALIGNAS;
   static constexpr size_t REQUIRED_MEM_SIZE = MaxMsgCnt * MAX_MSG_SIZE + sizeof(EtherHdr);
   static constexpr size_t MSG_LIST_SIGNATURE = type::TypeListSignature<MsgList>();
 
-  Ether() : _name(Name) {}
+  Ether() : _name(Name.toString()) {}
   Ether (const Ether &) = delete;
   Ether& operator = (const Ether &) = delete;
 
@@ -68,8 +72,9 @@ public:
       _hdr->seqno = 0;
       _hdr->signature = MSG_LIST_SIGNATURE;
       _hdr->capacity = CAPACITY;
+      _peerMsgCnt = mp_size<MsgList>::value;
     }
-    else if (_hdr->signature != MSG_LIST_SIGNATURE) {
+    else if ((_peerMsgCnt = peerMsgCnt(_hdr->signature)) == 0) {
       throw (std::invalid_argument(std::string("Ether signature mismatch :" + _name)));
     }
     else if (_hdr->capacity != CAPACITY) {
@@ -77,15 +82,27 @@ public:
     }
   }
 
+  // Message types known to every binary attached to the ether: all of MsgList, or the prefix of
+  // it an older binary created the ether with. Only those may be published while it is attached.
+  size_t peerMsgCnt() const noexcept { return _peerMsgCnt; }
+
   class Cursor {
   public:
     Cursor(Ether & ether) : _ether(ether), _hdr (*ether._hdr), _data(ether._data) {
       reset(_hdr.seqno.load(std::memory_order_acquire));
     }
 
+    // False for message types past peerMsgCnt(): the peer binary could not read them.
+    template<typename MsgType>
+    bool canPublish () const noexcept {
+      static_assert(mp_contains<MsgList, MsgType>::value);
+      return mp_find<MsgList, MsgType>::value < _ether._peerMsgCnt;
+    }
+
     template<typename MsgType, typename ... Args>
     MsgType & allocMsg (Args &&... args) noexcept {
       static_assert(mp_contains<MsgList, MsgType>::value);
+      assert(canPublish<MsgType>());
       SeqNo seqno = _hdr.seqno.load(std::memory_order_relaxed);
       while (!_hdr.seqno.compare_exchange_weak(
         seqno, seqno + 1, std::memory_order_release, std::memory_order_relaxed));
@@ -106,22 +123,80 @@ public:
       return true;
     }
 
+    // Drops an allocated message; readers skip its slot.
+    template<typename MsgType>
+    void abortMsg (MsgType & msg) noexcept {
+      static_assert(mp_contains<MsgList, MsgType>::value);
+      Ether::EtherMsg &emsg = *reinterpret_cast<EtherMsg *>(reinterpret_cast<uint8_t *>(&msg) - EtherMsg::DATA_OFFSET);
+      abortSlots(emsg.seqno.load(std::memory_order_relaxed));
+    }
+
+    // In-place ingestion: claims `count` consecutive raw slots of SLOT_SIZE bytes and returns the
+    // first seqno. Nothing is constructed; readers stop at each slot until it is committed with
+    // commitSlot() or given back with abortSlots().
+    SeqNo claimSlots (size_t count = 1) noexcept {
+      SeqNo seqno = _hdr.seqno.load(std::memory_order_relaxed);
+      while (!_hdr.seqno.compare_exchange_weak(
+        seqno, seqno + static_cast<SeqNo>(count), std::memory_order_release, std::memory_order_relaxed));
+      for (SeqNo next = seqno + 1; next <= seqno + static_cast<SeqNo>(count); ++next) {
+        Ether::EtherMsg & msg = _data[next & MSG_INDEX_MASK];
+        msg.commitno = 0;
+        msg.seqno.store(next, std::memory_order_release);
+      }
+      return seqno + 1;
+    }
+
+    uint8_t * slotData (SeqNo seqno) const noexcept {
+      return _data[seqno & MSG_INDEX_MASK].data;
+    }
+
+    // Publishes a claimed slot whose bytes now hold a MsgType (received and parsed in place).
+    // Returns false, leaving the slot claimed, for a type the peer binary cannot read.
+    template<typename MsgType>
+    bool commitSlot (SeqNo seqno) noexcept {
+      static_assert(mp_contains<MsgList, MsgType>::value);
+      static_assert(std::is_trivially_copyable_v<MsgType>, "in-place messages are overlaid on raw bytes");
+      if (!canPublish<MsgType>()) [[unlikely]] {
+        return false;
+      }
+      Ether::EtherMsg & msg = _data[seqno & MSG_INDEX_MASK];
+      msg.selector = static_cast<MsgType *> (nullptr);
+      msg.commitno = seqno;
+      return true;
+    }
+
+    // Gives back claimed slots [seqno, seqno + count). When no one has claimed past them the
+    // ether head is rolled back and the seqnos are reused; otherwise they are marked aborted
+    // (commitno == -seqno) and readers step over them.
+    void abortSlots (SeqNo seqno, size_t count = 1) noexcept {
+      SeqNo last = seqno + static_cast<SeqNo>(count) - 1;
+      if (_hdr.seqno.compare_exchange_strong(last, seqno - 1, std::memory_order_release, std::memory_order_relaxed)) {
+        return;
+      }
+      for (SeqNo next = seqno; next < seqno + static_cast<SeqNo>(count); ++next) {
+        _data[next & MSG_INDEX_MASK].commitno = -next;
+      }
+    }
+
     int readMsg (std::function<void(EtherMsg &)> handler) noexcept {
       _lastSeqno = _hdr.seqno.load(std::memory_order_relaxed);
-      if (_lastSeqno >= _nextSeqno) [[likely]] {
-        if ((_lastSeqno - _nextSeqno) < CAPACITY) [[likely]] {
-          Ether::EtherMsg &msg = _data[_nextSeqno & MSG_INDEX_MASK];
-          if (_nextSeqno == msg.seqno.load(std:: memory_order_relaxed)) [[likely]] {
-            if (_nextSeqno == msg.commitno) [[likely]] {
-              handler (msg);
-              ++ _nextSeqno;
-              return 1;
-            }
-          }
-        }
-        else {
+      while (_lastSeqno >= _nextSeqno) [[likely]] {
+        if ((_lastSeqno - _nextSeqno) >= CAPACITY) [[unlikely]] {
           return -1;
         }
+        Ether::EtherMsg &msg = _data[_nextSeqno & MSG_INDEX_MASK];
+        if (_nextSeqno != msg.seqno.load(std:: memory_order_relaxed)) [[unlikely]] {
+          break;
+        }
+        if (_nextSeqno == msg.commitno) [[likely]] {
+          handler (msg);
+          ++ _nextSeqno;
+          return 1;
+        }
+        if (-_nextSeqno != msg.commitno) {
+          break;
+        }
+        ++ _nextSeqno; // aborted slot
       }
       return 0;
     }
@@ -148,7 +223,21 @@ public:
   };
 
 private:
+  // An ether created for a prefix of MsgList with the same slot size has the same layout and
+  // message selectors; its header carries the signature of that prefix.
+  static size_t peerMsgCnt(uint64_t signature) noexcept {
+    size_t count = 0;
+    mp_for_each<mp_iota_c<mp_size<MsgList>::value>>([&] (auto I) {
+      using Prefix = mp_take_c<MsgList, I + 1>;
+      if (type::TypeListSignature<Prefix>() == signature && Prefix::SIZE == MsgList::SIZE) {
+        count = I + 1;
+      }
+    });
+    return count;
+  }
+
   friend class Cursor;
+  size_t _peerMsgCnt = mp_size<MsgList>::value;
   EtherHdr * _hdr = nullptr;
   EtherMsg * _data = nullptr;
   const std::string _name;
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <errno.h>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include <hw/utility/Clock.hpp>
+#include <hw/utility/Datagram.hpp>
+#include <hw/assembly/Ether.hpp>
+
+namespace hw::assembly {
+
+/**
+ * EtherIngest: receives datagrams straight into ether slots, no intermediate buffer.
+ * - Each receive claims BATCH slots, points one recvmmsg iovec at each slot (Ether::SLOT_SIZE
+ *   bytes, the largest message in the list) and hands every datagram to parse(Slot &) in place.
+ * - parse decodes or validates the bytes and publishes them with slot.commit<MsgType>(); slots
+ *   it leaves uncommitted (bad, filtered or truncated packets, or types a peer binary attached
+ *   to the ether cannot read) are aborted.
+ * - Slots past the last datagram are rolled back, so an empty or short read costs no ether
+ *   sequence numbers unless another producer claimed in between.
+ * - Call it on readiness (DATA_READY of a raw UDP socket), not speculatively: readers wait on
+ *   the claimed slots until receive() returns.
+ */
+template <typename Ether, size_t BATCH = 16>
+class EtherIngest {
+public:
+  using Cursor = typename Ether::Cursor;
+  using SeqNo  = typename Ether::SeqNo;
+  static constexpr size_t SLOT_SIZE = Ether::SLOT_SIZE;
+
+  class Slot {
+  public:
+    uint8_t * data() const noexcept { return _data; }
+    size_t size() const noexcept { return _len; }
+    bool truncated() const noexcept { return _truncated; } // datagram larger than SLOT_SIZE
+    utility::Timestamp rxTime() const noexcept { return _rxTime; }
+    const sockaddr_in & source() const noexcept { return _source; }
+
+    // The slot bytes viewed as a wire-format message.
+    template <typename MsgType>
+    MsgType & as() const noexcept {
+      static_assert(std::is_trivially_copyable_v<MsgType> && sizeof(MsgType) <= SLOT_SIZE);
+      return *reinterpret_cast<MsgType *>(_data);
+    }
+
+    // False when the ether refuses MsgType (see Ether::Cursor::canPublish); the slot is dropped.
+    template <typename MsgType>
+    bool commit() noexcept {
+      return _committed = _cursor.template commitSlot<MsgType>(_seqno);
+    }
+
+  private:
+    friend class EtherIngest;
+    Slot(Cursor & cursor, SeqNo seqno, uint8_t * data, size_t len, bool truncated,
+         utility::Timestamp rxTime, const sockaddr_in & source) noexcept
+      : _cursor(cursor), _seqno(seqno), _data(data), _len(len), _truncated(truncated),
+        _rxTime(rxTime), _source(source) {}
+
+    Cursor & _cursor;
+    SeqNo _seqno;
+    uint8_t * _data;
+    size_t _len;
+    bool _truncated;
+    bool _committed = false;
+    utility::Timestamp _rxTime;
+    const sockaddr_in & _source;
+  };
+
+  EtherIngest() noexcept {
+    for (size_t i = 0; i < BATCH; ++i) {
+      _iov[i].iov_len = SLOT_SIZE;
+      msghdr & hdr = _msgs[i].msg_hdr;
+      hdr.msg_iov = &_iov[i];
+      hdr.msg_iovlen = 1;
+      hdr.msg_name = &_addrs[i];
+      hdr.msg_control = _controls[i].data;
+    }
+  }
+
+  EtherIngest(const EtherIngest &) = delete;
+  EtherIngest & operator = (const EtherIngest &) = delete;
+
+  // One recvmmsg into fresh slots; returns the number of messages published or -errno.
+  template <typename Parse>
+  int receive(Cursor & cursor, int fd, Parse && parse) {
+    const SeqNo first = cursor.claimSlots(BATCH);
+    for (size_t i = 0; i < BATCH; ++i) {
+      _iov[i].iov_base = cursor.slotData(first + static_cast<SeqNo>(i));
+      msghdr & hdr = _msgs[i].msg_hdr;
+      hdr.msg_namelen = sizeof(sockaddr_in);
+      hdr.msg_controllen = sizeof(utility::DatagramControl::data);
+      hdr.msg_flags = 0;
+    }
+    const int n = ::recvmmsg(fd, _msgs.data(), BATCH, MSG_DONTWAIT, nullptr);
+    if (n <= 0) {
+      const int err = n == 0 || errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -errno;
+      cursor.abortSlots(first, BATCH);
+      return err;
+    }
+
+    int published = 0;
+    size_t tail = 0; // slots from here on are uncommitted
+    for (size_t i = 0; i < static_cast<size_t>(n); ++i) {
+      const msghdr & hdr = _msgs[i].msg_hdr;
+      const SeqNo seqno = first + static_cast<SeqNo>(i);
+      Slot slot(cursor, seqno, static_cast<uint8_t *>(_iov[i].iov_base),
+                std::min<size_t>(_msgs[i].msg_len, SLOT_SIZE), (hdr.msg_flags & MSG_TRUNC) != 0,
+                utility::receiveTime(hdr), _addrs[i]);
+      parse(slot);
+      if (slot._committed) {
+        for (size_t j = tail; j < i; ++j) {
+          cursor.abortSlots(first + static_cast<SeqNo>(j)); // rejected in the middle of a batch
+        }
+        tail = i + 1;
+        ++published;
+      }
+    }
+    if (tail < BATCH) {
+      cursor.abortSlots(first + static_cast<SeqNo>(tail), BATCH - tail);
+    }
+    return published;
+  }
+
+private:
+  std::array<mmsghdr, BATCH> _msgs {};
+  std::array<iovec, BATCH> _iov {};
+  std::array<sockaddr_in, BATCH> _addrs {};
+  std::array<utility::DatagramControl, BATCH> _controls {};
+};
+
+}
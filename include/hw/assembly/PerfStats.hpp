@@ -0,0 +1,63 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include <hw/utility/PerfCounters.hpp>
+
+namespace hw::assembly {
+
+/**
+ * PerfStats: hardware counters of one dispatcher (DispatcherWithPerfCounters), per component
+ * and message type.
+ * - total: every loop iteration of the dispatcher, read at batch boundaries; calls is the batch count.
+ * - cells[c][m]: component c handling message type m, read around the handler; the last column
+ *   (BATCH_END) is its processBatchEnd. Handlers are measured on one batch in SAMPLE_PERIOD,
+ *   so cells are a sample of the traffic while total is complete.
+ * - No pointers and self-describing (names, counts), so it can sit in a stats file that other
+ *   processes map while the dispatcher runs. Single writer, no locking: a reader may see a
+ *   cell mid-update.
+ */
+template <size_t ComponentCnt, size_t MsgCnt>
+struct PerfStats {
+  static constexpr uint64_t MAGIC = 0x3130465245505748; // "HWPERF01"
+  static constexpr size_t NAME_SIZE = 48;
+  static constexpr size_t BATCH_END = MsgCnt;
+  static constexpr uint64_t SAMPLE_PERIOD = 64;
+
+  using Name = std::array<char, NAME_SIZE>;
+
+  struct Cell {
+    uint64_t              calls;
+    utility::PerfSample   counts;
+
+    void add(const utility::PerfSample & from, const utility::PerfSample & to) noexcept {
+      ++calls;
+      for (size_t i = 0; i < utility::PERF_EVENT_CNT; ++i) {
+        counts[i] += to[i] - from[i];
+      }
+    }
+  };
+
+  static void setName(Name & name, std::string_view value) noexcept {
+    name.fill('\0');
+    std::copy_n(value.data(), std::min(value.size(), NAME_SIZE - 1), name.data());
+  }
+
+  uint64_t  magic = MAGIC;
+  uint32_t  componentCnt = ComponentCnt;
+  uint32_t  msgCnt = MsgCnt;
+  uint32_t  eventCnt = utility::PERF_EVENT_CNT;
+  uint32_t  available = 0;    // bit per PerfEvent that is counting
+  Name      dispatcher {};
+  std::array<Name, utility::PERF_EVENT_CNT> events {};
+  std::array<Name, ComponentCnt>            components {};
+  std::array<Name, MsgCnt>                  messages {};
+  Cell      total {};
+  std::array<std::array<Cell, MsgCnt + 1>, ComponentCnt> cells {};
+};
+
+}
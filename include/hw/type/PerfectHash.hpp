@@ -0,0 +1,147 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+#include <hw/type/NameTag.hpp>
+
+namespace hw::type {
+
+/**
+ * PerfectHash: collision-free string -> index table over N keys, built at compile time.
+ * - One FNV-1a pass over the key picks a bucket; the bucket's displacement seed then places
+ *   the key in a table of 2 * bit_ceil(N) slots ("hash and displace"). Seeds are searched
+ *   largest bucket first while the table is still empty, which keeps the search short.
+ * - find() hashes once, reads two small arrays and compares one string: no loops over keys,
+ *   no allocation. Unknown keys give NOT_FOUND.
+ * - Keys are string_views, so they must outlive the table (string literals, NameTags).
+ * - A key given more than once resolves to its first index.
+ */
+template <size_t N>
+class PerfectHash {
+public:
+  static constexpr size_t NOT_FOUND = N;
+
+  constexpr explicit PerfectHash(const std::array<std::string_view, N>& keys) : _keys(keys) {
+    _slots.fill(static_cast<uint32_t>(N));
+    std::array<uint64_t, N> hashes {};
+    std::array<size_t, N> order {}; // keys to place: the first occurrence of each
+    size_t count = 0;
+    for (size_t i = 0; i < N; ++i) {
+      hashes[i] = hash(keys[i]);
+      bool duplicate = false;
+      for (size_t j = 0; j < i && !duplicate; ++j) {
+        if (hashes[j] == hashes[i]) {
+          if (keys[j] != keys[i]) {
+            throw std::logic_error("PerfectHash: hash collision");
+          }
+          duplicate = true;
+        }
+      }
+      if (!duplicate) {
+        order[count++] = i;
+      }
+    }
+
+    std::array<size_t, BUCKETS> load {};
+    for (size_t i = 0; i < count; ++i) {
+      ++load[bucket(hashes[order[i]])];
+    }
+    // Keys grouped by bucket, fullest bucket first
+    std::sort(order.begin(), order.begin() + count, [&] (size_t a, size_t b) {
+      const size_t ba = bucket(hashes[a]), bb = bucket(hashes[b]);
+      return load[ba] != load[bb] ? load[ba] > load[bb] : ba < bb;
+    });
+
+    for (size_t begin = 0; begin < count; ) {
+      const size_t b = bucket(hashes[order[begin]]);
+      const size_t end = begin + load[b];
+      uint32_t seed = 1;
+      for (;; ++seed) {
+        if (seed == MAX_SEED) {
+          throw std::logic_error("PerfectHash: no displacement found");
+        }
+        bool fits = true;
+        for (size_t i = begin; i < end && fits; ++i) {
+          const size_t slot = place(hashes[order[i]], seed);
+          fits = _slots[slot] == N;
+          for (size_t j = begin; j < i && fits; ++j) {
+            fits = place(hashes[order[j]], seed) != slot;
+          }
+        }
+        if (fits) break;
+      }
+      _seeds[b] = seed;
+      for (size_t i = begin; i < end; ++i) {
+        _slots[place(hashes[order[i]], seed)] = static_cast<uint32_t>(order[i]);
+      }
+      begin = end;
+    }
+  }
+
+  // Index of key in the array the table was built from, NOT_FOUND otherwise.
+  constexpr size_t find(std::string_view key) const noexcept {
+    const uint64_t h = hash(key);
+    const size_t index = _slots[place(h, _seeds[bucket(h)])];
+    return index < N && _keys[index] == key ? index : NOT_FOUND;
+  }
+
+  constexpr bool contains(std::string_view key) const noexcept {
+    return find(key) != NOT_FOUND;
+  }
+
+  constexpr std::string_view key(size_t index) const noexcept { return _keys[index]; }
+
+  static constexpr size_t size() noexcept { return N; }
+
+  static constexpr uint64_t hash(std::string_view key) noexcept {
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (char c : key) {
+      h = (h ^ static_cast<uint8_t>(c)) * 0x100000001b3ull;
+    }
+    return h;
+  }
+
+private:
+  static constexpr size_t BUCKETS = std::bit_ceil(std::max<size_t>(N, 1));
+  static constexpr size_t TABLE = 2 * BUCKETS;
+  static constexpr uint32_t MAX_SEED = 1u << 20;
+
+  static constexpr uint64_t mix(uint64_t h) noexcept {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    return h;
+  }
+
+  static constexpr size_t bucket(uint64_t h) noexcept {
+    return static_cast<size_t>(mix(h)) & (BUCKETS - 1);
+  }
+
+  static constexpr size_t place(uint64_t h, uint32_t seed) noexcept {
+    return static_cast<size_t>(mix(h ^ (seed * 0x9e3779b97f4a7c15ull)) >> 32) & (TABLE - 1);
+  }
+
+  std::array<std::string_view, N> _keys;
+  std::array<uint32_t, BUCKETS> _seeds {};
+  std::array<uint32_t, TABLE> _slots {};
+};
+
+template <size_t N>
+PerfectHash(const std::array<std::string_view, N>&) -> PerfectHash<N>;
+
+static_assert(PerfectHash<3>({"ping", "pong", "pang"}).find("pong") == 1);
+static_assert(PerfectHash<3>({"ping", "pong", "pang"}).find("pung") == 3);
+static_assert(PerfectHash<3>({"ping", "pong", "ping"}).find("ping") == 0);
+static_assert(PerfectHash<0>({}).find("ping") == 0);
+
+// Table over a set of NameTags, in the given order.
+template <NameTag... Tags>
+inline constexpr PerfectHash<sizeof...(Tags)> NAME_TAG_HASH {std::array<std::string_view, sizeof...(Tags)>{Tags.toString()...}};
+
+}
@@ -7,6 +7,8 @@
 #include <tuple>
 #include <array>
 #include <memory>
+#include <string_view>
+#include <utility>
 #include <sstream>
 #include <boost/mp11/list.hpp>
 #include <boost/mp11/set.hpp>
@@ -14,6 +16,7 @@
 #include <boost/mp11/algorithm.hpp>
 #include <boost/mp11/function.hpp>
 #include <hw/type/TypeInfo.hpp>
+#include <hw/type/PerfectHash.hpp>
 
 namespace hw::type {
 
@@ -77,20 +80,20 @@ constexpr size_t MaxTypeNameSize() {
   return 0;
 }
 
+template <typename TypeList, size_t... I>
+constexpr std::array<std::string_view, sizeof...(I)> TypeNames(std::index_sequence<I...>) {
+  return {TypeName<mp_at_c<TypeList, I>>()...};
+}
+
+// Type name -> index in the list, FindTypeByName's lookup table.
 template <typename TypeList>
-constexpr size_t FindTypeByName(std::string_view name) {
-  constexpr size_t N = mp_size<TypeList>::value;
-  size_t result = N;
-  mp_for_each<mp_iota_c<N>>([&](auto I) {
-    if (result == N) {
-      using T = mp_at_c<TypeList, I>;
-      if (TypeName<T>() == name) {
-        result = I;
-      }
-    }
-  });
+inline constexpr PerfectHash<mp_size<TypeList>::value> TYPE_NAME_HASH {
+  TypeNames<TypeList>(std::make_index_sequence<mp_size<TypeList>::value>{})
+};
 
-  return result;
+template <typename TypeList>
+constexpr size_t FindTypeByName(std::string_view name) {
+  return TYPE_NAME_HASH<TypeList>.find(name);
 }
 
 static_assert(0 == FindTypeByName<type_list<int, double, char>>("int"));
@@ -0,0 +1,264 @@
+// --- START FILE: include/hw/type/beacon/Columnar.hpp ---
+#pragma once
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+#include <hw/type/NameTag.hpp>
+#include <hw/type/beacon/TypeTraits.hpp>
+#include <hw/type/beacon/Message.hpp>
+
+namespace hw::type::beacon {
+
+namespace detail {
+  template <typename MessageType, NameTag Name>
+  concept ColumnField =
+    std::is_same_v<QueryTrait<typename MessageType::template Field<Name>>, trait::Numeric> &&
+    MessageType::template IS_FIXED<Name>;
+
+  template <NameTag... Names>
+  constexpr bool uniqueNames() {
+    const std::string_view names[] = {Names.toString()...};
+    for (size_t i = 0; i < sizeof...(Names); ++i) {
+      for (size_t j = 0; j < i; ++j) {
+        if (names[i] == names[j]) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  /**
+   * AVX2 is used whenever the CPU has it: the gathers below are compiled with the avx2 target
+   * attribute and selected at run time, so builds without -mavx2 still take (and test) them.
+   */
+  inline bool hasAvx2() noexcept {
+#if defined(__AVX2__)
+    return true;
+#elif defined(__x86_64__)
+    static const bool supported = [] {
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return supported;
+#else
+    return false;
+#endif
+  }
+
+#if defined(__x86_64__)
+  // both return the number of values gathered; the caller copies the remainder
+  template <size_t SIZE>
+  __attribute__((target("avx2")))
+  size_t gatherStridedAvx2(const std::byte* base, size_t stride, size_t count, std::byte* dst) {
+    size_t i = 0;
+    if constexpr (SIZE == 8) {
+      const __m128i index = _mm_mullo_epi32(_mm_setr_epi32(0, 1, 2, 3), _mm_set1_epi32(static_cast<int>(stride)));
+      for (; i + 4 <= count; i += 4) {
+        const __m256i v = _mm256_i32gather_epi64(reinterpret_cast<const long long*>(base + i * stride), index, 1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * SIZE), v);
+      }
+    }
+    else if constexpr (SIZE == 4) {
+      const __m256i index = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(static_cast<int>(stride)));
+      for (; i + 8 <= count; i += 8) {
+        const __m256i v = _mm256_i32gather_epi32(reinterpret_cast<const int*>(base + i * stride), index, 1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * SIZE), v);
+      }
+    }
+    return i;
+  }
+
+  template <size_t SIZE>
+  __attribute__((target("avx2")))
+  size_t gatherIndirectAvx2(const std::byte* const* msgs, size_t offset, size_t count, std::byte* dst) {
+    static_assert(sizeof(const std::byte*) == sizeof(long long));
+    size_t i = 0;
+    if constexpr (SIZE == 8 || SIZE == 4) {
+      const __m256i delta = _mm256_set1_epi64x(static_cast<long long>(offset));
+      for (; i + 4 <= count; i += 4) {
+        const __m256i addr = _mm256_add_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(msgs + i)), delta);
+        if constexpr (SIZE == 8) {
+          _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * SIZE), _mm256_i64gather_epi64(static_cast<const long long*>(nullptr), addr, 1));
+        } else {
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * SIZE), _mm256_i64gather_epi32(static_cast<const int*>(nullptr), addr, 1));
+        }
+      }
+    }
+    return i;
+  }
+#endif
+
+  /**
+   * Gathers SIZE-byte values found at base + i * stride (or msgs[i] + offset) into out[i].
+   * 4- and 8-byte values use AVX2 gathers when `simd` is set; the rest, and the remainder of a
+   * batch, go through memcpy like NamedNumericType::get.
+   */
+  template <size_t SIZE>
+  void gatherStrided(const std::byte* base, size_t stride, size_t count, void* out, bool simd = hasAvx2()) {
+    std::byte* dst = static_cast<std::byte*>(out);
+    size_t i = 0;
+#if defined(__x86_64__)
+    if (simd) {
+      i = gatherStridedAvx2<SIZE>(base, stride, count, dst);
+    }
+#endif
+    for (; i < count; ++i) {
+      std::memcpy(dst + i * SIZE, base + i * stride, SIZE);
+    }
+  }
+
+  template <size_t SIZE>
+  void gatherIndirect(const std::byte* const* msgs, size_t offset, size_t count, void* out, bool simd = hasAvx2()) {
+    std::byte* dst = static_cast<std::byte*>(out);
+    size_t i = 0;
+#if defined(__x86_64__)
+    if (simd) {
+      i = gatherIndirectAvx2<SIZE>(msgs, offset, count, dst);
+    }
+#endif
+    for (; i < count; ++i) {
+      std::memcpy(dst + i * SIZE, msgs[i] + offset, SIZE);
+    }
+  }
+}
+
+/**
+ * decodeColumn: one fixed Numeric field of a run of same-typed messages into a column array.
+ * - Strided: messages every `stride` bytes from `first` (fixed-layout messages, or records of
+ *   a replay file padded to a common size).
+ * - Indirect: an array of message pointers, for runs whose messages differ in length.
+ */
+template <typename MessageType, NameTag Name>
+requires detail::ColumnField<MessageType, Name>
+void decodeColumn(const std::byte* first, size_t stride, size_t count,
+                  typename MessageType::template Field<Name>::value_type* column) {
+  using FieldType = typename MessageType::template Field<Name>;
+  static_assert(sizeof(typename FieldType::value_type) == FieldType::SIZE);
+  if (stride > static_cast<size_t>(std::numeric_limits<int>::max() / 8)) [[unlikely]] {
+    throw std::invalid_argument("decodeColumn: stride too large");
+  }
+  detail::gatherStrided<FieldType::SIZE>(first + MessageType::template OFFSET<Name>, stride, count, column);
+}
+
+template <typename MessageType, NameTag Name>
+requires detail::ColumnField<MessageType, Name>
+void decodeColumn(const std::byte* const* msgs, size_t count,
+                  typename MessageType::template Field<Name>::value_type* column) {
+  using FieldType = typename MessageType::template Field<Name>;
+  detail::gatherIndirect<FieldType::SIZE>(msgs, MessageType::template OFFSET<Name>, count, column);
+}
+
+/**
+ * ColumnBatch: struct-of-arrays view of selected fixed Numeric fields of a message type.
+ * - decode() appends a run of messages; it works through the run in blocks of BLOCK messages
+ *   so that every column pass over a block reads cache lines the previous pass brought in.
+ * - Column storage is not value-initialized (the gathers overwrite it) and keeps its capacity
+ *   across clear(), so a reused batch neither allocates nor touches memory twice.
+ */
+template <typename MessageType, NameTag... Names>
+class ColumnBatch {
+  static_assert(sizeof...(Names) > 0, "one or more columns are expected");
+  static_assert((detail::ColumnField<MessageType, Names> && ...), "columns are fixed Numeric fields");
+  static_assert(detail::uniqueNames<Names...>(), "column names must be unique");
+
+  template <NameTag Name>
+  using ValueType = typename MessageType::template Field<Name>::value_type;
+
+  template <typename Type>
+  struct Column {
+    std::unique_ptr<Type[]> data;
+    size_t capacity = 0;
+
+    void reserve(size_t count, size_t used) {
+      if (count > capacity) {
+        auto grown = std::make_unique_for_overwrite<Type[]>(count);
+        if (used) {
+          std::memcpy(grown.get(), data.get(), used * sizeof(Type));
+        }
+        data = std::move(grown);
+        capacity = count;
+      }
+    }
+  };
+
+public:
+  static constexpr size_t BLOCK = 256;
+
+  void reserve(size_t count) {
+    if (count > _capacity) {
+      _capacity = count;
+      std::apply([this] (auto &... column) { (column.reserve(_capacity, _size), ...); }, _columns);
+    }
+  }
+
+  void clear() noexcept {
+    _size = 0;
+  }
+
+  size_t size() const noexcept { return _size; }
+
+  template <NameTag Name>
+  std::span<const ValueType<Name>> column() const noexcept {
+    return {std::get<indexOf<Name>()>(_columns).data.get(), _size};
+  }
+
+  void decode(const std::byte* first, size_t stride, size_t count) {
+    grow(count);
+    for (size_t done = 0; done < count; done += BLOCK) {
+      const size_t block = std::min(BLOCK, count - done);
+      const std::byte* msgs = first + done * stride;
+      const size_t at = _size + done;
+      (decodeColumn<MessageType, Names>(msgs, stride, block, std::get<indexOf<Names>()>(_columns).data.get() + at), ...);
+    }
+    _size += count;
+  }
+
+  void decode(const std::byte* const* msgs, size_t count) {
+    grow(count);
+    for (size_t done = 0; done < count; done += BLOCK) {
+      const size_t block = std::min(BLOCK, count - done);
+      const size_t at = _size + done;
+      (decodeColumn<MessageType, Names>(msgs + done, block, std::get<indexOf<Names>()>(_columns).data.get() + at), ...);
+    }
+    _size += count;
+  }
+
+private:
+  template <NameTag Name>
+  static constexpr size_t indexOf() {
+    size_t index = 0;
+    size_t result = sizeof...(Names);
+    ((Names.toString() == Name.toString() && result == sizeof...(Names) ? (result = index++) : index++), ...);
+    return result;
+  }
+
+  void grow(size_t count) {
+    const size_t need = _size + count;
+    if (need > _capacity) {
+      _capacity = std::max(need, _capacity * 2);
+      std::apply([this] (auto &... column) { (column.reserve(_capacity, _size), ...); }, _columns);
+    }
+  }
+
+  std::tuple<Column<ValueType<Names>>...> _columns;
+  size_t _size = 0;
+  size_t _capacity = 0;
+};
+
+} // namespace hw::type::beacon
+// --- END FILE: include/hw/type/beacon/Columnar.hpp ---
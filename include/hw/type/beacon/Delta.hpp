@@ -0,0 +1,473 @@
+// --- START FILE: include/hw/type/beacon/Delta.hpp ---
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <hw/type/NameTag.hpp>
+#include <hw/type/beacon/TypeTraits.hpp>
+#include <hw/type/beacon/Message.hpp>
+
+namespace hw::type::beacon {
+
+namespace detail {
+  inline std::byte* putVarint(std::byte* out, uint64_t value) noexcept {
+    while (value >= 0x80) {
+      *out++ = static_cast<std::byte>(value | 0x80);
+      value >>= 7;
+    }
+    *out++ = static_cast<std::byte>(value);
+    return out;
+  }
+
+  inline constexpr uint64_t zigzag(int64_t value) noexcept {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+  }
+
+  inline constexpr int64_t unzigzag(uint64_t value) noexcept {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+  }
+
+  // Bounds-checked record input; running out of bytes means a truncated or corrupt journal.
+  struct DeltaIn {
+    const std::byte* ptr;
+    const std::byte* end;
+
+    uint64_t varint() {
+      uint64_t value = 0;
+      for (unsigned shift = 0; shift < 64; shift += 7) {
+        if (ptr == end) [[unlikely]] {
+          fail();
+        }
+        const auto b = static_cast<uint8_t>(*ptr++);
+        value |= static_cast<uint64_t>(b & 0x7f) << shift;
+        if (!(b & 0x80)) {
+          return value;
+        }
+      }
+      fail();
+    }
+
+    const std::byte* take(size_t len) {
+      if (static_cast<size_t>(end - ptr) < len) [[unlikely]] {
+        fail();
+      }
+      const std::byte* data = ptr;
+      ptr += len;
+      return data;
+    }
+
+    [[noreturn]] static void fail() {
+      throw std::invalid_argument("DeltaCodec: truncated or corrupt record");
+    }
+  };
+
+  // XOR header of an all-zero diff; 15 leading plus 15 trailing zero bytes is no valid span.
+  inline constexpr std::byte XOR_UNCHANGED{0xff};
+
+  // Integral numerics up to 8 bytes travel as zigzag deltas, other numerics as XOR.
+  template <typename ValueField>
+  inline constexpr bool is_delta_numeric_v = [] {
+    if constexpr (std::is_same_v<QueryTrait<ValueField>, trait::Numeric>) {
+      using ValueType = typename ValueField::value_type;
+      return std::is_integral_v<ValueType> && !std::is_same_v<ValueType, bool> && sizeof(ValueType) <= 8;
+    } else {
+      return false;
+    }
+  }();
+
+  // Strings and enums go through a per-field dictionary, Opaque payloads are written out.
+  template <typename ValueField>
+  inline constexpr bool is_dictionary_field_v =
+    !std::is_same_v<QueryTrait<ValueField>, trait::Numeric> && !std::is_same_v<QueryTrait<ValueField>, trait::Opaque>;
+
+  struct StringHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view sv) const noexcept { return std::hash<std::string_view>{}(sv); }
+  };
+
+  using StringIndex = std::unordered_map<std::string, uint32_t, StringHash, std::equal_to<>>;
+}
+
+/**
+ * DeltaCodec: compact journal records for a stream of messages of one type, each encoded
+ * against the previous message with the same key field value.
+ * - Record: key slot (varint; a new key is followed by its raw bytes), then
+ *   varint(changed fields << 1 | presence changed), the presence bitmap if it changed, then
+ *   the changed fields in declaration order. Fields equal to the previous message cost nothing.
+ * - Integral numerics are zigzag varint deltas; floating point and wider numerics are XOR'ed
+ *   and lose their zero bytes at both ends (one header byte), which suits prices that move
+ *   in the low mantissa bits as well as round values.
+ * - Strings and enums are numbered per field on first sight; later occurrences are the
+ *   number's varint. Dictionaries stop growing at DICTIONARY_LIMIT entries, after which unseen
+ *   values are written out every time. Opaque payloads are always written out.
+ * - Encoder and Decoder keep the same state (previous message per key, dictionaries), so a
+ *   journal is decoded from its start, or from a point where both were reset().
+ * - Decoder works from the wire layout: the fixed block is patched in place and packed and
+ *   tail fields are appended, with no Writer and no per-field allocation.
+ */
+template <typename MessageType, NameTag KeyName>
+struct DeltaCodec {
+  using FieldList = typename MessageType::field_list;
+  static constexpr size_t FIELD_CNT = MessageType::FIELD_CNT;
+  static_assert(FIELD_CNT < 64, "the change mask holds up to 63 fields");
+  static_assert(MessageType::template INDEX<KeyName> < FIELD_CNT, "no such key field");
+  static_assert(MessageType::template IS_FIXED<KeyName> && !MessageType::template IS_OPTIONAL<KeyName>,
+                "the key is a mandatory fixed field");
+
+  using KeyField = detail::unwrap_t<typename MessageType::template Field<KeyName>>;
+  static constexpr size_t KEY_OFFSET = MessageType::template OFFSET<KeyName>;
+  static constexpr size_t KEY_SIZE = KeyField::SIZE;
+  static constexpr size_t DICTIONARY_LIMIT = 1 << 16;
+
+private:
+  static constexpr size_t VARINT_MAX = 10;
+
+  template <size_t I>
+  using FieldAt = mp_at_c<FieldList, I>;
+
+  template <size_t I>
+  static constexpr bool IS_FIXED = MessageType::template IS_FIXED<FieldAt<I>::name_tag>;
+
+  static constexpr std::array<size_t, FIELD_CNT> bits() {
+    std::array<size_t, FIELD_CNT> bit {};
+    size_t next = 0;
+    mp_for_each<mp_iota_c<FIELD_CNT>>([&] (auto I) {
+      bit[I] = detail::is_optional_v<FieldAt<I>> ? next++ : MessageType::NO_BIT;
+    });
+    return bit;
+  }
+
+  static constexpr std::array<size_t, FIELD_CNT> BIT = bits();
+
+  static bool present(uint64_t bitmap, size_t index) noexcept {
+    return BIT[index] == MessageType::NO_BIT || ((bitmap >> BIT[index]) & 1);
+  }
+
+  static uint64_t loadBitmap(const std::byte* msg) noexcept {
+    uint64_t bitmap = 0;
+    std::memcpy(&bitmap, msg, MessageType::BITMAP_SIZE);
+    return bitmap;
+  }
+
+  static constexpr size_t maxRecordSize() {
+    size_t size = VARINT_MAX + KEY_SIZE + 2 * VARINT_MAX;
+    mp_for_each<mp_iota_c<FIELD_CNT>>([&] (auto I) {
+      size += 2 * VARINT_MAX + detail::maxWireSize<FieldAt<I>>();
+    });
+    return size;
+  }
+
+public:
+  // Largest record; Encoder::encode needs this much room.
+  static constexpr size_t MAX_RECORD_SIZE = maxRecordSize();
+
+  class Encoder {
+  public:
+    // Writes the record for msg at out and returns its end.
+    std::byte* encode(const std::byte* msg, std::byte* out) {
+      const std::string_view key(reinterpret_cast<const char*>(msg + KEY_OFFSET), KEY_SIZE);
+      const auto it = _slots.find(key);
+      const uint32_t slot = it != _slots.end() ? it->second : static_cast<uint32_t>(_slots.size());
+      out = detail::putVarint(out, slot);
+      std::byte* prev;
+      if (it == _slots.end()) {
+        _slots.emplace(key, slot);
+        _states.resize(_states.size() + MessageType::MAX_SIZE);
+        prev = _states.data() + size_t{slot} * MessageType::MAX_SIZE;
+        std::memcpy(prev + KEY_OFFSET, key.data(), KEY_SIZE);
+        std::memcpy(out, key.data(), KEY_SIZE);
+        out += KEY_SIZE;
+      } else {
+        prev = _states.data() + size_t{slot} * MessageType::MAX_SIZE;
+      }
+
+      const uint64_t bitmap = loadBitmap(msg);
+      const uint64_t prevBitmap = loadBitmap(prev);
+      std::array<const std::byte*, FIELD_CNT> cur {};
+      std::array<const std::byte*, FIELD_CNT> old {};
+      uint64_t changed = 0;
+      const std::byte* curPacked = msg + MessageType::FIXED_SIZE;
+      const std::byte* oldPacked = prev + MessageType::FIXED_SIZE;
+      mp_for_each<mp_iota_c<FIELD_CNT>>([&] (auto I) {
+        using FieldType = FieldAt<I>;
+        if constexpr (IS_FIXED<I>) {
+          constexpr size_t OFFSET = MessageType::template OFFSET<FieldType::name_tag>;
+          cur[I] = msg + OFFSET;
+          old[I] = prev + OFFSET;
+          if (std::memcmp(cur[I], old[I], detail::unwrap_t<FieldType>::SIZE) != 0) {
+            changed |= uint64_t{1} << I;
+          }
+        } else {
+          if (present(prevBitmap, I)) {
+            old[I] = oldPacked;
+            oldPacked += detail::wireSize<FieldType>(oldPacked);
+          }
+          if (present(bitmap, I)) {
+            cur[I] = curPacked;
+            const size_t size = detail::wireSize<FieldType>(curPacked);
+            curPacked += size;
+            if (!old[I] || detail::wireSize<FieldType>(old[I]) != size || std::memcmp(cur[I], old[I], size) != 0) {
+              changed |= uint64_t{1} << I;
+            }
+          }
+        }
+      });
+
+      const bool presence = bitmap != prevBitmap;
+      out = detail::putVarint(out, changed << 1 | presence);
+      if (presence) {
+        out = detail::putVarint(out, bitmap);
+      }
+      mp_for_each<mp_iota_c<FIELD_CNT>>([&] (auto I) {
+        if (changed & (uint64_t{1} << I)) {
+          out = putField<detail::unwrap_t<FieldAt<I>>>(I, old[I], cur[I], out);
+        }
+      });
+      std::memcpy(prev, msg, static_cast<size_t>(curPacked - msg));
+      return out;
+    }
+
+    void reset() {
+      _slots.clear();
+      _states.clear();
+      for (auto& dictionary : _dictionaries) dictionary.clear();
+    }
+
+  private:
+    template <typename ValueField>
+    std::byte* putField(size_t index, const std::byte* old, const std::byte* cur, std::byte* out) {
+      old = old ? old : ZERO.data();
+      if constexpr (detail::is_delta_numeric_v<ValueField>) {
+        using Unsigned = std::make_unsigned_t<typename ValueField::value_type>;
+        Unsigned a, b;
+        std::memcpy(&a, old, sizeof(a));
+        std::memcpy(&b, cur, sizeof(b));
+        const auto delta = static_cast<std::make_signed_t<Unsigned>>(static_cast<Unsigned>(b - a));
+        return detail::putVarint(out, detail::zigzag(delta));
+      } else if constexpr (std::is_same_v<QueryTrait<ValueField>, trait::Numeric>) {
+        constexpr size_t SIZE = ValueField::SIZE;
+        static_assert(SIZE <= 16);
+        std::array<uint8_t, SIZE> diff;
+        for (size_t i = 0; i < SIZE; ++i) {
+          diff[i] = std::to_integer<uint8_t>(old[i] ^ cur[i]);
+        }
+        size_t low = 0, high = SIZE;
+        while (low < SIZE && !diff[low]) ++low;
+        if (low == SIZE) {
+          // no bits changed (a field that turns up equal to zero); low == 16 would not fit
+          *out++ = detail::XOR_UNCHANGED;
+          return out;
+        }
+        while (high > low && !diff[high - 1]) --high;
+        *out++ = static_cast<std::byte>((SIZE - high) << 4 | low);
+        std::memcpy(out, diff.data() + low, high - low);
+        return out + (high - low);
+      } else {
+        const size_t size = detail::wireSize<ValueField>(cur);
+        const std::string_view value(reinterpret_cast<const char*>(cur), size);
+        if constexpr (detail::is_dictionary_field_v<ValueField>) {
+          auto& dictionary = _dictionaries[index];
+          if (const auto it = dictionary.find(value); it != dictionary.end()) {
+            return detail::putVarint(out, it->second);
+          }
+          out = detail::putVarint(out, dictionary.size());
+          if (dictionary.size() < DICTIONARY_LIMIT) {
+            dictionary.emplace(value, static_cast<uint32_t>(dictionary.size()));
+          }
+        }
+        if constexpr (!IS_FIXED_SIZE<ValueField>) {
+          out = detail::putVarint(out, size);
+        }
+        std::memcpy(out, cur, size);
+        return out + size;
+      }
+    }
+
+    detail::StringIndex _slots;
+    std::vector<std::byte> _states; // previous message per slot, MAX_SIZE bytes each
+    std::array<detail::StringIndex, FIELD_CNT> _dictionaries;
+  };
+
+  class Decoder {
+  public:
+    // Decodes the record at first into msg (MAX_SIZE bytes), advances first past it and
+    // returns the message's wire size.
+    size_t decode(const std::byte*& first, const std::byte* last, std::byte* msg) {
+      detail::DeltaIn in {first, last};
+      const uint64_t slot = in.varint();
+      const size_t slots = _states.size() / MessageType::MAX_SIZE;
+      if (slot > slots) [[unlikely]] {
+        in.fail();
+      }
+      if (slot == slots) {
+        const std::byte* key = in.take(KEY_SIZE);
+        _states.resize(_states.size() + MessageType::MAX_SIZE);
+        std::memcpy(_states.data() + slot * MessageType::MAX_SIZE + KEY_OFFSET, key, KEY_SIZE);
+      }
+      const std::byte* prev = _states.data() + slot * MessageType::MAX_SIZE;
+
+      const uint64_t head = in.varint();
+      const uint64_t changed = head >> 1;
+      const uint64_t prevBitmap = loadBitmap(prev);
+      const uint64_t bitmap = (head & 1) ? in.varint() : prevBitmap;
+      if ((changed >> FIELD_CNT) || (bitmap >> MessageType::OPTIONAL_CNT)) [[unlikely]] {
+        in.fail();
+      }
+      std::memcpy(msg, &bitmap, MessageType::BITMAP_SIZE);
+
+      std::byte* packed = msg + MessageType::FIXED_SIZE;
+      const std::byte* oldPacked = prev + MessageType::FIXED_SIZE;
+      mp_for_each<mp_iota_c<FIELD_CNT>>([&] (auto I) {
+        using FieldType = FieldAt<I>;
+        using ValueField = detail::unwrap_t<FieldType>;
+        const bool isChanged = (changed >> I) & 1;
+        if constexpr (IS_FIXED<I>) {
+          constexpr size_t OFFSET = MessageType::template OFFSET<FieldType::name_tag>;
+          if (isChanged) {
+            getField<ValueField>(I, in, prev + OFFSET, msg + OFFSET);
+          } else {
+            std::memcpy(msg + OFFSET, prev + OFFSET, ValueField::SIZE);
+          }
+        } else {
+          const std::byte* old = nullptr;
+          if (present(prevBitmap, I)) {
+            old = oldPacked;
+            oldPacked += detail::wireSize<FieldType>(oldPacked);
+          }
+          if (!present(bitmap, I)) {
+            if (isChanged) [[unlikely]] {
+              in.fail();
+            }
+          } else if (isChanged) {
+            packed += getField<ValueField>(I, in, old, packed);
+          } else {
+            if (!old) [[unlikely]] {
+              in.fail();
+            }
+            const size_t size = detail::wireSize<FieldType>(old);
+            std::memcpy(packed, old, size);
+            packed += size;
+          }
+        }
+      });
+
+      const size_t size = static_cast<size_t>(packed - msg);
+      std::memcpy(_states.data() + slot * MessageType::MAX_SIZE, msg, size);
+      first = in.ptr;
+      return size;
+    }
+
+    void reset() {
+      _states.clear();
+      for (auto& dictionary : _dictionaries) dictionary.clear();
+    }
+
+  private:
+    // Values in first-seen order, packed back to back.
+    struct Dictionary {
+      std::vector<uint32_t> offsets {0};
+      std::vector<std::byte> data;
+
+      size_t size() const noexcept { return offsets.size() - 1; }
+
+      void add(const std::byte* value, size_t len) {
+        data.insert(data.end(), value, value + len);
+        offsets.push_back(static_cast<uint32_t>(data.size()));
+      }
+
+      void clear() {
+        offsets.assign(1, 0);
+        data.clear();
+      }
+    };
+
+    // Writes the field's wire bytes at dst and returns their size.
+    template <typename ValueField>
+    size_t getField(size_t index, detail::DeltaIn& in, const std::byte* old, std::byte* dst) {
+      old = old ? old : ZERO.data();
+      if constexpr (detail::is_delta_numeric_v<ValueField>) {
+        using Unsigned = std::make_unsigned_t<typename ValueField::value_type>;
+        Unsigned a;
+        std::memcpy(&a, old, sizeof(a));
+        const auto b = static_cast<Unsigned>(a + static_cast<Unsigned>(detail::unzigzag(in.varint())));
+        std::memcpy(dst, &b, sizeof(b));
+        return sizeof(b);
+      } else if constexpr (std::is_same_v<QueryTrait<ValueField>, trait::Numeric>) {
+        constexpr size_t SIZE = ValueField::SIZE;
+        const auto header = std::to_integer<size_t>(*in.take(1));
+        if (header == std::to_integer<size_t>(detail::XOR_UNCHANGED)) {
+          std::memcpy(dst, old, SIZE);
+          return SIZE;
+        }
+        const size_t low = header & 0x0f, high = SIZE - (header >> 4);
+        if (header >> 4 > SIZE || low > high) [[unlikely]] {
+          in.fail();
+        }
+        const std::byte* diff = in.take(high - low);
+        std::memcpy(dst, old, SIZE);
+        for (size_t i = low; i < high; ++i) {
+          dst[i] ^= diff[i - low];
+        }
+        return SIZE;
+      } else {
+        if constexpr (detail::is_dictionary_field_v<ValueField>) {
+          Dictionary& dictionary = _dictionaries[index];
+          const uint64_t id = in.varint();
+          if (id < dictionary.size()) {
+            const size_t size = dictionary.offsets[id + 1] - dictionary.offsets[id];
+            std::memcpy(dst, dictionary.data.data() + dictionary.offsets[id], size);
+            return size;
+          }
+          if (id != dictionary.size()) [[unlikely]] {
+            in.fail();
+          }
+        }
+        size_t size;
+        if constexpr (IS_FIXED_SIZE<ValueField>) {
+          size = ValueField::SIZE;
+        } else {
+          size = in.varint();
+          if (size > detail::maxWireSize<ValueField>()) [[unlikely]] {
+            in.fail();
+          }
+        }
+        std::memcpy(dst, in.take(size), size);
+        if (detail::wireSize<ValueField>(dst) != size) [[unlikely]] {
+          in.fail();
+        }
+        if constexpr (detail::is_dictionary_field_v<ValueField>) {
+          if (_dictionaries[index].size() < DICTIONARY_LIMIT) {
+            _dictionaries[index].add(dst, size);
+          }
+        }
+        return size;
+      }
+    }
+
+    std::vector<std::byte> _states;
+    std::array<Dictionary, FIELD_CNT> _dictionaries;
+  };
+
+private:
+  // Base of packed numerics the key's previous message did not have.
+  static constexpr std::array<std::byte, 16> ZERO {};
+
+  // Fields whose wire size is their SIZE: no length in the record.
+  template <typename ValueField>
+  static constexpr bool IS_FIXED_SIZE =
+    std::is_same_v<QueryTrait<ValueField>, trait::Enum> || std::is_same_v<QueryTrait<ValueField>, trait::PaddedString>;
+};
+
+} // namespace hw::type::beacon
+// --- END FILE: include/hw/type/beacon/Delta.hpp ---
@@ -1,6 +1,7 @@
 // --- START FILE: include/hw/type/beacon/Enum.hpp ---
 #pragma once
 
+#include <array>
 #include <utility>
 #include <ostream>
 #include <string_view>
@@ -10,6 +11,7 @@
 #include <better-enum/enum.h>
 
 #include <hw/type/NameTag.hpp>
+#include <hw/type/PerfectHash.hpp>
 #include <hw/type/beacon/TypeTraits.hpp>
 #include <hw/utility/Format.hpp>
 
@@ -55,12 +57,11 @@ struct NamedEnumType {
   }
 
   static void set(std::byte* ptr, std::string_view value) {
-    // Better Enums _from_string requires null-termination; std::string ensures this.
-    auto opt = ValueType::_from_string_nothrow(std::string(value).c_str());
-    if (!opt) {
+    const size_t index = names().find(value);
+    if (index == names().NOT_FOUND) {
       throw std::invalid_argument(frmt::format("Invalid string value for Enum {}: '{}'", Tag.toString(), value));
     }
-    ValueType val = *opt;
+    ValueType val = ValueType::_values()[index];
     std::memcpy(ptr, &val, SIZE);
   }
 
@@ -73,6 +74,22 @@ struct NamedEnumType {
   static std::string toString(const std::byte* ptr) {
     return get(ptr)._to_string();
   }
+
+private:
+  static constexpr size_t COUNT = ValueType::_size_constant;
+
+  // Better Enums trims its names on first use, so the table is built then rather than at
+  // compile time; lookups are O(1) either way and never copy the input.
+  static const type::PerfectHash<COUNT>& names() {
+    static const type::PerfectHash<COUNT> table = [] {
+      std::array<std::string_view, COUNT> keys;
+      for (size_t i = 0; i < COUNT; ++i) {
+        keys[i] = ValueType::_names()[i];
+      }
+      return type::PerfectHash<COUNT>(keys);
+    }();
+    return table;
+  }
 };
 
 } // namespace hw::type::beacon
@@ -0,0 +1,448 @@
+// --- START FILE: include/hw/type/beacon/Json.hpp ---
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include <hw/type/NameTag.hpp>
+#include <hw/type/TypeList.hpp>
+#include <hw/utility/Hex.hpp>
+#include <hw/type/beacon/TypeTraits.hpp>
+#include <hw/type/beacon/Numeric.hpp>
+#include <hw/type/beacon/Message.hpp>
+
+namespace hw::type::beacon {
+
+/**
+ * JsonValue: one member value as seen by a JsonParser handler.
+ * - text is the raw token; for strings it excludes the quotes and is still escaped when
+ *   `escaped` is set (JsonParser::unescape decodes it).
+ * - OBJECT and ARRAY values are skipped over, text spans the whole nested value.
+ */
+struct JsonValue {
+  enum Kind : uint8_t { STRING, NUMBER, BOOLEAN, NIL, OBJECT, ARRAY };
+  Kind kind;
+  bool escaped = false;
+  std::string_view text;
+};
+
+/**
+ * JsonParser: SAX-style reader of one flat JSON object.
+ * - parse() calls handler(key, JsonValue) for each member in document order; keys and values
+ *   are views into the input, nothing is copied or allocated.
+ * - Malformed input throws std::invalid_argument.
+ */
+class JsonParser {
+public:
+  template <typename Handler>
+  static const char* parse(std::string_view json, Handler&& handler) {
+    JsonParser parser(json);
+    parser.skipSpace();
+    parser.expect('{');
+    parser.skipSpace();
+    if (parser.peek() == '}') {
+      return parser._ptr + 1;
+    }
+    char keyBuf[KEY_CAPACITY];
+    for (;;) {
+      parser.skipSpace();
+      parser.expect('"');
+      JsonValue key = parser.string();
+      std::string_view name = key.text;
+      if (key.escaped) {
+        name = std::string_view(keyBuf, unescape(key.text, keyBuf, sizeof(keyBuf)));
+      }
+      parser.skipSpace();
+      parser.expect(':');
+      parser.skipSpace();
+      handler(name, parser.value());
+      parser.skipSpace();
+      const char c = parser.next();
+      if (c == '}') {
+        return parser._ptr;
+      }
+      if (c != ',') {
+        parser.fail("',' or '}' expected");
+      }
+    }
+  }
+
+  // Decodes JSON escapes of a string value into dst; stops at capacity, returns the length.
+  static size_t unescape(std::string_view text, char* dst, size_t capacity) {
+    size_t len = 0;
+    for (size_t i = 0; i < text.size() && len < capacity; ) {
+      const char c = text[i++];
+      if (c != '\\') {
+        dst[len++] = c;
+        continue;
+      }
+      if (i == text.size()) {
+        throw std::invalid_argument("JSON: dangling escape");
+      }
+      switch (const char e = text[i++]) {
+        case '"': case '\\': case '/': dst[len++] = e; break;
+        case 'b': dst[len++] = '\b'; break;
+        case 'f': dst[len++] = '\f'; break;
+        case 'n': dst[len++] = '\n'; break;
+        case 'r': dst[len++] = '\r'; break;
+        case 't': dst[len++] = '\t'; break;
+        case 'u': {
+          uint32_t cp = hex4(text, i);
+          i += 4;
+          if (cp >= 0xd800 && cp < 0xdc00 && i + 6 <= text.size() && text[i] == '\\' && text[i + 1] == 'u') {
+            const uint32_t low = hex4(text, i + 2);
+            if (low >= 0xdc00 && low < 0xe000) {
+              cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+              i += 6;
+            }
+          }
+          char utf8[4];
+          size_t n;
+          if (cp < 0x80) {
+            utf8[0] = static_cast<char>(cp);
+            n = 1;
+          } else if (cp < 0x800) {
+            utf8[0] = static_cast<char>(0xc0 | (cp >> 6));
+            utf8[1] = static_cast<char>(0x80 | (cp & 0x3f));
+            n = 2;
+          } else if (cp < 0x10000) {
+            utf8[0] = static_cast<char>(0xe0 | (cp >> 12));
+            utf8[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+            utf8[2] = static_cast<char>(0x80 | (cp & 0x3f));
+            n = 3;
+          } else {
+            utf8[0] = static_cast<char>(0xf0 | (cp >> 18));
+            utf8[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3f));
+            utf8[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+            utf8[3] = static_cast<char>(0x80 | (cp & 0x3f));
+            n = 4;
+          }
+          n = std::min(n, capacity - len);
+          std::memcpy(dst + len, utf8, n);
+          len += n;
+          break;
+        }
+        default:
+          throw std::invalid_argument("JSON: invalid escape");
+      }
+    }
+    return len;
+  }
+
+private:
+  static constexpr size_t KEY_CAPACITY = 64;
+
+  explicit JsonParser(std::string_view json) noexcept : _ptr(json.data()), _end(json.data() + json.size()) {}
+
+  [[noreturn]] void fail(const char* what) const {
+    throw std::invalid_argument(std::string("JSON: ") + what + " at offset " + std::to_string(_end - _ptr) + " from the end");
+  }
+
+  static uint32_t hex4(std::string_view text, size_t at) {
+    if (at + 4 > text.size()) {
+      throw std::invalid_argument("JSON: short \\u escape");
+    }
+    uint32_t cp = 0;
+    for (size_t k = 0; k < 4; ++k) {
+      const uint8_t nibble = hw::utility::detail::HEX_NIBBLES[static_cast<uint8_t>(text[at + k])];
+      if (nibble > 0x0f) {
+        throw std::invalid_argument("JSON: invalid \\u escape");
+      }
+      cp = (cp << 4) | nibble;
+    }
+    return cp;
+  }
+
+  char peek() const noexcept { return _ptr != _end ? *_ptr : '\0'; }
+
+  char next() {
+    if (_ptr == _end) fail("unexpected end");
+    return *_ptr++;
+  }
+
+  void expect(char c) {
+    if (next() != c) fail("unexpected character");
+  }
+
+  void skipSpace() noexcept {
+    while (_ptr != _end && (*_ptr == ' ' || *_ptr == '\n' || *_ptr == '\r' || *_ptr == '\t')) ++_ptr;
+  }
+
+  // After the opening quote; leaves _ptr past the closing one.
+  JsonValue string() {
+    JsonValue value {JsonValue::STRING, false, {}};
+    const char* begin = _ptr;
+    for (;;) {
+      const char* quote = static_cast<const char*>(std::memchr(_ptr, '"', static_cast<size_t>(_end - _ptr)));
+      if (!quote) fail("unterminated string");
+      const char* slash = static_cast<const char*>(std::memchr(_ptr, '\\', static_cast<size_t>(quote - _ptr)));
+      if (!slash) {
+        _ptr = quote + 1;
+        break;
+      }
+      value.escaped = true;
+      _ptr = slash + 2 <= _end ? slash + 2 : _end; // the escaped character may be a quote
+    }
+    value.text = std::string_view(begin, static_cast<size_t>(_ptr - 1 - begin));
+    return value;
+  }
+
+  JsonValue literal(JsonValue::Kind kind, std::string_view word) {
+    if (static_cast<size_t>(_end - _ptr) < word.size() || std::string_view(_ptr, word.size()) != word) {
+      fail("invalid literal");
+    }
+    JsonValue value {kind, false, std::string_view(_ptr, word.size())};
+    _ptr += word.size();
+    return value;
+  }
+
+  JsonValue value() {
+    const char* begin = _ptr;
+    switch (peek()) {
+      case '"':
+        ++_ptr;
+        return string();
+      case 't': return literal(JsonValue::BOOLEAN, "true");
+      case 'f': return literal(JsonValue::BOOLEAN, "false");
+      case 'n': return literal(JsonValue::NIL, "null");
+      case '{': case '[': {
+        const JsonValue::Kind kind = *_ptr == '{' ? JsonValue::OBJECT : JsonValue::ARRAY;
+        size_t depth = 0;
+        do {
+          const char c = next();
+          if (c == '"') string();
+          else if (c == '{' || c == '[') ++depth;
+          else if (c == '}' || c == ']') --depth;
+        } while (depth);
+        return {kind, false, std::string_view(begin, static_cast<size_t>(_ptr - begin))};
+      }
+      default: {
+        while (_ptr != _end && ((*_ptr >= '0' && *_ptr <= '9') || *_ptr == '-' || *_ptr == '+' ||
+                                *_ptr == '.' || *_ptr == 'e' || *_ptr == 'E')) {
+          ++_ptr;
+        }
+        if (_ptr == begin) fail("value expected");
+        return {JsonValue::NUMBER, false, std::string_view(begin, static_cast<size_t>(_ptr - begin))};
+      }
+    }
+  }
+
+  const char* _ptr;
+  const char* const _end;
+};
+
+namespace detail {
+  // Numeric fields whose toChars text is a valid JSON number (after a finiteness check).
+  template <typename FieldType>
+  inline constexpr bool is_json_number_v = [] {
+    using ValueType = typename FieldType::value_type;
+    if constexpr (std::is_same_v<ValueType, char> || std::is_same_v<ValueType, bool>) return false;
+    else if constexpr (std::is_integral_v<ValueType>) return sizeof(ValueType) > 1;
+    else return std::is_floating_point_v<ValueType> || LongNumericType<ValueType> || std::is_enum_v<ValueType>;
+  }();
+
+  // Largest text a field's set(string_view) can use; longer string values are truncated.
+  template <typename FieldType>
+  constexpr size_t jsonTextCapacity() {
+    using Trait = QueryTrait<FieldType>;
+    if constexpr (std::is_same_v<Trait, trait::Numeric>) return FieldType::MAX_CHARS;
+    else if constexpr (std::is_same_v<Trait, trait::Opaque>) return 2 * FieldType::MAX_PAYLOAD_SIZE + 2;
+    else if constexpr (std::is_same_v<Trait, trait::Enum>) return 256;
+    else return FieldType::SIZE;
+  }
+
+  // Bounds-checked output cursor; overflow sets ok = false and drops the rest.
+  struct JsonOut {
+    char* ptr;
+    char* const end;
+    bool ok = true;
+
+    void put(char c) noexcept {
+      if (ptr != end) *ptr++ = c;
+      else ok = false;
+    }
+
+    void put(std::string_view text) noexcept {
+      if (static_cast<size_t>(end - ptr) >= text.size()) {
+        std::memcpy(ptr, text.data(), text.size());
+        ptr += text.size();
+      } else {
+        ok = false;
+        ptr = end;
+      }
+    }
+
+    // Quoted string: runs of plain characters are copied whole, the rest escaped.
+    void quoted(std::string_view text) noexcept {
+      put('"');
+      size_t run = 0;
+      for (size_t i = 0; i < text.size(); ++i) {
+        const unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+        put(text.substr(run, i - run));
+        run = i + 1;
+        switch (c) {
+          case '"':  put("\\\""); break;
+          case '\\': put("\\\\"); break;
+          case '\n': put("\\n"); break;
+          case '\r': put("\\r"); break;
+          case '\t': put("\\t"); break;
+          default: {
+            char esc[6] = {'\\', 'u', '0', '0'};
+            hw::utility::hexEncode(&c, 1, esc + 4);
+            put(std::string_view(esc, 6));
+          }
+        }
+      }
+      put(text.substr(run));
+      put('"');
+    }
+  };
+}
+
+/**
+ * JsonCodec: beacon message <-> one flat JSON object keyed by field names.
+ * - encode() writes {"Name":value,...} in declaration order into a caller buffer; absent
+ *   optional fields are left out. Numbers are bare, everything else (Char, 1-byte integers as
+ *   0x.., strings, Opaque hex, enum names, time values) is a string holding the field's
+ *   toString text, so values round-trip through set(ptr, string_view).
+ * - decode() parses with JsonParser straight into a message buffer (MAX_SIZE bytes). Members
+ *   may come in any order: names resolve to field indexes through the message's compile-time
+ *   perfect hash, values stay views into the input until the message is written in
+ *   declaration order. Unknown members are ignored, null means absent, mandatory fixed fields
+ *   that are missing read as zero.
+ * - Neither direction allocates, escaped strings are decoded into stack buffers; the exceptions
+ *   are errors and time-typed fields, whose set(ptr, string_view) parses a std::string copy.
+ * - decode() takes exactly one object: anything but whitespace after it is an error.
+ */
+template <typename MessageType>
+class JsonCodec {
+  static_assert(std::is_same_v<QueryTrait<MessageType>, trait::Message>, "NamedMessageType is expected");
+
+  using FieldList = typename MessageType::field_list;
+  static constexpr size_t FIELD_CNT = MessageType::FIELD_CNT;
+
+  template <size_t I>
+  static constexpr auto KEY = [] {
+    constexpr std::string_view name = mp_at_c<FieldList, I>::name_tag.toString();
+    std::array<char, name.size() + 4> key {};
+    key[0] = ',';
+    key[1] = '"';
+    for (size_t i = 0; i < name.size(); ++i) key[i + 2] = name[i];
+    key[name.size() + 2] = '"';
+    key[name.size() + 3] = ':';
+    return key;
+  }();
+
+public:
+  // Returns the end of the JSON text, nullptr if it does not fit in [first, last).
+  static char* encode(const std::byte* msg, char* first, char* last) {
+    detail::JsonOut out {first, last};
+    out.put('{');
+    bool separator = false;
+    MessageType::forEach(msg, [&] <typename FieldType> (std::type_identity<FieldType>, const std::byte* ptr) {
+      if (!ptr) return;
+      constexpr size_t I = MessageType::template INDEX<FieldType::name_tag>;
+      out.put(std::string_view(KEY<I>.data() + !separator, KEY<I>.size() - !separator));
+      separator = true;
+      encodeValue<detail::unwrap_t<FieldType>>(ptr, out);
+    });
+    out.put('}');
+    return out.ok ? out.ptr : nullptr;
+  }
+
+  // Returns the wire size of the decoded message.
+  static size_t decode(std::string_view json, std::byte* msg) {
+    std::array<JsonValue, FIELD_CNT> values;
+    std::array<bool, FIELD_CNT> seen {};
+    const char* const last = JsonParser::parse(json, [&] (std::string_view key, const JsonValue& value) {
+      const size_t index = MessageType::FIELD_NAMES.find(key);
+      if (index == FIELD_CNT) return;
+      if (value.kind == JsonValue::OBJECT || value.kind == JsonValue::ARRAY) {
+        throw std::invalid_argument(std::string("JSON: nested value for field ") + std::string(key));
+      }
+      values[index] = value;
+      seen[index] = value.kind != JsonValue::NIL;
+    });
+    if (json.find_first_not_of(" \n\r\t", static_cast<size_t>(last - json.data())) != std::string_view::npos) {
+      throw std::invalid_argument("JSON: unexpected characters after the object");
+    }
+
+    std::memset(msg, 0, MessageType::FIXED_SIZE);
+    typename MessageType::Writer writer(msg);
+    mp_for_each<mp_iota_c<FIELD_CNT>>([&] (auto I) {
+      if (!seen[I]) return;
+      using FieldType = mp_at_c<FieldList, I>;
+      using ValueField = detail::unwrap_t<FieldType>;
+      constexpr auto Name = FieldType::name_tag;
+      char buf[detail::jsonTextCapacity<ValueField>()];
+      std::string_view text = values[I].text;
+      if (values[I].escaped) {
+        text = std::string_view(buf, JsonParser::unescape(text, buf, sizeof(buf)));
+      }
+      if constexpr (MessageType::template IS_FIXED<Name>) {
+        MessageType::template set<Name>(msg, text);
+      } else if constexpr (std::is_same_v<QueryTrait<ValueField>, trait::Opaque>) {
+        writer.template opaque<Name>().fromString(text);
+      } else {
+        writer.template set<Name>(text);
+      }
+    });
+    return writer.size();
+  }
+
+private:
+  template <typename FieldType>
+  static void encodeValue(const std::byte* ptr, detail::JsonOut& out) {
+    using Trait = QueryTrait<FieldType>;
+    if constexpr (std::is_same_v<Trait, trait::Numeric>) {
+      using ValueType = typename FieldType::value_type;
+      if constexpr (std::is_same_v<ValueType, bool>) {
+        out.put(FieldType::get(ptr) ? std::string_view("true") : std::string_view("false"));
+        return;
+      } else {
+        char text[FieldType::MAX_CHARS];
+        const auto result = FieldType::toChars(ptr, text, text + sizeof(text));
+        const std::string_view view(text, static_cast<size_t>(result.ptr - text));
+        bool bare = detail::is_json_number_v<FieldType>;
+        if constexpr (std::is_floating_point_v<ValueType>) {
+          bare = std::isfinite(FieldType::get(ptr));
+        }
+        if (bare) {
+          out.put(view);
+        } else {
+          out.quoted(view);
+        }
+      }
+    }
+    else if constexpr (std::is_same_v<Trait, trait::Opaque>) {
+      const typename FieldType::Viewer viewer(ptr);
+      const size_t len = 2 * viewer.payloadSize();
+      out.put('"');
+      if (static_cast<size_t>(out.end - out.ptr) >= len) {
+        out.ptr = viewer.toChars(out.ptr);
+      } else {
+        out.ok = false;
+      }
+      out.put('"');
+    }
+    else if constexpr (std::is_same_v<Trait, trait::Enum>) {
+      out.quoted(FieldType::get(ptr)._to_string());
+    }
+    else {
+      out.quoted(FieldType::get(ptr));
+    }
+  }
+};
+
+} // namespace hw::type::beacon
+// --- END FILE: include/hw/type/beacon/Json.hpp ---
@@ -0,0 +1,498 @@
+// --- START FILE: include/hw/type/beacon/Message.hpp ---
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include <hw/type/NameTag.hpp>
+#include <hw/type/PerfectHash.hpp>
+#include <hw/type/TypeList.hpp>
+#include <hw/type/beacon/TypeTraits.hpp>
+#include <hw/type/beacon/String.hpp>
+#include <hw/type/beacon/Opaque.hpp>
+#include <hw/type/beacon/Optional.hpp>
+
+namespace hw::type::beacon {
+
+namespace detail {
+  template <typename Field>
+  struct Unwrap {
+    using type = Field;
+    static constexpr bool optional = false;
+    static constexpr bool skip = false;
+  };
+
+  template <typename Field>
+  requires std::is_same_v<QueryTrait<Field>, trait::Optional>
+  struct Unwrap<Field> {
+    using type = typename Field::field_type;
+    static constexpr bool optional = true;
+    static constexpr bool skip = Field::policy == OptionalPolicy::SKIP;
+  };
+
+  // The value type of a field, looking through Optional.
+  template <typename Field>
+  using unwrap_t = typename Unwrap<Field>::type;
+
+  template <typename Field>
+  inline constexpr bool is_optional_v = Unwrap<Field>::optional;
+
+  /**
+   * Tail fields have a wire size that depends on their content and must follow all other fields:
+   * - VarString: the characters plus a '\0' terminator unless the full capacity is used.
+   * - PrefixedString: 2-byte length followed by the characters.
+   * - Opaque: 2-byte payload size followed by the payload.
+   */
+  template <typename Field>
+  inline constexpr bool is_tail_field_v =
+    std::is_same_v<QueryTrait<unwrap_t<Field>>, trait::VarString> ||
+    std::is_same_v<QueryTrait<unwrap_t<Field>>, trait::PrefixedString> ||
+    std::is_same_v<QueryTrait<unwrap_t<Field>>, trait::Opaque>;
+
+  // Tail strings written from a string_view.
+  template <typename Field>
+  inline constexpr bool is_tail_string_v =
+    std::is_same_v<QueryTrait<unwrap_t<Field>>, trait::VarString> ||
+    std::is_same_v<QueryTrait<unwrap_t<Field>>, trait::PrefixedString>;
+
+  // Optional fixed-size fields packed after the fixed block when present.
+  template <typename Field>
+  inline constexpr bool is_sparse_field_v = Unwrap<Field>::skip && !is_tail_field_v<Field>;
+
+  template <typename Field>
+  using IsTailField = mp_bool<is_tail_field_v<Field>>;
+
+  template <typename Field>
+  using IsOptionalField = mp_bool<is_optional_v<Field>>;
+
+  template <typename Field>
+  using IsMessageField = mp_bool<
+    mp_contains<type_list<trait::Numeric, trait::Enum, trait::PaddedString, trait::VarString, trait::PrefixedString, trait::Opaque>,
+                QueryTrait<unwrap_t<Field>>>::value>;
+
+  template <typename Field>
+  constexpr size_t maxWireSize() {
+    if constexpr (std::is_same_v<QueryTrait<unwrap_t<Field>>, trait::Opaque> ||
+                  std::is_same_v<QueryTrait<unwrap_t<Field>>, trait::PrefixedString>) {
+      return unwrap_t<Field>::MAX_MEM_SIZE;
+    } else {
+      return unwrap_t<Field>::SIZE;
+    }
+  }
+
+  template <typename Field>
+  size_t wireSize(const std::byte* ptr) {
+    using ValueField = unwrap_t<Field>;
+    if constexpr (std::is_same_v<QueryTrait<ValueField>, trait::Opaque>) {
+      return typename ValueField::Viewer(ptr).size();
+    } else if constexpr (std::is_same_v<QueryTrait<ValueField>, trait::VarString>) {
+      const size_t len = ValueField::size(ptr);
+      return len < ValueField::SIZE ? len + 1 : len;
+    } else if constexpr (std::is_same_v<QueryTrait<ValueField>, trait::PrefixedString>) {
+      return ValueField::wireSize(ptr);
+    } else {
+      return ValueField::SIZE;
+    }
+  }
+
+  // Writes the empty value of a mandatory tail field.
+  template <typename Field>
+  void clearTail(std::byte* ptr) {
+    if constexpr (std::is_same_v<QueryTrait<unwrap_t<Field>>, trait::Opaque>) {
+      typename unwrap_t<Field>::Editor editor(ptr);
+    } else if constexpr (std::is_same_v<QueryTrait<unwrap_t<Field>>, trait::PrefixedString>) {
+      unwrap_t<Field>::set(ptr, std::string_view());
+    } else {
+      *ptr = std::byte{0};
+    }
+  }
+
+  // Zero-copy value at ptr: the field's get(), or a Viewer for Opaque.
+  template <typename Field>
+  auto view(const std::byte* ptr) {
+    using ValueField = unwrap_t<Field>;
+    if constexpr (std::is_same_v<QueryTrait<ValueField>, trait::Opaque>) {
+      return typename ValueField::Viewer(ptr);
+    } else {
+      return ValueField::get(ptr);
+    }
+  }
+}
+
+/**
+ * NamedMessageType: wire layout of a message made of named beacon fields.
+ * - Optional<...> fields are tracked by a presence bitmap at the head of the message (one bit
+ *   per optional field in declaration order, BITMAP_SIZE bytes, none if there are none).
+ * - Fixed fields (Numeric, Enum, PaddedString, and optional ones with the SLOT policy) follow
+ *   the bitmap; their offsets are compile-time constants and get/set go straight to
+ *   msg + OFFSET with the field's own memcpy accessors.
+ * - Optional fixed-size fields with the SKIP policy are packed after the fixed block only when
+ *   present. Their offset is sum(size class * popcount(bitmap & preceding fields of that class)),
+ *   a handful of popcounts regardless of how many fields precede them.
+ * - Tail fields (VarString, PrefixedString, Opaque) come last in declaration order; their position depends on
+ *   the ones before them and is found by walking the tail. Cursor (Reader/Writer) walks it once
+ *   for several fields. Absent optional tail fields take no bytes.
+ * - Nothing is copied out of the buffer: strings come back as string_view, Opaque as a Viewer,
+ *   optional fields wrapped in std::optional.
+ */
+template <NameTag Tag, typename FieldList>
+struct NamedMessageType {
+  using type_trait = trait::Message;
+  using field_list = FieldList;
+  static constexpr NameTag name_tag = Tag;
+
+  static_assert(mp_is_list<FieldList>::value, "type list of beacon fields is expected");
+  static_assert(mp_all_of<FieldList, detail::IsMessageField>::value,
+                "message fields are Numeric, Enum, PaddedString, VarString, PrefixedString, Opaque or Optional of those");
+
+  static constexpr size_t FIELD_CNT = mp_size<FieldList>::value;
+  static constexpr size_t FIXED_CNT = mp_find_if<FieldList, detail::IsTailField>::value;
+  static_assert(mp_count_if<FieldList, detail::IsTailField>::value == FIELD_CNT - FIXED_CNT,
+                "variable-length fields must follow all fixed fields");
+
+  static constexpr size_t OPTIONAL_CNT = mp_count_if<FieldList, detail::IsOptionalField>::value;
+  static_assert(OPTIONAL_CNT <= 64, "at most 64 optional fields");
+  static constexpr size_t BITMAP_SIZE = (OPTIONAL_CNT + 7) / 8;
+  static constexpr size_t NO_BIT = 64;
+
+private:
+  enum Placement : uint8_t { FIXED, SPARSE, TAIL };
+
+  struct Layout {
+    std::array<Placement, FIELD_CNT> placement {};
+    std::array<size_t, FIELD_CNT> offset {};      // FIXED: from the message start
+    std::array<size_t, FIELD_CNT> bit {};         // optional fields: presence bit, otherwise NO_BIT
+    std::array<size_t, FIELD_CNT> classSize {};   // distinct sizes of SPARSE fields
+    std::array<uint64_t, FIELD_CNT> classMask {}; // presence bits of the SPARSE fields of each size
+    size_t classCnt = 0;
+    size_t fixedEnd = BITMAP_SIZE;
+    size_t maxSize = BITMAP_SIZE;
+  };
+
+  static constexpr Layout layout() {
+    Layout lt;
+    size_t nextBit = 0;
+    mp_for_each<mp_iota_c<FIELD_CNT>>([&] (auto I) {
+      using FieldType = mp_at_c<FieldList, I>;
+      lt.bit[I] = detail::is_optional_v<FieldType> ? nextBit++ : NO_BIT;
+      lt.maxSize += detail::maxWireSize<FieldType>();
+      if constexpr (detail::is_tail_field_v<FieldType>) {
+        lt.placement[I] = TAIL;
+      } else if constexpr (detail::is_sparse_field_v<FieldType>) {
+        lt.placement[I] = SPARSE;
+        size_t cls = 0;
+        while (cls < lt.classCnt && lt.classSize[cls] != detail::unwrap_t<FieldType>::SIZE) ++cls;
+        if (cls == lt.classCnt) {
+          lt.classSize[lt.classCnt++] = detail::unwrap_t<FieldType>::SIZE;
+        }
+        lt.classMask[cls] |= uint64_t{1} << lt.bit[I];
+      } else {
+        lt.placement[I] = FIXED;
+        lt.offset[I] = lt.fixedEnd;
+        lt.fixedEnd += detail::unwrap_t<FieldType>::SIZE;
+      }
+    });
+    return lt;
+  }
+
+  static constexpr Layout LAYOUT = layout();
+
+  template <NameTag Name>
+  static constexpr size_t indexOf() {
+    size_t result = FIELD_CNT;
+    mp_for_each<mp_iota_c<FIELD_CNT>>([&] (auto I) {
+      if (result == FIELD_CNT && mp_at_c<FieldList, I>::name_tag.toString() == Name.toString()) {
+        result = I;
+      }
+    });
+    return result;
+  }
+
+  static constexpr bool uniqueNames() {
+    bool unique = true;
+    mp_for_each<mp_iota_c<FIELD_CNT>>([&] (auto I) {
+      mp_for_each<mp_iota_c<decltype(I)::value>>([&] (auto J) {
+        unique = unique && mp_at_c<FieldList, I>::name_tag.toString() != mp_at_c<FieldList, J>::name_tag.toString();
+      });
+    });
+    return unique;
+  }
+  static_assert(uniqueNames(), "field names must be unique");
+
+  using WireSizeFn = size_t (*)(const std::byte*);
+  using TailClearFn = void (*)(std::byte*);
+
+  template <size_t... I>
+  static constexpr std::array<WireSizeFn, FIELD_CNT> wireSizes(std::index_sequence<I...>) {
+    return {&detail::wireSize<mp_at_c<FieldList, I>>...};
+  }
+
+  template <size_t... I>
+  static constexpr std::array<TailClearFn, FIELD_CNT> tailClears(std::index_sequence<I...>) {
+    return {&detail::clearTail<mp_at_c<FieldList, I>>...};
+  }
+
+  template <size_t... I>
+  static constexpr std::array<std::string_view, FIELD_CNT> fieldNames(std::index_sequence<I...>) {
+    return {mp_at_c<FieldList, I>::name_tag.toString()...};
+  }
+
+  static constexpr std::array<WireSizeFn, FIELD_CNT> WIRE_SIZE = wireSizes(std::make_index_sequence<FIELD_CNT>{});
+  static constexpr std::array<TailClearFn, FIELD_CNT> TAIL_CLEAR = tailClears(std::make_index_sequence<FIELD_CNT>{});
+
+  static uint64_t loadBitmap(const std::byte* msg) noexcept {
+    uint64_t bitmap = 0;
+    std::memcpy(&bitmap, msg, BITMAP_SIZE); // little-endian host, as for the field accessors
+    return bitmap;
+  }
+
+  static void storeBitmap(std::byte* msg, uint64_t bitmap) noexcept {
+    std::memcpy(msg, &bitmap, BITMAP_SIZE);
+  }
+
+  // Bytes taken by the present SKIP fields whose presence bits are in `mask`.
+  static size_t sparseSize(uint64_t bitmap, uint64_t mask) noexcept {
+    size_t size = 0;
+    for (size_t cls = 0; cls < LAYOUT.classCnt; ++cls) {
+      size += LAYOUT.classSize[cls] * static_cast<size_t>(std::popcount(bitmap & mask & LAYOUT.classMask[cls]));
+    }
+    return size;
+  }
+
+  static bool present(uint64_t bitmap, size_t index) noexcept {
+    return LAYOUT.bit[index] == NO_BIT || ((bitmap >> LAYOUT.bit[index]) & 1);
+  }
+
+public:
+  static constexpr size_t FIXED_SIZE = LAYOUT.fixedEnd;
+  static constexpr uint64_t SIGNATURE = TypeListSignature<FieldList>();
+  static constexpr size_t MAX_SIZE = LAYOUT.maxSize;
+
+  template <NameTag Name>
+  static constexpr size_t INDEX = indexOf<Name>();
+
+  // Run-time name lookup: FIELD_NAMES.find(name) is the declaration index, FIELD_CNT if unknown.
+  static constexpr PerfectHash<FIELD_CNT> FIELD_NAMES {fieldNames(std::make_index_sequence<FIELD_CNT>{})};
+
+  template <NameTag Name>
+  using Field = mp_at_c<FieldList, INDEX<Name>>;
+
+  template <NameTag Name>
+  static constexpr bool IS_TAIL = LAYOUT.placement[INDEX<Name>] == TAIL;
+
+  template <NameTag Name>
+  static constexpr bool IS_OPTIONAL = detail::is_optional_v<Field<Name>>;
+
+  template <NameTag Name>
+  static constexpr bool IS_FIXED = LAYOUT.placement[INDEX<Name>] == FIXED;
+
+  template <NameTag Name>
+  requires (IS_FIXED<Name>)
+  static constexpr size_t OFFSET = LAYOUT.offset[INDEX<Name>];
+
+  // Wire size of the message at msg.
+  static size_t size(const std::byte* msg) {
+    return Reader(msg).size();
+  }
+
+  template <NameTag Name>
+  static bool has(const std::byte* msg) {
+    static_assert(INDEX<Name> < FIELD_CNT, "no such field");
+    if constexpr (IS_OPTIONAL<Name>) {
+      return present(loadBitmap(msg), INDEX<Name>);
+    } else {
+      return true;
+    }
+  }
+
+  template <NameTag Name>
+  static auto get(const std::byte* msg) {
+    static_assert(INDEX<Name> < FIELD_CNT, "no such field");
+    return Reader(msg).template get<Name>();
+  }
+
+  // Fixed fields only (including SLOT optional ones, which become present); the others are
+  // written in order through a Writer.
+  template <NameTag Name, typename Type>
+  static void set(std::byte* msg, Type&& value) {
+    static_assert(INDEX<Name> < FIELD_CNT, "no such field");
+    static_assert(IS_FIXED<Name>, "packed and variable-length fields are written with a Writer");
+    detail::unwrap_t<Field<Name>>::set(msg + OFFSET<Name>, std::forward<Type>(value));
+    if constexpr (IS_OPTIONAL<Name>) {
+      storeBitmap(msg, loadBitmap(msg) | (uint64_t{1} << LAYOUT.bit[INDEX<Name>]));
+    }
+  }
+
+  // Marks a SLOT optional field absent.
+  template <NameTag Name>
+  static void clear(std::byte* msg) {
+    static_assert(IS_FIXED<Name> && IS_OPTIONAL<Name>, "only slotted optional fields are cleared in place");
+    storeBitmap(msg, loadBitmap(msg) & ~(uint64_t{1} << LAYOUT.bit[INDEX<Name>]));
+  }
+
+  /**
+   * Cursor: forward-only walk over the packed optional and tail fields.
+   * - Reader: get<Name>() for any field; packed optional fields are located from the bitmap,
+   *   tail fields must be asked for in declaration order.
+   * - Writer: set<Name>() / opaque<Name>() write packed optional and tail fields in declaration
+   *   order and maintain their presence bits; optional fields not written are absent, mandatory
+   *   tail fields not written are empty. size() completes the message and returns its wire size.
+   *   A Writer starts a message with no optional field present; fixed fields are set through
+   *   NamedMessageType::set once it exists.
+   */
+  template <bool READONLY>
+  class Cursor {
+  public:
+    using pointer_type = std::conditional_t<READONLY, const std::byte*, std::byte*>;
+
+    explicit Cursor(pointer_type msg) : _msg(msg), _ptr(msg + FIXED_SIZE), _bitmap(loadBitmap(msg)) {
+      if constexpr (READONLY) {
+        _ptr += sparseSize(_bitmap, ~uint64_t{0});
+        _index = FIXED_CNT;
+      }
+      else {
+        _bitmap = 0;
+        storeBitmap(_msg, _bitmap);
+      }
+    }
+
+    template <NameTag Name>
+    auto get() {
+      static_assert(INDEX<Name> < FIELD_CNT, "no such field");
+      constexpr size_t I = INDEX<Name>;
+      using FieldType = Field<Name>;
+      using ValueType = decltype(detail::view<FieldType>(nullptr));
+      const std::byte* ptr;
+      if constexpr (LAYOUT.placement[I] == FIXED) {
+        ptr = _msg + LAYOUT.offset[I];
+      } else if constexpr (LAYOUT.placement[I] == SPARSE) {
+        ptr = _msg + FIXED_SIZE + sparseSize(_bitmap, (uint64_t{1} << LAYOUT.bit[I]) - 1);
+      } else {
+        seek(I);
+        ptr = _ptr;
+      }
+      if constexpr (IS_OPTIONAL<Name>) {
+        return present(_bitmap, I) ? std::optional<ValueType>(detail::view<FieldType>(ptr)) : std::nullopt;
+      } else {
+        return detail::view<FieldType>(ptr);
+      }
+    }
+
+    // Packed optional Numeric, Enum or PaddedString fields.
+    template <NameTag Name, typename Type>
+    requires (!READONLY && LAYOUT.placement[INDEX<Name>] == SPARSE)
+    void set(Type&& value) {
+      seek(INDEX<Name>);
+      detail::unwrap_t<Field<Name>>::set(_ptr, std::forward<Type>(value));
+      written<Name>();
+    }
+
+    // Variable-length strings; truncated to the field's capacity.
+    template <NameTag Name>
+    requires (!READONLY && detail::is_tail_string_v<Field<Name>>)
+    void set(std::string_view value) {
+      using ValueField = detail::unwrap_t<Field<Name>>;
+      seek(INDEX<Name>);
+      if constexpr (std::is_same_v<QueryTrait<ValueField>, trait::PrefixedString>) {
+        ValueField::set(_ptr, value);
+      } else {
+        const size_t len = std::min(value.size(), ValueField::SIZE);
+        std::memcpy(_ptr, value.data(), len);
+        if (len < ValueField::SIZE) {
+          _ptr[len] = std::byte{0};
+        }
+      }
+      written<Name>();
+    }
+
+    // Editor over the field's slot; the payload may be filled until the next field is touched.
+    template <NameTag Name>
+    typename detail::unwrap_t<Field<Name>>::Editor opaque() requires (!READONLY) {
+      static_assert(INDEX<Name> < FIELD_CNT, "no such field");
+      static_assert(std::is_same_v<QueryTrait<detail::unwrap_t<Field<Name>>>, trait::Opaque>, "not an opaque field");
+      seek(INDEX<Name>);
+      written<Name>();
+      return typename detail::unwrap_t<Field<Name>>::Editor(_ptr);
+    }
+
+    size_t size() {
+      seek(FIELD_CNT);
+      return static_cast<size_t>(_ptr - _msg);
+    }
+
+  private:
+    template <NameTag Name>
+    void written() {
+      _written = true;
+      if constexpr (IS_OPTIONAL<Name>) {
+        // reload: slotted optional fields may have been set in place since the last write
+        _bitmap = loadBitmap(_msg) | (uint64_t{1} << LAYOUT.bit[INDEX<Name>]);
+        storeBitmap(_msg, _bitmap);
+      }
+    }
+
+    void seek(size_t index) {
+      if (index < _index) [[unlikely]] {
+        throw std::logic_error("NamedMessageType: packed and tail fields are accessed in declaration order");
+      }
+      for (; _index < index; ++_index) {
+        if (LAYOUT.placement[_index] == FIXED) {
+          continue;
+        }
+        if constexpr (!READONLY) {
+          const bool written = _written;
+          _written = false;
+          if (!written) {
+            if (LAYOUT.bit[_index] != NO_BIT) {
+              continue; // absent
+            }
+            TAIL_CLEAR[_index](_ptr);
+          }
+        }
+        else if (!present(_bitmap, _index)) {
+          continue;
+        }
+        _ptr += WIRE_SIZE[_index](_ptr);
+      }
+    }
+
+    pointer_type const _msg;
+    pointer_type _ptr;
+    uint64_t _bitmap;
+    size_t _index = 0;
+    bool _written = false;
+  };
+
+  using Reader = Cursor<true>;
+  using Writer = Cursor<false>;
+
+  // Calls fn(std::type_identity<FieldType>{}, ptr) for every field in declaration order;
+  // ptr is nullptr for absent optional fields.
+  template <typename Fn>
+  static void forEach(const std::byte* msg, Fn&& fn) {
+    const uint64_t bitmap = loadBitmap(msg);
+    const std::byte* packed = msg + FIXED_SIZE;
+    mp_for_each<mp_iota_c<FIELD_CNT>>([&] (auto I) {
+      using FieldType = mp_at_c<FieldList, I>;
+      if (!present(bitmap, I)) {
+        fn(std::type_identity<FieldType>{}, static_cast<const std::byte*>(nullptr));
+      } else if constexpr (LAYOUT.placement[I] == FIXED) {
+        fn(std::type_identity<FieldType>{}, msg + LAYOUT.offset[I]);
+      } else {
+        fn(std::type_identity<FieldType>{}, packed);
+        packed += detail::wireSize<FieldType>(packed);
+      }
+    });
+  }
+};
+
+} // namespace hw::type::beacon
+// --- END FILE: include/hw/type/beacon/Message.hpp ---
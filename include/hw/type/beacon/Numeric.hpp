@@ -12,11 +12,14 @@
 #include <bit>
 #include <string_view>
 #include <cstring>
+#include <charconv>
+#include <system_error>
 
 #include <boost/multiprecision/cpp_int.hpp>
 #include <hw/type/NameTag.hpp>
 #include <hw/type/TypeInfo.hpp>
 #include <hw/utility/Text.hpp>
+#include <hw/utility/Hex.hpp>
 #include <hw/utility/Format.hpp>
 #include <hw/type/beacon/TypeTraits.hpp>
 
@@ -68,9 +71,21 @@ struct NamedNumericType {
 
   /**
    * String-based Write: For JSON/Tests. Handles "A", "0x41", or "65".
+   * Numbers are parsed straight from the view; only time types build a std::string.
    */
   static void set(std::byte* ptr, std::string_view val) {
-    set(ptr, hw::utility::fromString<ValueType>(std::string(val)));
+    if constexpr (std::is_same_v<ValueType, char>) {
+      set(ptr, val.size() == 1 ? val[0] : static_cast<char>(hw::utility::fromChars<uint8_t>(val)));
+    }
+    else if constexpr (std::is_enum_v<ValueType>) {
+      set(ptr, static_cast<ValueType>(hw::utility::fromChars<std::underlying_type_t<ValueType>>(val)));
+    }
+    else if constexpr (std::is_integral_v<ValueType> || std::is_floating_point_v<ValueType> || LongNumericType<ValueType>) {
+      set(ptr, hw::utility::fromChars<ValueType>(val));
+    }
+    else {
+      set(ptr, hw::utility::fromString<ValueType>(std::string(val)));
+    }
   }
 
   /**
@@ -82,33 +97,83 @@ struct NamedNumericType {
     return v;
   }
 
+  // Longest text toChars produces for any ValueType.
+  static constexpr size_t MAX_CHARS = 64;
+
   /**
-   * Isomorphic toString: Optimized for JSON test cases.
+   * Allocation-free formatting into [first, last), std::to_chars style: on success ec is
+   * std::errc{} and ptr is the end of the text; a short buffer gives value_too_large.
    */
-  static std::string toString(const std::byte* ptr) {
+  static std::to_chars_result toChars(const std::byte* ptr, char* first, char* last) {
     ValueType val = get(ptr);
 
     if constexpr (std::is_same_v<ValueType, char>) {
       if (std::isalnum(static_cast<unsigned char>(val))) {
-        return frmt::format("{}", static_cast<char>(val));
+        if (first == last) return {last, std::errc::value_too_large};
+        *first = val;
+        return {first + 1, std::errc{}};
       }
-      return frmt::format("0x{:02x}", static_cast<uint8_t>(val));
+      return hexByte(static_cast<uint8_t>(val), first, last);
     }
     else if constexpr (sizeof(ValueType) == 1 && std::is_integral_v<ValueType>) {
-      return frmt::format("0x{:02x}", static_cast<uint8_t>(val));
+      return hexByte(static_cast<uint8_t>(val), first, last);
     }
     else if constexpr (LongNumericType<ValueType>) {
-      std::ostringstream oss;
-      oss << val;
-      return oss.str();
+      return longToChars(val, first, last);
     }
     else if constexpr (std::is_enum_v<ValueType>) {
-      return frmt::format("{}", static_cast<std::underlying_type_t<ValueType>>(val));
+      return std::to_chars(first, last, static_cast<std::underlying_type_t<ValueType>>(val));
+    }
+    else if constexpr (std::is_integral_v<ValueType> || std::is_floating_point_v<ValueType>) {
+      return std::to_chars(first, last, val);
     }
     else {
-      return frmt::format("{}", val);
+      const auto result = frmt::format_to_n(first, static_cast<size_t>(last - first), "{}", val);
+      if (result.size > static_cast<size_t>(last - first)) return {last, std::errc::value_too_large};
+      return {result.out, std::errc{}};
     }
   }
+
+  /**
+   * Isomorphic toString: Optimized for JSON test cases.
+   */
+  static std::string toString(const std::byte* ptr) {
+    char buf[MAX_CHARS];
+    const auto result = toChars(ptr, buf, buf + MAX_CHARS);
+    return std::string(buf, result.ptr);
+  }
+
+private:
+  static std::to_chars_result hexByte(uint8_t byte, char* first, char* last) noexcept {
+    if (last - first < 4) return {last, std::errc::value_too_large};
+    first[0] = '0';
+    first[1] = 'x';
+    hw::utility::hexEncode(&byte, 1, first + 2);
+    return {first + 4, std::errc{}};
+  }
+
+  // Digits in 19-digit chunks so that only one 128-bit division runs per chunk.
+  static std::to_chars_result longToChars(ValueType val, char* first, char* last) noexcept {
+    constexpr uint64_t CHUNK = 10'000'000'000'000'000'000ull;
+    const bool negative = val < 0;
+    __uint128_t u = negative ? -static_cast<__uint128_t>(val) : static_cast<__uint128_t>(val);
+    char digits[40];
+    char* p = digits + sizeof(digits);
+    do {
+      uint64_t part = static_cast<uint64_t>(u % CHUNK);
+      u /= CHUNK;
+      for (int i = 0; i < 19 && (part || u); ++i) {
+        *--p = static_cast<char>('0' + part % 10);
+        part /= 10;
+      }
+    } while (u);
+    if (p == digits + sizeof(digits)) *--p = '0';
+    if (negative) *--p = '-';
+    const size_t len = static_cast<size_t>(digits + sizeof(digits) - p);
+    if (static_cast<size_t>(last - first) < len) return {last, std::errc::value_too_large};
+    std::memcpy(first, p, len);
+    return {first + len, std::errc{}};
+  }
 };
 
 } // namespace hw::type::beacon
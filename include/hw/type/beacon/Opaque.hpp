@@ -7,9 +7,11 @@
 #include <string_view>
 #include <algorithm>
 #include <concepts>
+#include <cctype>
+#include <stdexcept>
 
 #include <hw/utility/Text.hpp>
-#include <hw/utility/Format.hpp>
+#include <hw/utility/Hex.hpp>
 #include <hw/type/beacon/TypeTraits.hpp>
 #include <hw/type/beacon/Beacon.hpp>
 
@@ -80,28 +82,45 @@ public:
     setPayloadSize(len);
   }
 
+  // Copies raw bytes as the payload, truncated to MAX_PAYLOAD_SIZE
+  void assign(const void* src, size_t len) requires (!READONLY) {
+    len = std::min(len, MAX_PAYLOAD_SIZE);
+    std::memcpy(head(), src, len);
+    setPayloadSize(len);
+  }
+
   // Parses hex representation (supports 0x prefix and spaces)
   void fromString(std::string_view hex_str) requires (!READONLY) {
-    std::string clean = hw::utility::trim(std::string(hex_str));
+    auto isSpace = [] (char c) { return std::isspace(static_cast<unsigned char>(c)) != 0; };
+    while (!hex_str.empty() && isSpace(hex_str.front())) hex_str.remove_prefix(1);
+    while (!hex_str.empty() && isSpace(hex_str.back())) hex_str.remove_suffix(1);
 
     // Skip 0x if present
-    size_t offset = 0;
-    if (clean.size() >= 2 && clean[0] == '0' && (clean[1] == 'x' || clean[1] == 'X')) {
-      offset = 2;
+    if (hex_str.size() >= 2 && hex_str[0] == '0' && (hex_str[1] == 'x' || hex_str[1] == 'X')) {
+      hex_str.remove_prefix(2);
     }
 
     std::byte* dst = head();
     size_t bytes_written = 0;
 
-    for (size_t i = offset; i + 1 < clean.size() && bytes_written < MAX_PAYLOAD_SIZE; ) {
-      if (std::isspace(static_cast<unsigned char>(clean[i]))) {
-        i++;
-        continue;
-      }
+    // Common case: one run of digits, decoded in a single pass
+    size_t pairs = std::min(hex_str.size() / 2, MAX_PAYLOAD_SIZE);
+    if (hw::utility::hexDecode(hex_str.data(), pairs, dst)) {
+      setPayloadSize(pairs);
+      return;
+    }
 
-      char hi = clean[i++];
-      char lo = clean[i++];
-      dst[bytes_written++] = static_cast<std::byte>((hw::utility::toNibble(hi) << 4) | hw::utility::toNibble(lo));
+    // Digits separated by whitespace: decode run by run, a pair may not straddle a gap
+    while (!hex_str.empty() && bytes_written < MAX_PAYLOAD_SIZE) {
+      const size_t run = static_cast<size_t>(std::find_if(hex_str.begin(), hex_str.end(), isSpace) - hex_str.begin());
+      pairs = std::min(run / 2, MAX_PAYLOAD_SIZE - bytes_written);
+      if (!hw::utility::hexDecode(hex_str.data(), pairs, dst + bytes_written) ||
+          (run % 2 && run < hex_str.size() && pairs == run / 2)) {
+        throw std::invalid_argument("Invalid hex character");
+      }
+      bytes_written += pairs;
+      hex_str.remove_prefix(run);
+      while (!hex_str.empty() && isSpace(hex_str.front())) hex_str.remove_prefix(1);
     }
     setPayloadSize(bytes_written);
   }
@@ -110,18 +129,15 @@ public:
    * Observers
    */
 
+  // Writes 2 * payloadSize() hex digits to dst (no 0x prefix, no terminator); returns the end
+  char* toChars(char* dst) const {
+    return hw::utility::hexEncode(head(), payloadSize(), dst);
+  }
+
   // Returns hex representation without 0x prefix
   std::string toString() const {
-    size_t len = payloadSize();
-    if (len == 0) return "";
-
-    const uint8_t* src = reinterpret_cast<const uint8_t*>(head());
-    std::string res;
-    res.reserve(len * 2);
-
-    for (size_t i = 0; i < len; ++i) {
-      res += frmt::format("{:02x}", src[i]);
-    }
+    std::string res(payloadSize() * 2, '\0');
+    toChars(res.data());
     return res;
   }
 
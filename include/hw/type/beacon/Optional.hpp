@@ -0,0 +1,30 @@
+// --- START FILE: include/hw/type/beacon/Optional.hpp ---
+#pragma once
+
+#include <hw/type/NameTag.hpp>
+#include <hw/type/beacon/TypeTraits.hpp>
+
+namespace hw::type::beacon {
+
+/**
+ * Wire placement of an absent optional field:
+ * - SKIP: takes no bytes; present fixed-size fields are packed after the fixed block and
+ *   located from the presence bitmap.
+ * - SLOT: keeps its fixed offset whether present or not (cheap random access, no shifting).
+ * Variable-length optional fields (VarString, PrefixedString, Opaque) take no bytes when absent either way.
+ */
+enum class OptionalPolicy {
+  SKIP,
+  SLOT
+};
+
+template <OptionalFieldType FieldType, OptionalPolicy Policy = OptionalPolicy::SKIP>
+struct Optional {
+  using type_trait = trait::Optional;
+  using field_type = FieldType;
+  static constexpr OptionalPolicy policy = Policy;
+  static constexpr auto name_tag = FieldType::name_tag;
+};
+
+} // namespace hw::type::beacon
+// --- END FILE: include/hw/type/beacon/Optional.hpp ---
@@ -0,0 +1,475 @@
+// --- START FILE: include/hw/type/beacon/Schema.hpp ---
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <hw/type/NameTag.hpp>
+#include <hw/type/TypeInfo.hpp>
+#include <hw/type/TypeList.hpp>
+#include <hw/type/beacon/TypeTraits.hpp>
+#include <hw/type/beacon/Optional.hpp>
+#include <hw/type/beacon/Message.hpp>
+
+namespace hw::type::beacon {
+
+/**
+ * Result of comparing the layout compiled into this binary with a recorded one:
+ * - IDENTICAL: same signature.
+ * - READABLE: the current layout reads recorded-layout messages as they are. It only adds
+ *   optional fields that take no bytes when absent (SKIP policy or variable-length), after every
+ *   recorded optional field, without growing the presence bitmap.
+ * - INCOMPATIBLE: anything else (reordered, resized, removed or mandatory new fields); reason
+ *   names the first difference. Such data is read through a MessageAdapter.
+ */
+enum class Compatibility {
+  IDENTICAL,
+  READABLE,
+  INCOMPATIBLE
+};
+
+struct SchemaCheck {
+  Compatibility result;
+  std::string reason;
+
+  explicit operator bool() const noexcept { return result != Compatibility::INCOMPATIBLE; }
+};
+
+struct FieldSchema {
+  std::string name;
+  std::string kind;       // Numeric, Enum, PaddedString, VarString, PrefixedString or Opaque
+  size_t size = 0;        // wire size; payload capacity for Opaque
+  std::string presence;   // required, skip or slot
+  std::string valueType;  // C++ value type of Numeric and Enum fields
+
+  bool optional() const noexcept { return presence != "required"; }
+  bool takesNoBytesWhenAbsent() const noexcept { return presence == "skip" || kind == "VarString" || kind == "PrefixedString" || kind == "Opaque"; }
+  bool operator == (const FieldSchema&) const = default;
+};
+
+struct MessageSchema {
+  std::string name;
+  uint64_t signature = 0;
+  std::vector<FieldSchema> fields;
+};
+
+// One entry of an ether message list.
+struct EtherTypeSchema {
+  std::string name;
+  size_t size = 0;
+  uint64_t signature = 0;
+
+  bool operator == (const EtherTypeSchema&) const = default;
+};
+
+struct EtherSchema {
+  std::string name;
+  uint64_t signature = 0;
+  size_t capacity = 0;
+  size_t slotSize = 0;
+  std::vector<EtherTypeSchema> types;
+};
+
+namespace detail {
+  template <typename FieldType>
+  constexpr std::string_view schemaKind() {
+    using Trait = QueryTrait<FieldType>;
+    if constexpr (std::is_same_v<Trait, trait::Numeric>) return "Numeric";
+    else if constexpr (std::is_same_v<Trait, trait::Enum>) return "Enum";
+    else if constexpr (std::is_same_v<Trait, trait::PaddedString>) return "PaddedString";
+    else if constexpr (std::is_same_v<Trait, trait::VarString>) return "VarString";
+    else if constexpr (std::is_same_v<Trait, trait::PrefixedString>) return "PrefixedString";
+    else return "Opaque";
+  }
+
+  // Element term of TypeListSignature, for a single message type of an ether list.
+  template <typename Type>
+  constexpr uint64_t typeSignature() {
+    return (0xcbf29ce484222325 ^ TypeInfo<Type>::name_hash ^ (sizeof(Type) << 1)) * 0x100000001b3;
+  }
+}
+
+template <typename MessageType>
+MessageSchema describeMessage() {
+  MessageSchema schema {std::string(MessageType::name_tag.toString()), MessageType::SIGNATURE, {}};
+  mp_for_each<mp_iota_c<MessageType::FIELD_CNT>>([&] (auto I) {
+    using FieldType = mp_at_c<typename MessageType::field_list, I>;
+    using ValueField = detail::unwrap_t<FieldType>;
+    FieldSchema field;
+    field.name = std::string(FieldType::name_tag.toString());
+    field.kind = std::string(detail::schemaKind<ValueField>());
+    if constexpr (std::is_same_v<QueryTrait<ValueField>, trait::Opaque>) {
+      field.size = ValueField::MAX_PAYLOAD_SIZE;
+    } else {
+      field.size = ValueField::SIZE;
+    }
+    if constexpr (detail::is_optional_v<FieldType>) {
+      field.presence = FieldType::policy == OptionalPolicy::SLOT ? "slot" : "skip";
+    } else {
+      field.presence = "required";
+    }
+    if constexpr (std::is_same_v<QueryTrait<ValueField>, trait::Numeric> || std::is_same_v<QueryTrait<ValueField>, trait::Enum>) {
+      field.valueType = std::string(TypeInfo<typename ValueField::value_type>::name());
+    }
+    schema.fields.push_back(std::move(field));
+  });
+  return schema;
+}
+
+template <typename EtherType>
+EtherSchema describeEther() {
+  using MsgList = typename EtherType::MsgList;
+  EtherSchema schema {std::string(TypeName<EtherType>()), EtherType::MSG_LIST_SIGNATURE,
+                      static_cast<size_t>(EtherType::CAPACITY), EtherType::SLOT_SIZE, {}};
+  mp_for_each<mp_iota_c<mp_size<MsgList>::value>>([&] (auto I) {
+    using Type = mp_at_c<MsgList, I>;
+    schema.types.push_back({std::string(TypeName<Type>()), sizeof(Type), detail::typeSignature<Type>()});
+  });
+  return schema;
+}
+
+// Can messages recorded with `recorded` be read in place with the `current` layout?
+inline SchemaCheck checkMessage(const MessageSchema& recorded, const MessageSchema& current) {
+  if (recorded.signature == current.signature) {
+    return {Compatibility::IDENTICAL, {}};
+  }
+  auto incompatible = [] (std::string reason) { return SchemaCheck {Compatibility::INCOMPATIBLE, std::move(reason)}; };
+  auto optionalCnt = [] (const MessageSchema& schema) {
+    return std::count_if(schema.fields.begin(), schema.fields.end(), [] (const FieldSchema& f) { return f.optional(); });
+  };
+  if ((optionalCnt(recorded) + 7) / 8 != (optionalCnt(current) + 7) / 8) {
+    return incompatible("presence bitmap size changes");
+  }
+
+  size_t next = 0; // next recorded field
+  size_t recordedOptionals = 0;
+  for (const FieldSchema& field : current.fields) {
+    if (next < recorded.fields.size() && recorded.fields[next].name == field.name) {
+      if (!(recorded.fields[next] == field)) {
+        return incompatible("field " + field.name + " changes type, size or presence");
+      }
+      recordedOptionals += field.optional();
+      ++next;
+      continue;
+    }
+    const bool known = std::any_of(recorded.fields.begin(), recorded.fields.end(),
+                                   [&] (const FieldSchema& f) { return f.name == field.name; });
+    if (known) {
+      return incompatible("field " + field.name + " is reordered");
+    }
+    if (!field.optional() || !field.takesNoBytesWhenAbsent()) {
+      return incompatible("added field " + field.name + " takes bytes when absent");
+    }
+    if (recordedOptionals < static_cast<size_t>(optionalCnt(recorded))) {
+      return incompatible("added field " + field.name + " shifts presence bits of recorded fields");
+    }
+  }
+  if (next < recorded.fields.size()) {
+    return incompatible("field " + recorded.fields[next].name + " is removed or reordered");
+  }
+  return {Compatibility::READABLE, {}};
+}
+
+/**
+ * Ethers: IDENTICAL with the same message list; READABLE when the recorded list is a prefix of
+ * the current one with the same slot size and capacity. That is the case Ether::initialize
+ * accepts, so a rebuilt binary can attach to an ether created by an older one (and must only
+ * publish the recorded types while older binaries are attached).
+ */
+inline SchemaCheck checkEther(const EtherSchema& recorded, const EtherSchema& current) {
+  if (recorded.signature == current.signature && recorded.capacity == current.capacity) {
+    return {Compatibility::IDENTICAL, {}};
+  }
+  auto incompatible = [] (std::string reason) { return SchemaCheck {Compatibility::INCOMPATIBLE, std::move(reason)}; };
+  if (recorded.capacity != current.capacity) {
+    return incompatible("capacity changes");
+  }
+  if (recorded.slotSize != current.slotSize) {
+    return incompatible("slot size changes");
+  }
+  if (recorded.types.size() > current.types.size() ||
+      !std::equal(recorded.types.begin(), recorded.types.end(), current.types.begin())) {
+    return incompatible("recorded message list is not a prefix of the current one");
+  }
+  return {Compatibility::READABLE, {}};
+}
+
+/**
+ * SchemaRegistry: recorded layouts of named beacon messages and ether message lists.
+ * - Built from the types compiled into a binary (add) and persisted as a line-based text file
+ *   (save/load) next to the ethers and journals it describes.
+ * - A new binary loads the file, checks its own types against it before attaching, then
+ *   records them for the next one.
+ * - generate() writes the C++ declaration of a recorded message layout, to be compiled in and
+ *   read through MessageAdapter when the layouts are incompatible.
+ */
+class SchemaRegistry {
+public:
+  template <typename MessageType>
+  void addMessage() {
+    put(_messages, describeMessage<MessageType>());
+  }
+
+  template <typename EtherType>
+  void addEther() {
+    put(_ethers, describeEther<EtherType>());
+  }
+
+  const MessageSchema* findMessage(std::string_view name) const noexcept { return find(_messages, name); }
+  const EtherSchema* findEther(std::string_view name) const noexcept { return find(_ethers, name); }
+
+  const std::vector<MessageSchema>& messages() const noexcept { return _messages; }
+  const std::vector<EtherSchema>& ethers() const noexcept { return _ethers; }
+
+  // The compiled layout against the recorded one; IDENTICAL when nothing is recorded yet.
+  template <typename MessageType>
+  SchemaCheck checkMessage() const {
+    const MessageSchema* recorded = findMessage(MessageType::name_tag.toString());
+    return recorded ? beacon::checkMessage(*recorded, describeMessage<MessageType>()) : SchemaCheck {Compatibility::IDENTICAL, {}};
+  }
+
+  template <typename EtherType>
+  SchemaCheck checkEther() const {
+    const EtherSchema* recorded = findEther(TypeName<EtherType>());
+    return recorded ? beacon::checkEther(*recorded, describeEther<EtherType>()) : SchemaCheck {Compatibility::IDENTICAL, {}};
+  }
+
+  std::string generate(std::string_view name, std::string_view alias) const {
+    const MessageSchema* schema = findMessage(name);
+    if (!schema) {
+      throw std::invalid_argument("SchemaRegistry: no message " + std::string(name));
+    }
+    std::ostringstream oss;
+    oss << "using " << alias << " = hw::type::beacon::NamedMessageType<\"" << schema->name << "\", hw::type::type_list<";
+    const char* separator = "\n";
+    for (const FieldSchema& field : schema->fields) {
+      oss << separator << "    ";
+      if (field.optional()) {
+        oss << "hw::type::beacon::Optional<";
+      }
+      oss << "hw::type::beacon::";
+      if (field.kind == "Numeric") oss << "NamedNumericType<\"" << field.name << "\", " << field.valueType << ">";
+      else if (field.kind == "Enum") oss << "NamedEnumType<\"" << field.name << "\", " << field.valueType << ">";
+      else if (field.kind == "PaddedString") oss << "NamedFixedStringType<\"" << field.name << "\", " << field.size << ">";
+      else if (field.kind == "VarString") oss << "NamedVariableStringType<\"" << field.name << "\", " << field.size << ">";
+      else if (field.kind == "PrefixedString") oss << "NamedPrefixedStringType<\"" << field.name << "\", " << field.size << ">";
+      else oss << "NamedOpaqueType<\"" << field.name << "\", " << field.size << ">";
+      if (field.presence == "slot") {
+        oss << ", hw::type::beacon::OptionalPolicy::SLOT>";
+      } else if (field.optional()) {
+        oss << ">";
+      }
+      separator = ",\n";
+    }
+    oss << "\n>>;\n";
+    return oss.str();
+  }
+
+  /**
+   * File format, one record per line; names and value types run to the end of the line:
+   *   message <signature> <field count> <name>
+   *   field <kind> <size> <presence> <name> [<value type>]   (tab before the value type)
+   *   ether <signature> <capacity> <slot size> <type count> <name>
+   *   type <size> <signature> <name>
+   */
+  void save(const std::string& path) const {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) {
+      throw std::invalid_argument("SchemaRegistry: cannot write " + path);
+    }
+    out << std::hex;
+    for (const MessageSchema& message : _messages) {
+      out << "message " << message.signature << ' ' << message.fields.size() << ' ' << message.name << '\n';
+      for (const FieldSchema& field : message.fields) {
+        out << "field " << field.kind << ' ' << field.size << ' ' << field.presence << ' ' << field.name;
+        if (!field.valueType.empty()) {
+          out << '\t' << field.valueType;
+        }
+        out << '\n';
+      }
+    }
+    for (const EtherSchema& ether : _ethers) {
+      out << "ether " << ether.signature << ' ' << ether.capacity << ' ' << ether.slotSize << ' ' << ether.types.size() << ' ' << ether.name << '\n';
+      for (const EtherTypeSchema& type : ether.types) {
+        out << "type " << type.size << ' ' << type.signature << ' ' << type.name << '\n';
+      }
+    }
+  }
+
+  static SchemaRegistry load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+      throw std::invalid_argument("SchemaRegistry: cannot read " + path);
+    }
+    SchemaRegistry registry;
+    std::string line;
+    size_t pending = 0; // field or type lines still expected by the current record
+    while (std::getline(in, line)) {
+      if (line.empty()) continue;
+      std::istringstream iss(line);
+      iss >> std::hex;
+      std::string record;
+      iss >> record;
+      if (record == "message") {
+        MessageSchema message;
+        iss >> message.signature >> pending;
+        message.name = rest(iss);
+        registry._messages.push_back(std::move(message));
+      }
+      else if (record == "field" && pending && !registry._messages.empty()) {
+        FieldSchema field;
+        iss >> field.kind >> field.size >> field.presence;
+        std::string tail = rest(iss);
+        const size_t tab = tail.find('\t');
+        field.name = tail.substr(0, tab);
+        if (tab != std::string::npos) {
+          field.valueType = tail.substr(tab + 1);
+        }
+        registry._messages.back().fields.push_back(std::move(field));
+        --pending;
+      }
+      else if (record == "ether") {
+        EtherSchema ether;
+        iss >> ether.signature >> ether.capacity >> ether.slotSize >> pending;
+        ether.name = rest(iss);
+        registry._ethers.push_back(std::move(ether));
+      }
+      else if (record == "type" && pending && !registry._ethers.empty()) {
+        EtherTypeSchema type;
+        iss >> type.size >> type.signature;
+        type.name = rest(iss);
+        registry._ethers.back().types.push_back(std::move(type));
+        --pending;
+      }
+      else {
+        throw std::invalid_argument("SchemaRegistry: bad record in " + path + ": " + line);
+      }
+      if (!iss && !iss.eof()) {
+        throw std::invalid_argument("SchemaRegistry: bad record in " + path + ": " + line);
+      }
+    }
+    if (pending) {
+      throw std::invalid_argument("SchemaRegistry: truncated " + path);
+    }
+    return registry;
+  }
+
+private:
+  static std::string rest(std::istringstream& iss) {
+    std::string text;
+    std::getline(iss >> std::ws, text);
+    return text;
+  }
+
+  template <typename Schema>
+  static void put(std::vector<Schema>& schemas, Schema&& schema) {
+    auto it = std::find_if(schemas.begin(), schemas.end(), [&] (const Schema& s) { return s.name == schema.name; });
+    if (it != schemas.end()) {
+      *it = std::move(schema);
+    } else {
+      schemas.push_back(std::move(schema));
+    }
+  }
+
+  template <typename Schema>
+  static const Schema* find(const std::vector<Schema>& schemas, std::string_view name) noexcept {
+    auto it = std::find_if(schemas.begin(), schemas.end(), [&] (const Schema& s) { return s.name == name; });
+    return it != schemas.end() ? &*it : nullptr;
+  }
+
+  std::vector<MessageSchema> _messages;
+  std::vector<EtherSchema> _ethers;
+};
+
+/**
+ * MessageAdapter: reads messages written with layout From through layout To.
+ * - DIRECT when the layouts match or To only adds fields that are absent from From-layout
+ *   messages (the READABLE rule, checked at compile time): view() returns the input, no copy.
+ * - Otherwise convert() copies the fields both layouts name, in To's declaration order;
+ *   numbers are converted, strings and Opaque payloads truncated to To's capacity, fields
+ *   unknown to From are absent (or zero when mandatory).
+ */
+template <typename From, typename To>
+class MessageAdapter {
+  using FromList = typename From::field_list;
+  using ToList = typename To::field_list;
+
+  static constexpr bool direct() {
+    if (From::SIGNATURE == To::SIGNATURE) return true;
+    if (From::BITMAP_SIZE != To::BITMAP_SIZE) return false;
+    bool ok = true;
+    size_t next = 0;
+    size_t optionals = 0;
+    mp_for_each<mp_iota_c<To::FIELD_CNT>>([&] (auto I) {
+      using ToField = mp_at_c<ToList, I>;
+      constexpr size_t J = From::FIELD_NAMES.find(ToField::name_tag.toString());
+      if constexpr (J < From::FIELD_CNT) {
+        ok = ok && J == next && std::is_same_v<ToField, mp_at_c<FromList, J>>;
+        optionals += detail::is_optional_v<ToField>;
+        ++next;
+      } else {
+        constexpr bool noBytes = detail::is_optional_v<ToField> && (detail::Unwrap<ToField>::skip || detail::is_tail_field_v<ToField>);
+        ok = ok && noBytes && optionals == From::OPTIONAL_CNT;
+      }
+    });
+    return ok && next == From::FIELD_CNT;
+  }
+
+public:
+  static constexpr bool DIRECT = direct();
+
+  // Returns a To-layout view of msg: msg itself when DIRECT, else scratch (To::MAX_SIZE bytes).
+  static const std::byte* view(const std::byte* msg, std::byte* scratch) {
+    if constexpr (DIRECT) {
+      return msg;
+    } else {
+      convert(msg, scratch);
+      return scratch;
+    }
+  }
+
+  // Writes the To-layout copy of msg; returns its wire size.
+  static size_t convert(const std::byte* msg, std::byte* out) {
+    std::array<const std::byte*, From::FIELD_CNT> fields {};
+    From::forEach(msg, [&] <typename FieldType> (std::type_identity<FieldType>, const std::byte* ptr) {
+      fields[From::template INDEX<FieldType::name_tag>] = ptr;
+    });
+
+    std::memset(out, 0, To::FIXED_SIZE);
+    typename To::Writer writer(out);
+    mp_for_each<mp_iota_c<To::FIELD_CNT>>([&] (auto I) {
+      using ToField = mp_at_c<ToList, I>;
+      constexpr auto Name = ToField::name_tag;
+      constexpr size_t J = From::FIELD_NAMES.find(Name.toString());
+      if constexpr (J < From::FIELD_CNT) {
+        using FromValue = detail::unwrap_t<mp_at_c<FromList, J>>;
+        using ToValue = detail::unwrap_t<ToField>;
+        static_assert(std::is_same_v<QueryTrait<FromValue>, QueryTrait<ToValue>>, "a field kept by name keeps its kind");
+        const std::byte* ptr = fields[J];
+        if (!ptr) return;
+        if constexpr (std::is_same_v<QueryTrait<ToValue>, trait::Opaque>) {
+          const typename FromValue::Viewer viewer(ptr);
+          writer.template opaque<Name>().assign(viewer.head(), viewer.payloadSize());
+        } else if constexpr (To::template IS_FIXED<Name>) {
+          To::template set<Name>(out, FromValue::get(ptr));
+        } else {
+          writer.template set<Name>(FromValue::get(ptr));
+        }
+      }
+    });
+    return writer.size();
+  }
+};
+
+} // namespace hw::type::beacon
+// --- END FILE: include/hw/type/beacon/Schema.hpp ---
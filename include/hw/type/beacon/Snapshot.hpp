@@ -0,0 +1,331 @@
+// --- START FILE: include/hw/type/beacon/Snapshot.hpp ---
+#pragma once
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <hw/type/NameTag.hpp>
+#include <hw/type/beacon/TypeTraits.hpp>
+#include <hw/type/beacon/Message.hpp>
+#include <hw/type/beacon/Columnar.hpp>
+#include <hw/utility/MMap.hpp>
+#include <hw/utility/SwissTable.hpp>
+
+namespace hw::type::beacon {
+
+namespace detail {
+  // Fixed part of a snapshot file; the sections follow at 64-byte aligned offsets.
+  struct SnapshotHeader {
+    static constexpr std::array<char, 8> MAGIC {'H', 'W', 'S', 'N', 'A', 'P', '0', '1'};
+
+    std::array<char, 8> magic;
+    uint64_t signature;     // NamedMessageType::SIGNATURE of the rows
+    uint64_t keyOffset;     // key field offset and size, a second check on the layout
+    uint64_t keySize;
+    uint64_t rows;
+    uint64_t capacity;      // index slots, a power of two
+    uint64_t messagesSize;  // bytes of the message section
+    uint64_t fileSize;
+  };
+  static_assert(sizeof(SnapshotHeader) == 64);
+
+  inline constexpr size_t SNAPSHOT_ALIGN = 64;
+
+  inline constexpr size_t snapshotAlign(size_t offset) noexcept {
+    return (offset + SNAPSHOT_ALIGN - 1) & ~(SNAPSHOT_ALIGN - 1);
+  }
+
+  // Stable across processes and builds: the index is hashed offline and probed at run time.
+  inline uint64_t snapshotHash(const std::byte* key, size_t len) noexcept {
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < len; ++i) {
+      h = (h ^ std::to_integer<uint64_t>(key[i])) * 0x100000001b3ull;
+    }
+    return utility::swisstable::detail::hash(h);
+  }
+
+  /**
+   * Section offsets of a snapshot, a function of the message type and the header counts only:
+   * - one column per fixed field (rows * SIZE bytes), in declaration order
+   * - message offsets ((rows + 1) * 8 bytes) and the wire messages themselves
+   * - index control bytes (capacity + SIMD_SIZE, the first group mirrored at the end) and
+   *   index rows (capacity * 4 bytes)
+   */
+  template <typename MessageType>
+  struct SnapshotLayout {
+    static constexpr size_t FIELD_CNT = MessageType::FIELD_CNT;
+
+    std::array<size_t, FIELD_CNT> column {}; // fixed fields only
+    size_t offsets = 0;
+    size_t messages = 0;
+    size_t ctrl = 0;
+    size_t slots = 0;
+    size_t fileSize = 0;
+
+    SnapshotLayout(size_t rows, size_t capacity, size_t messagesSize) {
+      size_t at = sizeof(SnapshotHeader);
+      mp_for_each<mp_iota_c<FIELD_CNT>>([&] (auto I) {
+        using FieldType = mp_at_c<typename MessageType::field_list, I>;
+        if constexpr (MessageType::template IS_FIXED<FieldType::name_tag>) {
+          at = snapshotAlign(at);
+          column[I] = at;
+          at += rows * unwrap_t<FieldType>::SIZE;
+        }
+      });
+      offsets = at = snapshotAlign(at);
+      messages = at = snapshotAlign(at + (rows + 1) * sizeof(uint64_t));
+      ctrl = at = snapshotAlign(at + messagesSize);
+      slots = at = snapshotAlign(at + capacity + utility::swisstable::SIMD_SIZE);
+      fileSize = at + capacity * sizeof(uint32_t);
+    }
+  };
+}
+
+/**
+ * Snapshot: read-only reference data (instruments, accounts, ...) stored as beacon messages
+ * in a file built offline by SnapshotBuilder and used straight from a ReadableMmap.
+ * - find(key) probes a Swiss-table index that is part of the file (SIMD over 16 control
+ *   bytes, as in HashVarray), so opening a snapshot neither parses nor hashes anything.
+ * - Every fixed field is also stored as a column; column<Name>() gives fixed Numeric fields
+ *   as a span for scans. get<Name>(row) reads any field from the row's wire message.
+ * - The file records the message signature and the key field; a snapshot of another layout
+ *   is rejected with std::invalid_argument. Files are host-endian like the field accessors.
+ */
+template <typename MessageType, NameTag KeyName>
+class Snapshot {
+public:
+  static_assert(MessageType::template IS_FIXED<KeyName> && !MessageType::template IS_OPTIONAL<KeyName>,
+                "the key is a mandatory fixed field");
+  using KeyField = detail::unwrap_t<typename MessageType::template Field<KeyName>>;
+  static constexpr size_t KEY_SIZE = KeyField::SIZE;
+  static constexpr size_t NOT_FOUND = ~size_t{0};
+
+  explicit Snapshot(const std::string& path) : _map(std::in_place, path) {
+    attach(_map->data(), _map->size());
+  }
+
+  // Borrows a mapping that must outlive the snapshot.
+  explicit Snapshot(const utility::ReadableMmap& map) {
+    attach(map.data(), map.size());
+  }
+
+  Snapshot(const Snapshot&) = delete;
+  Snapshot& operator=(const Snapshot&) = delete;
+
+  size_t size() const noexcept { return _rows; }
+
+  // Row of the message whose key field holds `key` (as set by the key field), NOT_FOUND if none.
+  template <typename Type>
+  size_t find(Type&& key) const {
+    std::array<std::byte, KEY_SIZE> bytes;
+    KeyField::set(bytes.data(), std::forward<Type>(key));
+    return findKey(bytes.data());
+  }
+
+  // Same with the key field's wire bytes.
+  size_t findKey(const std::byte* key) const noexcept {
+    const uint64_t h = detail::snapshotHash(key, KEY_SIZE);
+    const int8_t tag = static_cast<int8_t>(h & 0x7f);
+    const size_t start = (h >> 7) & _mask;
+    const std::byte* keys = _base + _layout->column[KEY_INDEX];
+    for (size_t i = 0; i < _capacity; i += utility::swisstable::SIMD_SIZE) {
+      const size_t group = (start + i) & _mask;
+      uint32_t matches, empties;
+#if defined(__SSE2__)
+      const __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_ctrl + group));
+      matches = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(tag))));
+      empties = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(utility::swisstable::Control::Empty))));
+#else
+      matches = empties = 0;
+      for (size_t j = 0; j < utility::swisstable::SIMD_SIZE; ++j) {
+        matches |= static_cast<uint32_t>(_ctrl[group + j] == tag) << j;
+        empties |= static_cast<uint32_t>(_ctrl[group + j] == utility::swisstable::Control::Empty) << j;
+      }
+#endif
+      while (matches) {
+        const size_t slot = (group + static_cast<size_t>(std::countr_zero(matches))) & _mask;
+        uint32_t row;
+        std::memcpy(&row, _slots + slot * sizeof(uint32_t), sizeof(row));
+        if (row < _rows && std::memcmp(keys + size_t{row} * KEY_SIZE, key, KEY_SIZE) == 0) [[likely]] {
+          return row;
+        }
+        matches &= matches - 1;
+      }
+      if (empties) [[likely]] {
+        return NOT_FOUND;
+      }
+    }
+    return NOT_FOUND;
+  }
+
+  template <NameTag Name>
+  requires detail::ColumnField<MessageType, Name>
+  std::span<const typename MessageType::template Field<Name>::value_type> column() const noexcept {
+    using ValueType = typename MessageType::template Field<Name>::value_type;
+    return {reinterpret_cast<const ValueType*>(_base + _layout->column[MessageType::template INDEX<Name>]), _rows};
+  }
+
+  template <NameTag Name>
+  auto get(size_t row) const {
+    return MessageType::template get<Name>(message(row));
+  }
+
+  const std::byte* message(size_t row) const noexcept {
+    return _base + _layout->messages + offset(row);
+  }
+
+  size_t messageSize(size_t row) const noexcept {
+    return offset(row + 1) - offset(row);
+  }
+
+private:
+  static constexpr size_t KEY_INDEX = MessageType::template INDEX<KeyName>;
+
+  void attach(const uint8_t* data, size_t size) {
+    detail::SnapshotHeader header;
+    if (size < sizeof(header)) {
+      throw std::invalid_argument("Snapshot: file too small");
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != detail::SnapshotHeader::MAGIC) {
+      throw std::invalid_argument("Snapshot: not a snapshot file");
+    }
+    if (header.signature != MessageType::SIGNATURE || header.keyOffset != MessageType::template OFFSET<KeyName> ||
+        header.keySize != KEY_SIZE) {
+      throw std::invalid_argument("Snapshot: message layout or key mismatch");
+    }
+    if (header.capacity < utility::swisstable::SIMD_SIZE || !std::has_single_bit(header.capacity) ||
+        header.rows >= header.capacity || header.fileSize != size) {
+      throw std::invalid_argument("Snapshot: corrupt header");
+    }
+    _layout.emplace(header.rows, header.capacity, header.messagesSize);
+    if (_layout->fileSize != size) {
+      throw std::invalid_argument("Snapshot: corrupt header");
+    }
+    _base = reinterpret_cast<const std::byte*>(data);
+    _rows = header.rows;
+    _capacity = header.capacity;
+    _mask = _capacity - 1;
+    _ctrl = reinterpret_cast<const int8_t*>(_base + _layout->ctrl);
+    _slots = _base + _layout->slots;
+    if (offset(_rows) != header.messagesSize) {
+      throw std::invalid_argument("Snapshot: corrupt message offsets");
+    }
+  }
+
+  size_t offset(size_t row) const noexcept {
+    uint64_t at;
+    std::memcpy(&at, _base + _layout->offsets + row * sizeof(uint64_t), sizeof(at));
+    return at;
+  }
+
+  std::optional<utility::ReadableMmap> _map;
+  std::optional<detail::SnapshotLayout<MessageType>> _layout;
+  const std::byte* _base = nullptr;
+  size_t _rows = 0;
+  size_t _capacity = 0;
+  size_t _mask = 0;
+  const int8_t* _ctrl = nullptr;
+  const std::byte* _slots = nullptr;
+};
+
+/**
+ * SnapshotBuilder: collects messages offline and writes them as a Snapshot file.
+ * - add() copies the wire message; keys must be unique.
+ * - save() sizes the index for a load factor under 7/8, builds it, and writes the file
+ *   through a WritableMmap; a duplicate key throws before the file is created.
+ */
+template <typename MessageType, NameTag KeyName>
+class SnapshotBuilder {
+public:
+  using SnapshotType = Snapshot<MessageType, KeyName>;
+  static constexpr size_t KEY_SIZE = SnapshotType::KEY_SIZE;
+  static constexpr size_t KEY_OFFSET = MessageType::template OFFSET<KeyName>;
+
+  void add(const std::byte* msg) {
+    const size_t size = MessageType::size(msg);
+    _offsets.push_back(_messages.size());
+    _messages.insert(_messages.end(), msg, msg + size);
+  }
+
+  size_t size() const noexcept { return _offsets.size(); }
+
+  void save(const std::string& path) const {
+    const size_t rows = _offsets.size();
+    if (rows >= std::numeric_limits<uint32_t>::max()) {
+      throw std::invalid_argument("SnapshotBuilder: too many rows");
+    }
+    const size_t capacity = std::max(utility::swisstable::SIMD_SIZE, std::bit_ceil(rows + rows / 7 + 1));
+    const detail::SnapshotLayout<MessageType> layout(rows, capacity, _messages.size());
+
+    // index first, so that a duplicate key leaves no file behind
+    std::vector<int8_t> ctrl(capacity + utility::swisstable::SIMD_SIZE, utility::swisstable::Control::Empty);
+    std::vector<uint32_t> slots(capacity);
+    for (size_t row = 0; row < rows; ++row) {
+      const std::byte* key = _messages.data() + _offsets[row] + KEY_OFFSET;
+      const uint64_t h = detail::snapshotHash(key, KEY_SIZE);
+      const auto tag = static_cast<int8_t>(h & 0x7f);
+      size_t slot = (h >> 7) & (capacity - 1);
+      for (; ctrl[slot] != utility::swisstable::Control::Empty; slot = (slot + 1) & (capacity - 1)) {
+        if (ctrl[slot] == tag && std::memcmp(_messages.data() + _offsets[slots[slot]] + KEY_OFFSET, key, KEY_SIZE) == 0) {
+          throw std::invalid_argument("SnapshotBuilder: duplicate key");
+        }
+      }
+      ctrl[slot] = tag;
+      if (slot < utility::swisstable::SIMD_SIZE) {
+        ctrl[capacity + slot] = tag;
+      }
+      slots[slot] = static_cast<uint32_t>(row);
+    }
+
+    utility::WritableMmap map(path, layout.fileSize);
+    std::byte* base = reinterpret_cast<std::byte*>(map.data());
+
+    const detail::SnapshotHeader header {detail::SnapshotHeader::MAGIC, MessageType::SIGNATURE, KEY_OFFSET, KEY_SIZE,
+                                         rows, capacity, _messages.size(), layout.fileSize};
+    std::memcpy(base, &header, sizeof(header));
+
+    mp_for_each<mp_iota_c<MessageType::FIELD_CNT>>([&] (auto I) {
+      using FieldType = mp_at_c<typename MessageType::field_list, I>;
+      if constexpr (MessageType::template IS_FIXED<FieldType::name_tag>) {
+        constexpr size_t SIZE = detail::unwrap_t<FieldType>::SIZE;
+        constexpr size_t OFFSET = MessageType::template OFFSET<FieldType::name_tag>;
+        for (size_t row = 0; row < rows; ++row) {
+          std::memcpy(base + layout.column[I] + row * SIZE, _messages.data() + _offsets[row] + OFFSET, SIZE);
+        }
+      }
+    });
+
+    for (size_t row = 0; row <= rows; ++row) {
+      const uint64_t at = row < rows ? _offsets[row] : _messages.size();
+      std::memcpy(base + layout.offsets + row * sizeof(at), &at, sizeof(at));
+    }
+    if (!_messages.empty()) {
+      std::memcpy(base + layout.messages, _messages.data(), _messages.size());
+    }
+    std::memcpy(base + layout.ctrl, ctrl.data(), ctrl.size());
+    std::memcpy(base + layout.slots, slots.data(), slots.size() * sizeof(uint32_t));
+  }
+
+private:
+  std::vector<size_t> _offsets;
+  std::vector<std::byte> _messages;
+};
+
+} // namespace hw::type::beacon
+// --- END FILE: include/hw/type/beacon/Snapshot.hpp ---
@@ -6,6 +6,13 @@
 #include <string_view>
 #include <algorithm>
 #include <stdexcept>
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__SSE2__)
+  #include <immintrin.h>
+#endif
 
 #include <hw/type/NameTag.hpp>
 #include <hw/type/beacon/TypeTraits.hpp>
@@ -22,6 +29,41 @@ namespace detail {
     }
     return maxlen;
   }
+
+  /**
+   * strnlen over a field: 16 bytes per compare with SSE2. Only whole blocks inside
+   * [s, s + maxlen) are loaded, the remainder is scanned bytewise, so nothing past the field
+   * is read.
+   */
+  inline size_t simd_strnlen(const char* s, size_t maxlen) noexcept {
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= maxlen; i += 16) {
+      const int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i)), zero));
+      if (mask) {
+        return i + static_cast<size_t>(std::countr_zero(static_cast<unsigned>(mask)));
+      }
+    }
+#endif
+    return i + constexpr_strnlen(s + i, maxlen - i);
+  }
+
+  // Length of s without its trailing `padding` characters, scanning backwards by blocks.
+  inline size_t simd_trimmed_length(const char* s, size_t len, char padding) noexcept {
+#if defined(__SSE2__)
+    const __m128i pad = _mm_set1_epi8(padding);
+    while (len >= 16) {
+      const int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + len - 16)), pad));
+      if (mask != 0xffff) {
+        return len - static_cast<size_t>(std::countl_one(static_cast<uint16_t>(mask)));
+      }
+      len -= 16;
+    }
+#endif
+    while (len && s[len - 1] == padding) --len;
+    return len;
+  }
 }
 
 template<NameTag Tag, size_t Size, char Padding>
@@ -38,12 +80,25 @@ struct NamedStringType {
    */
   static constexpr size_t size(const std::byte* ptr) {
     if constexpr (Padding == '\0') {
-      return detail::constexpr_strnlen(reinterpret_cast<const char*>(ptr), SIZE);
+      if (std::is_constant_evaluated()) {
+        return detail::constexpr_strnlen(reinterpret_cast<const char*>(ptr), SIZE);
+      }
+      return detail::simd_strnlen(reinterpret_cast<const char*>(ptr), SIZE);
     } else {
       return SIZE;
     }
   }
 
+  // Value without the trailing padding of fixed strings (same as get() for variable ones).
+  static std::string_view trimmed(const std::byte* ptr) {
+    const char* str = reinterpret_cast<const char*>(ptr);
+    if constexpr (Padding == '\0') {
+      return {str, size(ptr)};
+    } else {
+      return {str, detail::simd_trimmed_length(str, SIZE, Padding)};
+    }
+  }
+
   static void set(std::byte* ptr, std::string_view sv) {
     size_t len = std::min(SIZE, sv.length());
     std::memcpy(ptr, sv.data(), len);
@@ -74,4 +129,45 @@ using NamedFixedStringType = NamedStringType<Tag, Size, ' '>;
 template<NameTag Tag, size_t Size>
 using NamedVariableStringType = NamedStringType<Tag, Size, '\0'>;
 
+/**
+ * NamedPrefixedStringType: up to Size characters behind a 2-byte length, like Opaque.
+ * - Takes 2 + length bytes on the wire instead of Size, so a mostly short free-text field
+ *   does not set the size of every message (and of the ether slot) to its capacity.
+ * - A tail field in messages; MAX_MEM_SIZE is the largest wire size.
+ */
+template<NameTag Tag, size_t Size>
+struct NamedPrefixedStringType {
+  using type_trait = trait::PrefixedString;
+  using length_type = uint16_t;
+  static constexpr size_t SIZE = Size;
+  static constexpr size_t MAX_MEM_SIZE = Size + sizeof(length_type);
+  static_assert(SIZE > 0 && SIZE <= 0xffff, "Size must fit the 2-byte length.");
+  static constexpr NameTag name_tag = Tag;
+
+  static size_t size(const std::byte* ptr) {
+    length_type len;
+    std::memcpy(&len, ptr, sizeof(len));
+    return len;
+  }
+
+  static size_t wireSize(const std::byte* ptr) {
+    return sizeof(length_type) + size(ptr);
+  }
+
+  // Truncated to SIZE characters.
+  static void set(std::byte* ptr, std::string_view sv) {
+    const length_type len = static_cast<length_type>(std::min(SIZE, sv.length()));
+    std::memcpy(ptr, &len, sizeof(len));
+    std::memcpy(ptr + sizeof(len), sv.data(), len);
+  }
+
+  static std::string_view get(const std::byte* ptr) {
+    return {reinterpret_cast<const char*>(ptr + sizeof(length_type)), size(ptr)};
+  }
+
+  static std::string toString(const std::byte* ptr) {
+    return std::string(get(ptr));
+  }
+};
+
 } // namespace hw::type::beacon
\ No newline at end of file
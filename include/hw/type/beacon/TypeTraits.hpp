@@ -12,6 +12,7 @@ namespace trait {
   struct Enum {};
   struct VarString {};
   struct PaddedString {};
+  struct PrefixedString {};
   struct Opaque {};
   struct Optional {};
   struct Accessor {};
@@ -41,6 +42,7 @@ using BeaconFieldTypeList = type_list<
   trait::Enum,
   trait::VarString,
   trait::PaddedString,
+  trait::PrefixedString,
   trait::Opaque,
   trait::Optional,
   trait::Accessor,
@@ -73,6 +75,7 @@ using OptionalFieldTypeList = type_list<
   trait::Enum,
   trait::VarString,
   trait::PaddedString,
+  trait::PrefixedString,
   trait::Opaque
 >;
 
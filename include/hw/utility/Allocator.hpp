@@ -4,20 +4,69 @@
 #include <cstdlib> // For posix_memalign, free
 #include <new>     // For placement new
 #include <limits>
-#include <vector>
 #include <cstring> // For std::memcpy (if needed)
 #include <utility> // For std::forward
 #include <algorithm> // For std::max
 
+#include <hw/utility/Backing.hpp>
+
 namespace hw::utility {
 
+// Per-pool statistics; maintained on every allocate/free, read on the slow path.
+struct PoolStats {
+  size_t capacity = 0;    // blocks currently owned by the pool (initial + slabs)
+  size_t inUse = 0;       // blocks handed out and not yet returned
+  size_t highWater = 0;   // maximum of inUse since construction
+  size_t fallbackCnt = 0; // number of times the free list ran dry
+  size_t slabCnt = 0;     // number of slabs added after construction
+};
+
+namespace detail {
+  // Header placed in front of every fallback slab; slabs are chained intrusively
+  // so growing the pool never touches a std::vector on the hot path.
+  struct SlabHeader {
+    SlabHeader* next;
+    size_t size; // bytes obtained from the backing store, needed to release it
+  };
+
+  // Returns offset of the first block inside a slab, keeping blocks aligned.
+  constexpr size_t slabHeaderSize(size_t alignment) {
+    return (sizeof(SlabHeader) + alignment - 1) & ~(alignment - 1);
+  }
+
+  template <typename Backing = HeapBacking>
+  inline std::byte* allocateSlab(SlabHeader*& head, size_t alignment, size_t blockSize, size_t blockCnt) {
+    const size_t offset = slabHeaderSize(alignment);
+    const size_t size = offset + blockSize * blockCnt;
+    void* mem = Backing::allocate(size, std::max(alignment, alignof(SlabHeader)));
+    SlabHeader* slab = static_cast<SlabHeader*>(mem);
+    slab->next = head;
+    slab->size = size;
+    head = slab;
+    return static_cast<std::byte*>(mem) + offset;
+  }
+
+  template <typename Backing = HeapBacking>
+  inline void releaseSlabs(SlabHeader*& head) {
+    while (head) {
+      SlabHeader* next = head->next;
+      Backing::release(head, head->size);
+      head = next;
+    }
+  }
+}
+
 /**
  * AllocatorTrivial: A high-performance pool allocator for a specific Type.
  * - Uses an embedded free-list to eliminate runtime heap allocations for Type objects.
  * - Guarantees ALIGNMENT for Type.
  * - Provides standard allocation/deallocation of raw memory, and separate construct/destroy.
+ * - When the pool runs dry it grows by a whole slab of blocks (not one block at a time).
+ * - Backing selects where pool and slabs come from (see PoolBacking), e.g.
+ *   AllocatorTrivial<OrderState, HugePageBacking> for a prefaulted 2MB-page pool, or
+ *   PoolBacking<BACKING_CACHELINE_PAD> to give every block its own cache line.
  */
-template <typename Type>
+template <typename Type, typename Backing = HeapBacking>
 class AllocatorTrivial {
   // A node in our free-list, stored directly in the idle memory blocks
   struct Node {
@@ -26,20 +75,24 @@ class AllocatorTrivial {
 
   // Ensure the block size is large enough to hold either Type or Node, and is aligned.
   // This ensures that when a block is free, it can store a Node*, and when allocated, it fits Type.
-  static constexpr size_t BLOCK_SIZE = (std::max(sizeof(Type), sizeof(Node)) + alignof(Type) - 1) & ~(alignof(Type) - 1);
-  static constexpr size_t ALIGNMENT = alignof(Type);
+  static constexpr size_t ALIGNMENT = std::max(alignof(Type), Backing::BLOCK_ALIGNMENT);
+  static constexpr size_t BLOCK_SIZE = (std::max(sizeof(Type), sizeof(Node)) + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
 
 public:
-  explicit AllocatorTrivial(size_t count) : _count(count) {
+  static constexpr size_t MIN_SLAB_COUNT = 16;
+  static constexpr size_t MAX_SLAB_COUNT = 4096;
+
+  // slabCount: number of blocks added per fallback slab; 0 derives it from count.
+  explicit AllocatorTrivial(size_t count, size_t slabCount = 0)
+    : _count(count)
+    , _slabCount(slabCount ? slabCount : defaultSlabCount(count)) {
+    _stats.capacity = _count;
     if (_count == 0) {
         _data = nullptr; // Handle zero-sized allocation
         return;
     }
-    // 1. Aligned allocation of the main pool
-    // posix_memalign ensures we respect Type's alignment requirements
-    if (int err = posix_memalign(reinterpret_cast<void**>(&_data), ALIGNMENT, _count * BLOCK_SIZE)) {
-      throw std::bad_alloc();
-    }
+    // 1. Aligned allocation of the main pool from the backing store
+    _data = Backing::allocate(_count * BLOCK_SIZE, ALIGNMENT);
 
     std::byte* ptr = reinterpret_cast<std::byte*>(_data);
     for (size_t i = 0; i < _count; ++i) {
@@ -49,12 +102,10 @@ public:
   }
 
   ~AllocatorTrivial() {
-    // Free any memory obtained via fallback _postalloc
-    for (void* ptr : _postalloc) {
-      ::free(ptr);
-    }
+    // Free any slabs obtained via fallback
+    detail::releaseSlabs<Backing>(_slabs);
     // Free the main pre-allocated pool
-    ::free(_data);
+    Backing::release(_data, _count * BLOCK_SIZE);
   }
 
   AllocatorTrivial(const AllocatorTrivial&) = delete;
@@ -66,18 +117,15 @@ public:
   // Allocate raw memory for one object of Type.
   // Returns a pointer to uninitialized memory.
   inline Type* allocate() {
-    void* ptr = nullptr;
-
-    if (_free) [[likely]] {
-      ptr = _free; // Take from free list
-      _free = _free->next;
-    } else {
+    if (!_free) [[unlikely]] {
       // Fallback: This is the "jitter" path - indicates initial pool might be too small.
-      // Consider logging this in a real system.
-      if (int err = posix_memalign(&ptr, ALIGNMENT, BLOCK_SIZE)) {
-        throw std::bad_alloc();
-      }
-      _postalloc.push_back(ptr); // Keep track of fallback allocations for freeing
+      // Monitor stats().fallbackCnt to size the pool.
+      grow();
+    }
+    void* ptr = _free; // Take from free list
+    _free = _free->next;
+    if (++_stats.inUse > _stats.highWater) {
+      _stats.highWater = _stats.inUse;
     }
     return reinterpret_cast<Type*>(ptr);
   }
@@ -87,6 +135,7 @@ public:
     if (!ptr) return;
     // Note: The destructor for Type is NOT called here. Caller is responsible for destroy.
     push(reinterpret_cast<std::byte*>(ptr));
+    --_stats.inUse;
   }
 
   // Construct an object of Type at the given pre-allocated memory location.
@@ -119,7 +168,36 @@ public:
       return nullptr;
   }
 
+  const PoolStats& stats() const noexcept {
+    return _stats;
+  }
+
+  static constexpr size_t blockSize() noexcept {
+    return BLOCK_SIZE;
+  }
+
 private:
+  // Huge-page slabs are sized to fill a whole 2MB page; a block larger than that gets a slab of
+  // its own.
+  static constexpr size_t defaultSlabCount(size_t count) noexcept {
+    if constexpr ((Backing::flags & BACKING_HUGE_PAGES) != 0) {
+      return std::max<size_t>(1, (Backing::HUGE_PAGE_SIZE - detail::slabHeaderSize(ALIGNMENT)) / BLOCK_SIZE);
+    }
+    return std::clamp(count, MIN_SLAB_COUNT, MAX_SLAB_COUNT);
+  }
+
+  // Adds one slab of _slabCount blocks to the free list.
+  void grow() {
+    std::byte* ptr = detail::allocateSlab<Backing>(_slabs, ALIGNMENT, BLOCK_SIZE, _slabCount);
+    for (size_t i = 0; i < _slabCount; ++i) {
+      push(ptr);
+      ptr += BLOCK_SIZE;
+    }
+    ++_stats.fallbackCnt;
+    ++_stats.slabCnt;
+    _stats.capacity += _slabCount;
+  }
+
   // Push a raw memory block to the free list.
   inline void push(std::byte* ptr) {
     Node* node = reinterpret_cast<Node*>(ptr);
@@ -130,9 +208,11 @@ private:
   void* _data = nullptr; // Pointer to the start of the main pre-allocated memory pool
   Node* _free = nullptr; // Head of the free list
   size_t _count = 0;   // Number of blocks in the initial pool
+  size_t _slabCount = 0; // Number of blocks added per fallback slab
 
-  // Stores pointers to memory blocks allocated during fallback (when free list is empty)
-  std::vector<void*> _postalloc;
+  // Chain of slabs allocated during fallback (when free list is empty)
+  detail::SlabHeader* _slabs = nullptr;
+  PoolStats _stats;
 };
 
 } // namespace hw::utility
@@ -0,0 +1,282 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <algorithm>
+
+#include <hw/utility/CPU.hpp>
+#include <hw/utility/Allocator.hpp>
+#include <hw/utility/Spinlock.hpp>
+
+namespace hw::utility {
+
+/**
+ * AllocatorMT: pool allocator for objects that are allocated on one thread and
+ * released on another (e.g. pooled objects flowing between dispatchers via an ether).
+ * - Every thread allocates from its own heap (thread cache); no atomics on the local path.
+ * - free() from the owning thread pushes to the local free list.
+ * - free() from any other thread pushes to the owner's lock-free remote list (one CAS).
+ * - The owner takes the whole remote list with a single exchange, either when its local
+ *   list runs dry or explicitly via reclaim() (e.g. at batch end).
+ * - Memory comes in SLAB_SIZE slabs aligned to SLAB_SIZE, so the owning heap of any block
+ *   is found by masking the block address; there is no per-object header.
+ * - Heaps are owned by the allocator and released with it; the allocator must outlive
+ *   every thread that uses it. Blocks freed to a heap whose thread has exited stay there
+ *   until the allocator is destroyed.
+ */
+template <typename Type, size_t MIN_SLAB_SIZE = 64 * 1024>
+class AllocatorMT {
+  struct Node {
+    Node* next;
+  };
+
+  struct Heap;
+
+  struct alignas(ALIGNAS) SlabHeader {
+    Heap* owner;
+    SlabHeader* next;
+  };
+
+  static constexpr size_t ALIGNMENT = std::max(alignof(Type), alignof(Node));
+  static constexpr size_t BLOCK_SIZE = (std::max(sizeof(Type), sizeof(Node)) + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+  static constexpr size_t HEADER_SIZE = (sizeof(SlabHeader) + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+public:
+  // Slab size is a power of 2 holding at least 16 blocks.
+  static constexpr size_t SLAB_SIZE = std::bit_ceil(std::max(MIN_SLAB_SIZE, HEADER_SIZE + 16 * BLOCK_SIZE));
+  static constexpr size_t BLOCKS_PER_SLAB = (SLAB_SIZE - HEADER_SIZE) / BLOCK_SIZE;
+
+private:
+  struct alignas(ALIGNAS) Heap {
+    explicit Heap(std::thread::id tid) : threadId(tid) {}
+
+    // owner-only state
+    Node* free = nullptr;
+    SlabHeader* slabs = nullptr;
+    PoolStats stats;
+    const std::thread::id threadId;
+
+    // written by other threads
+    alignas(ALIGNAS) std::atomic<Node*> remote {nullptr};
+    std::atomic<size_t> remoteCnt {0};
+  };
+
+public:
+  // initialCount: number of blocks pre-allocated for the constructing thread's heap.
+  explicit AllocatorMT(size_t initialCount = 0) : _id(nextId()) {
+    if (initialCount) {
+      Heap& heap = local();
+      while (heap.stats.capacity < initialCount) {
+        grow(heap);
+      }
+      heap.stats.slabCnt = 0;
+      heap.stats.fallbackCnt = 0;
+    }
+  }
+
+  ~AllocatorMT() {
+    for (auto& heap : _heaps) {
+      while (heap->slabs) {
+        SlabHeader* next = heap->slabs->next;
+        ::free(heap->slabs);
+        heap->slabs = next;
+      }
+    }
+  }
+
+  AllocatorMT(const AllocatorMT&) = delete;
+  AllocatorMT& operator=(const AllocatorMT&) = delete;
+  AllocatorMT(AllocatorMT&&) = delete;
+  AllocatorMT& operator=(AllocatorMT&&) = delete;
+
+  // Allocate raw memory for one object of Type from the calling thread's heap.
+  inline Type* allocate() {
+    Heap& heap = local();
+    if (!heap.free) [[unlikely]] {
+      if (!reclaim(heap)) {
+        grow(heap);
+      }
+    }
+    Node* node = heap.free;
+    heap.free = node->next;
+    if (++heap.stats.inUse > heap.stats.highWater) {
+      heap.stats.highWater = heap.stats.inUse;
+    }
+    return reinterpret_cast<Type*>(node);
+  }
+
+  // Deallocate raw memory; may be called from any thread.
+  inline void free(Type* ptr) noexcept {
+    if (!ptr) return;
+    Node* node = reinterpret_cast<Node*>(ptr);
+    Heap* owner = slabOf(ptr)->owner;
+    if (owner->threadId == currentThread()) [[likely]] {
+      node->next = owner->free;
+      owner->free = node;
+      --owner->stats.inUse;
+    }
+    else {
+      // counted before the node is published, so a concurrent reclaim() never takes the count below zero
+      owner->remoteCnt.fetch_add(1, std::memory_order_relaxed);
+      Node* head = owner->remote.load(std::memory_order_relaxed);
+      do {
+        node->next = head;
+      } while (!owner->remote.compare_exchange_weak(head, node,
+                  std::memory_order_release, std::memory_order_relaxed));
+    }
+  }
+
+  template <typename ... Args>
+  inline void construct(Type* ptr, Args&&... args) {
+    new (ptr) Type(std::forward<Args>(args)...);
+  }
+
+  inline void destroy(Type* ptr) {
+    if (ptr) {
+      ptr->~Type();
+    }
+  }
+
+  // Moves blocks released by other threads back to the calling thread's free list.
+  // Returns number of blocks reclaimed.
+  size_t reclaim() {
+    return reclaim(local());
+  }
+
+  // Statistics of the calling thread's heap.
+  const PoolStats& stats() {
+    return local().stats;
+  }
+
+  // Blocks released to the calling thread's heap by other threads and not yet reclaimed.
+  size_t pendingRemote() {
+    return local().remoteCnt.load(std::memory_order_relaxed);
+  }
+
+  size_t heapCount() const {
+    std::lock_guard<Spinlock> lock(_lock);
+    return _heaps.size();
+  }
+
+private:
+  static uint64_t nextId() noexcept {
+    static std::atomic<uint64_t> counter {0};
+    return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+
+  // Direct-mapped by allocator id, so up to CACHE_WAYS allocators of one Type used on the
+  // same thread keep their heaps cached; ids are never reused, so entries cannot go stale.
+  static constexpr size_t CACHE_WAYS = 8;
+
+  struct ThreadCache {
+    uint64_t id[CACHE_WAYS] = {};
+    void* heap[CACHE_WAYS] = {};
+  };
+
+  static ThreadCache& threadCache() noexcept {
+    static thread_local ThreadCache cache;
+    return cache;
+  }
+
+  static const std::thread::id& currentThread() noexcept {
+    static thread_local const std::thread::id tid = std::this_thread::get_id();
+    return tid;
+  }
+
+  // Heap of the calling thread if it is cached for this allocator, otherwise nullptr.
+  inline Heap* cached() const noexcept {
+    const ThreadCache& cache = threadCache();
+    const size_t way = _id & (CACHE_WAYS - 1);
+    return cache.id[way] == _id ? static_cast<Heap*>(cache.heap[way]) : nullptr;
+  }
+
+  inline Heap& local() {
+    if (Heap* heap = cached(); heap) [[likely]] {
+      return *heap;
+    }
+    return attach();
+  }
+
+  // Slow path: find or create the calling thread's heap and cache it.
+  Heap& attach() {
+    const std::thread::id tid = currentThread();
+    Heap* heap = nullptr;
+    {
+      std::lock_guard<Spinlock> lock(_lock);
+      auto it = std::find_if(_heaps.begin(), _heaps.end(), [tid] (const auto& h) { return h->threadId == tid; });
+      if (it != _heaps.end()) {
+        heap = it->get();
+      }
+      else {
+        _heaps.emplace_back(std::make_unique<Heap>(tid));
+        heap = _heaps.back().get();
+      }
+    }
+    ThreadCache& cache = threadCache();
+    const size_t way = _id & (CACHE_WAYS - 1);
+    cache.id[way] = _id;
+    cache.heap[way] = heap;
+    return *heap;
+  }
+
+  static inline SlabHeader* slabOf(const void* ptr) noexcept {
+    return reinterpret_cast<SlabHeader*>(reinterpret_cast<uintptr_t>(ptr) & ~(SLAB_SIZE - 1));
+  }
+
+  // Takes the whole remote list in one exchange and splices it into the local list.
+  size_t reclaim(Heap& heap) noexcept {
+    if (!heap.remote.load(std::memory_order_relaxed)) [[likely]] {
+      return 0;
+    }
+    Node* head = heap.remote.exchange(nullptr, std::memory_order_acquire);
+    if (!head) return 0;
+    size_t cnt = 1;
+    Node* tail = head;
+    while (tail->next) {
+      tail = tail->next;
+      ++cnt;
+    }
+    tail->next = heap.free;
+    heap.free = head;
+    heap.remoteCnt.fetch_sub(cnt, std::memory_order_relaxed);
+    heap.stats.inUse -= cnt;
+    return cnt;
+  }
+
+  void grow(Heap& heap) {
+    void* mem = nullptr;
+    if (posix_memalign(&mem, SLAB_SIZE, SLAB_SIZE)) {
+      throw std::bad_alloc();
+    }
+    SlabHeader* slab = static_cast<SlabHeader*>(mem);
+    slab->owner = &heap;
+    slab->next = heap.slabs;
+    heap.slabs = slab;
+
+    std::byte* ptr = static_cast<std::byte*>(mem) + HEADER_SIZE + BLOCKS_PER_SLAB * BLOCK_SIZE;
+    for (size_t i = 0; i < BLOCKS_PER_SLAB; ++i) {
+      ptr -= BLOCK_SIZE;
+      Node* node = reinterpret_cast<Node*>(ptr);
+      node->next = heap.free;
+      heap.free = node;
+    }
+    heap.stats.capacity += BLOCKS_PER_SLAB;
+    ++heap.stats.slabCnt;
+    ++heap.stats.fallbackCnt;
+  }
+
+  const uint64_t _id;
+  mutable Spinlock _lock;
+  std::vector<std::unique_ptr<Heap>> _heaps;
+};
+
+} // namespace hw::utility
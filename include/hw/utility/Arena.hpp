@@ -0,0 +1,363 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <algorithm>
+
+#include <hw/utility/Allocator.hpp>
+
+namespace hw::utility {
+
+/**
+ * SlabPool: fixed block size pool where the block size is chosen at runtime.
+ * - Same free-list scheme as AllocatorTrivial, but untyped.
+ * - Grows by whole slabs of blocksPerSlab blocks; never frees slabs before destruction.
+ * - Not thread-safe.
+ */
+class SlabPool {
+  struct Node {
+    Node* next;
+  };
+
+public:
+  SlabPool(size_t blockSize, size_t blocksPerSlab, size_t alignment = alignof(std::max_align_t), size_t initialSlabs = 1)
+    : _alignment(std::max(alignment, alignof(Node)))
+    , _blockSize((std::max(blockSize, sizeof(Node)) + _alignment - 1) & ~(_alignment - 1))
+    , _blocksPerSlab(std::max<size_t>(blocksPerSlab, 1)) {
+    if (!std::has_single_bit(_alignment)) {
+      throw std::invalid_argument("SlabPool: alignment must be a power of 2");
+    }
+    for (size_t i = 0; i < initialSlabs; ++i) {
+      addSlab();
+    }
+    _stats.slabCnt = 0; // only fallback slabs are counted
+  }
+
+  ~SlabPool() {
+    detail::releaseSlabs(_slabs);
+  }
+
+  SlabPool(const SlabPool&) = delete;
+  SlabPool& operator=(const SlabPool&) = delete;
+  SlabPool(SlabPool&&) = delete;
+  SlabPool& operator=(SlabPool&&) = delete;
+
+  inline void* allocate() {
+    if (!_free) [[unlikely]] {
+      addSlab();
+      ++_stats.fallbackCnt;
+    }
+    Node* node = _free;
+    _free = node->next;
+    if (++_stats.inUse > _stats.highWater) {
+      _stats.highWater = _stats.inUse;
+    }
+    return node;
+  }
+
+  inline void free(void* ptr) noexcept {
+    if (!ptr) return;
+    Node* node = static_cast<Node*>(ptr);
+    node->next = _free;
+    _free = node;
+    --_stats.inUse;
+  }
+
+  size_t blockSize() const noexcept { return _blockSize; }
+  size_t alignment() const noexcept { return _alignment; }
+  const PoolStats& stats() const noexcept { return _stats; }
+
+private:
+  void addSlab() {
+    std::byte* ptr = detail::allocateSlab(_slabs, _alignment, _blockSize, _blocksPerSlab);
+    // push in reverse so that allocation order follows address order
+    ptr += _blockSize * _blocksPerSlab;
+    for (size_t i = 0; i < _blocksPerSlab; ++i) {
+      ptr -= _blockSize;
+      Node* node = reinterpret_cast<Node*>(ptr);
+      node->next = _free;
+      _free = node;
+    }
+    _stats.capacity += _blocksPerSlab;
+    ++_stats.slabCnt;
+  }
+
+  const size_t _alignment;
+  const size_t _blockSize;
+  const size_t _blocksPerSlab;
+  Node* _free = nullptr;
+  detail::SlabHeader* _slabs = nullptr;
+  PoolStats _stats;
+};
+
+/**
+ * SizeClassAllocator: variable-size allocations served from a set of SlabPools.
+ * - CLASSES are the block sizes in ascending order, each a multiple of GRANULE.
+ * - Size to class mapping is a single table lookup.
+ * - Requests larger than the largest class go to posix_memalign and are counted as oversize.
+ * - free() requires the size used for allocate() (same contract as sized delete).
+ * - Not thread-safe.
+ */
+template <size_t... CLASSES>
+class SizeClassAllocator {
+  static constexpr size_t CLASS_CNT = sizeof...(CLASSES);
+  static constexpr std::array<size_t, CLASS_CNT> CLASS_SIZE = { CLASSES... };
+
+  static_assert(CLASS_CNT > 0, "At least one size class is required");
+  static_assert(CLASS_CNT < 255, "Too many size classes");
+
+public:
+  static constexpr size_t GRANULE = 8;
+  static constexpr size_t MAX_CLASS_SIZE = CLASS_SIZE[CLASS_CNT - 1];
+  static constexpr size_t OVERSIZE = CLASS_CNT;
+
+private:
+  static constexpr bool validClasses() {
+    for (size_t i = 0; i < CLASS_CNT; ++i) {
+      if (CLASS_SIZE[i] == 0 || CLASS_SIZE[i] % GRANULE) return false;
+      if (i > 0 && CLASS_SIZE[i] <= CLASS_SIZE[i - 1]) return false;
+    }
+    return true;
+  }
+  static_assert(validClasses(), "Size classes must be ascending multiples of GRANULE");
+
+  // LOOKUP[(size + GRANULE - 1) / GRANULE] -> index of the smallest class that fits
+  static constexpr auto LOOKUP = [] {
+    std::array<uint8_t, MAX_CLASS_SIZE / GRANULE + 1> table {};
+    size_t cls = 0;
+    for (size_t i = 0; i < table.size(); ++i) {
+      while (CLASS_SIZE[cls] < i * GRANULE) ++cls;
+      table[i] = static_cast<uint8_t>(cls);
+    }
+    return table;
+  } ();
+
+public:
+  static constexpr size_t classOf(size_t size) noexcept {
+    return size <= MAX_CLASS_SIZE ? LOOKUP[(size + GRANULE - 1) / GRANULE] : OVERSIZE;
+  }
+
+  /**
+   * @param blocksPerSlab Number of blocks per slab in every class.
+   * @param alignment Alignment of every block; allocations needing more go oversize.
+   */
+  explicit SizeClassAllocator(size_t blocksPerSlab, size_t alignment = alignof(std::max_align_t))
+    : SizeClassAllocator(blocksPerSlab, alignment, std::make_index_sequence<CLASS_CNT>{}) {}
+
+  SizeClassAllocator(const SizeClassAllocator&) = delete;
+  SizeClassAllocator& operator=(const SizeClassAllocator&) = delete;
+
+  inline void* allocate(size_t size) {
+    const size_t cls = classOf(size);
+    if (cls < CLASS_CNT) [[likely]] {
+      return _pools[cls]->allocate();
+    }
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, _alignment, size)) {
+      throw std::bad_alloc();
+    }
+    ++_oversizeCnt;
+    return ptr;
+  }
+
+  inline void free(void* ptr, size_t size) noexcept {
+    if (!ptr) return;
+    const size_t cls = classOf(size);
+    if (cls < CLASS_CNT) [[likely]] {
+      _pools[cls]->free(ptr);
+    }
+    else {
+      ::free(ptr);
+    }
+  }
+
+  // Typed interface, same shape as AllocatorTrivial.
+  template <typename Type>
+  inline Type* allocate() {
+    static_assert(alignof(Type) <= alignof(std::max_align_t), "Over-aligned types are not supported");
+    return static_cast<Type*>(allocate(sizeof(Type)));
+  }
+
+  template <typename Type, typename ... Args>
+  inline void construct(Type* ptr, Args&&... args) {
+    new (ptr) Type(std::forward<Args>(args)...);
+  }
+
+  template <typename Type>
+  inline void destroy(Type* ptr) {
+    if (ptr) {
+      ptr->~Type();
+    }
+  }
+
+  template <typename Type>
+  inline void free(Type* ptr) noexcept {
+    free(static_cast<void*>(ptr), sizeof(Type));
+  }
+
+  static constexpr size_t classCount() noexcept { return CLASS_CNT; }
+  static constexpr size_t classSize(size_t cls) noexcept { return CLASS_SIZE[cls]; }
+  const PoolStats& stats(size_t cls) const noexcept { return _pools[cls]->stats(); }
+  size_t oversizeCount() const noexcept { return _oversizeCnt; }
+
+private:
+  template <size_t... I>
+  SizeClassAllocator(size_t blocksPerSlab, size_t alignment, std::index_sequence<I...>)
+    : _alignment(alignment)
+    , _pools{ std::make_unique<SlabPool>(CLASS_SIZE[I], blocksPerSlab, alignment)... } {}
+
+  const size_t _alignment;
+  std::array<std::unique_ptr<SlabPool>, CLASS_CNT> _pools;
+  size_t _oversizeCnt = 0;
+};
+
+using DefaultSizeClassAllocator = SizeClassAllocator<16, 32, 64, 128, 256, 512, 1024, 2048, 4096>;
+
+/**
+ * BumpArena: pointer-bump allocator for per-message or per-batch scratch memory.
+ * - allocate() is a pointer increment; free() is a no-op.
+ * - reset() releases everything at once (e.g. at batch end) and keeps the chunks for reuse.
+ * - Grows by whole chunks of chunkSize bytes; larger requests get a dedicated chunk.
+ * - destroy() only runs destructors; memory comes back with reset().
+ * - Not thread-safe.
+ */
+class BumpArena {
+  struct Chunk {
+    Chunk* next;
+    size_t size;
+  };
+  static constexpr size_t CHUNK_HEADER = (sizeof(Chunk) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+public:
+  explicit BumpArena(size_t chunkSize) : _chunkSize(std::max(chunkSize, CHUNK_HEADER)) {
+    _head = _current = newChunk(_chunkSize);
+    _ptr = begin(_current);
+    _end = end(_current);
+    _stats.capacity = _chunkSize - CHUNK_HEADER;
+  }
+
+  ~BumpArena() {
+    while (_head) {
+      Chunk* next = _head->next;
+      ::free(_head);
+      _head = next;
+    }
+  }
+
+  BumpArena(const BumpArena&) = delete;
+  BumpArena& operator=(const BumpArena&) = delete;
+  BumpArena(BumpArena&&) = delete;
+  BumpArena& operator=(BumpArena&&) = delete;
+
+  inline void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+    std::byte* ptr = align(_ptr, alignment);
+    if (ptr + size > _end) [[unlikely]] {
+      ptr = advance(size, alignment);
+    }
+    _ptr = ptr + size;
+    _used += size;
+    if (_used > _stats.highWater) {
+      _stats.highWater = _used;
+    }
+    ++_stats.inUse;
+    return ptr;
+  }
+
+  template <typename Type>
+  inline Type* allocate(size_t count = 1) {
+    return static_cast<Type*>(allocate(sizeof(Type) * count, alignof(Type)));
+  }
+
+  template <typename Type, typename ... Args>
+  inline void construct(Type* ptr, Args&&... args) {
+    new (ptr) Type(std::forward<Args>(args)...);
+  }
+
+  template <typename Type>
+  inline void destroy(Type* ptr) {
+    if (ptr) {
+      ptr->~Type();
+    }
+  }
+
+  // Individual blocks are released by reset().
+  inline void free(void*) noexcept {}
+
+  // Bulk release; all pointers handed out since the last reset become invalid.
+  inline void reset() noexcept {
+    _current = _head;
+    _ptr = begin(_current);
+    _end = end(_current);
+    _used = 0;
+    _stats.inUse = 0;
+  }
+
+  // Bytes handed out since the last reset (excluding alignment padding).
+  size_t used() const noexcept { return _used; }
+
+  // inUse counts allocations since reset; highWater is in bytes.
+  const PoolStats& stats() const noexcept { return _stats; }
+
+private:
+  static std::byte* begin(Chunk* chunk) noexcept {
+    return reinterpret_cast<std::byte*>(chunk) + CHUNK_HEADER;
+  }
+
+  static std::byte* end(Chunk* chunk) noexcept {
+    return reinterpret_cast<std::byte*>(chunk) + chunk->size;
+  }
+
+  static std::byte* align(std::byte* ptr, size_t alignment) noexcept {
+    const uintptr_t addr = reinterpret_cast<uintptr_t>(ptr);
+    return ptr + (((addr + alignment - 1) & ~(alignment - 1)) - addr);
+  }
+
+  static Chunk* newChunk(size_t size) {
+    void* mem = nullptr;
+    if (posix_memalign(&mem, alignof(std::max_align_t), size)) {
+      throw std::bad_alloc();
+    }
+    Chunk* chunk = static_cast<Chunk*>(mem);
+    chunk->next = nullptr;
+    chunk->size = size;
+    return chunk;
+  }
+
+  // Moves to the next chunk that can hold size bytes, appending a new one if needed.
+  std::byte* advance(size_t size, size_t alignment) {
+    while (_current->next) {
+      _current = _current->next;
+      std::byte* ptr = align(begin(_current), alignment);
+      if (ptr + size <= end(_current)) {
+        _end = end(_current);
+        return ptr;
+      }
+    }
+    const size_t required = CHUNK_HEADER + size + alignment;
+    Chunk* chunk = newChunk(std::max(_chunkSize, required));
+    _current->next = chunk;
+    _current = chunk;
+    _end = end(_current);
+    ++_stats.fallbackCnt;
+    ++_stats.slabCnt;
+    _stats.capacity += chunk->size - CHUNK_HEADER;
+    return align(begin(_current), alignment);
+  }
+
+  const size_t _chunkSize;
+  Chunk* _head = nullptr;
+  Chunk* _current = nullptr;
+  std::byte* _ptr = nullptr;
+  std::byte* _end = nullptr;
+  size_t _used = 0;
+  PoolStats _stats;
+};
+
+} // namespace hw::utility
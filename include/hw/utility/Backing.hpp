@@ -0,0 +1,129 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <system_error>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <hw/utility/CPU.hpp>
+
+namespace hw::utility {
+
+// Backing-store options for pools; combine with |.
+enum PoolBackingFlags : uint32_t {
+  BACKING_DEFAULT       = 0,
+  BACKING_HUGE_PAGES    = 1 << 0, // 2MB pages via mmap(MAP_HUGETLB), transparent huge pages if none reserved
+  BACKING_PREFAULT      = 1 << 1, // fault every page in up front (MAP_POPULATE + touch)
+  BACKING_LOCK          = 1 << 2, // mlock the pool so it is never paged out
+  BACKING_CACHELINE_PAD = 1 << 3, // pad/align every block to a cache line to avoid false sharing
+};
+
+/**
+ * PoolBacking: backing-store policy for pool allocators (AllocatorTrivial).
+ * - Without flags memory comes from posix_memalign, as before.
+ * - BACKING_HUGE_PAGES maps 2MB pages. If the system has no hugetlbfs pages reserved the
+ *   region is mapped 2MB aligned and advised with MADV_HUGEPAGE instead, so the pool still
+ *   gets transparent huge pages where the kernel allows them.
+ * - BACKING_PREFAULT and BACKING_LOCK take the page-fault cost at construction and slab
+ *   growth rather than on first touch in the hot path.
+ * - A pool allocator asks for BLOCK_ALIGNMENT and releases with the same size it allocated.
+ */
+template <uint32_t FLAGS = BACKING_DEFAULT>
+struct PoolBacking {
+  static constexpr uint32_t flags = FLAGS;
+  static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+  static constexpr size_t BLOCK_ALIGNMENT = (FLAGS & BACKING_CACHELINE_PAD) ? ALIGNAS : 1;
+
+  static void* allocate(size_t size, size_t alignment) {
+    void* mem = (FLAGS & BACKING_HUGE_PAGES) ? mapHuge(size) : heap(size, alignment);
+    if constexpr ((FLAGS & BACKING_PREFAULT) != 0) {
+      prefault(mem, size);
+    }
+    if constexpr ((FLAGS & BACKING_LOCK) != 0) {
+      if (::mlock(mem, size) < 0) {
+        auto cerrno = errno;
+        unmap(mem, size);
+        throw std::system_error(std::error_code(cerrno, std::system_category()),
+          "mlock(" + std::to_string(size) + ") failed");
+      }
+    }
+    return mem;
+  }
+
+  static void release(void* mem, size_t size) noexcept {
+    if (!mem) return;
+    if constexpr ((FLAGS & BACKING_LOCK) != 0) {
+      ::munlock(mem, size);
+    }
+    unmap(mem, size);
+  }
+
+private:
+  static constexpr size_t roundHuge(size_t size) noexcept {
+    return (size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+  }
+
+  static void* heap(size_t size, size_t alignment) {
+    void* mem = nullptr;
+    if (posix_memalign(&mem, std::max(alignment, sizeof(void*)), size)) {
+      throw std::bad_alloc();
+    }
+    return mem;
+  }
+
+  static void* mapHuge(size_t size) {
+    const size_t length = roundHuge(size);
+    int populate = (FLAGS & BACKING_PREFAULT) ? MAP_POPULATE : 0;
+    void* mem = ::mmap(nullptr, length, PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (21 << MAP_HUGE_SHIFT) | populate, -1, 0);
+    if (mem != MAP_FAILED) {
+      return mem;
+    }
+    // No reserved huge pages: over-map, trim to a 2MB boundary and ask for THP.
+    void* raw = ::mmap(nullptr, length + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+    const uintptr_t base = reinterpret_cast<uintptr_t>(raw);
+    const uintptr_t aligned = (base + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    if (aligned > base) {
+      ::munmap(raw, aligned - base);
+    }
+    if (const size_t tail = base + length + HUGE_PAGE_SIZE - (aligned + length); tail) {
+      ::munmap(reinterpret_cast<void*>(aligned + length), tail);
+    }
+    mem = reinterpret_cast<void*>(aligned);
+    ::madvise(mem, length, MADV_HUGEPAGE);
+    return mem;
+  }
+
+  static void unmap(void* mem, size_t size) noexcept {
+    if constexpr ((FLAGS & BACKING_HUGE_PAGES) != 0) {
+      ::munmap(mem, roundHuge(size));
+    }
+    else {
+      ::free(mem);
+    }
+  }
+
+  // Writes one byte per page; MAP_POPULATE alone does not cover the THP fallback or heap memory.
+  static void prefault(void* mem, size_t size) noexcept {
+    static const size_t pageSize = ::sysconf(_SC_PAGESIZE);
+    volatile std::byte* ptr = static_cast<std::byte*>(mem);
+    for (size_t off = 0; off < size; off += pageSize) {
+      ptr[off] = std::byte{0};
+    }
+  }
+};
+
+using HeapBacking = PoolBacking<>;
+using HugePageBacking = PoolBacking<BACKING_HUGE_PAGES | BACKING_PREFAULT>;
+using LockedHugePageBacking = PoolBacking<BACKING_HUGE_PAGES | BACKING_PREFAULT | BACKING_LOCK>;
+
+} // namespace hw::utility
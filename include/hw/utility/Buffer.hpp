@@ -169,32 +169,32 @@ public:
     reset();
   }
 
-  void          reset       ()            { _read = _write = this->_buff; }
+  // Read/write positions are running byte counts; the mirror keeps [beginRead, +size())
+  // and [beginWrite, +available()) contiguous across the wrap.
+  void          reset       ()            { _read = _write = 0; }
   size_t        size        () const      { return _write - _read; }
-  size_t        available   () const      { return std::max(0, this->capacity() - size()); }
-  char *        beginWrite  () const      { return this->_buff + (((size_t)_write) & (SIZE-1)); }
-  const char *  beginRead   () const      { return this->_buff + (((size_t)_read) & (SIZE-1)); }
-  void          commitwrite (size_t size) { _write += size; }
+  size_t        available   () const      { return SIZE - size(); }
+  char *        beginWrite  () const      { return this->_buff + (_write & (SIZE-1)); }
+  const char *  beginRead   () const      { return this->_buff + (_read & (SIZE-1)); }
+  void          commitWrite (size_t size) { _write += size; }
   void          commitRead  (size_t size) { _read += size; }
 
 protected:
-  char * _read = nullptr;
-  char * _write = nullptr;
+  size_t _read = 0;
+  size_t _write = 0;
 };
 
 template <size_t SIZE>
 class UnboundedBuffer : public BaseBuffer<SIZE> {
   using Parent = BaseBuffer<SIZE>;
 public:
-  UnboundedBuffer (const  char *name) : Parent (name) {
-    _ptr = this->_buff;
-  }
+  UnboundedBuffer (const  char *name) : Parent (name) {}
 
-  char * getPtr() { return this->_buff + (((size_t)_ptr) & (SIZE-1)); }
+  char * getPtr() { return this->_buff + (_ptr & (SIZE-1)); }
   void advancePtr (size_t size) { _ptr += size; }
 
 protected:
-  char * _ptr = nullptr;
+  size_t _ptr = 0;
 };
 
 }
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <errno.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <hw/utility/Clock.hpp>
+
+namespace hw::utility {
+
+struct UdpConfig {
+  std::string address = "0.0.0.0";   // local address to bind; a multicast socket binds the group or any
+  uint16_t port = 0;
+  std::string group {};              // multicast group to join, empty for unicast
+  std::string interface = "0.0.0.0"; // interface address for the membership
+  int rcvBuf = 0;                    // SO_RCVBUF(FORCE) in bytes, 0 keeps the system default
+  bool timestamps = true;            // kernel receive timestamps (SO_TIMESTAMPNS)
+  size_t batch = 64;                 // datagrams per recvmmsg
+  size_t slotSize = 2048;            // bytes per datagram slot; longer datagrams are truncated
+};
+
+struct Datagram {
+  const uint8_t * data;
+  size_t len;
+  Timestamp rxTime;       // kernel receive time (ns since epoch), 0 when not enabled
+  sockaddr_in source;
+  bool truncated;         // larger than the slot
+};
+
+// Called with every batch read by one recvmmsg; data stays valid until the handler returns.
+using DatagramHandler = std::function<void(int fd, const Datagram * batch, size_t count)>;
+
+// Kernel receive time (SO_TIMESTAMPNS) carried in a received message's control data, 0 if absent.
+inline Timestamp receiveTime(const msghdr & hdr) noexcept {
+  for (const cmsghdr * cmsg = CMSG_FIRSTHDR(&hdr); cmsg; cmsg = CMSG_NXTHDR(const_cast<msghdr *>(&hdr), const_cast<cmsghdr *>(cmsg))) {
+    if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+      timespec ts;
+      std::memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+      return static_cast<Timestamp>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+    }
+  }
+  return 0;
+}
+
+// Control buffer for one received message with a receive timestamp.
+struct alignas(cmsghdr) DatagramControl {
+  char data[CMSG_SPACE(sizeof(timespec))];
+};
+
+/**
+ * DatagramReceiver: recvmmsg into a preallocated set of slots.
+ * - All buffers, iovecs, address and control blocks are allocated once; a receive only
+ *   resets the per-message lengths the kernel overwrote.
+ * - receive() returns the number of datagrams read (0 when none are pending) or -errno.
+ */
+class DatagramReceiver {
+public:
+  DatagramReceiver(size_t batch, size_t slotSize)
+    : _slotSize(slotSize), _buffer(batch * slotSize), _msgs(batch), _iov(batch),
+      _addrs(batch), _controls(batch), _batch(batch)
+  {
+    if (batch == 0 || slotSize == 0) {
+      throw std::invalid_argument("DatagramReceiver: batch and slot size must be positive");
+    }
+    for (size_t i = 0; i < batch; ++i) {
+      _iov[i].iov_base = _buffer.data() + i * slotSize;
+      _iov[i].iov_len = slotSize;
+      msghdr & hdr = _msgs[i].msg_hdr;
+      hdr.msg_iov = &_iov[i];
+      hdr.msg_iovlen = 1;
+      hdr.msg_name = &_addrs[i];
+      hdr.msg_control = _controls[i].data;
+      rearm(i);
+    }
+  }
+
+  DatagramReceiver(const DatagramReceiver &) = delete;
+  DatagramReceiver & operator = (const DatagramReceiver &) = delete;
+
+  int receive(int fd) {
+    const int n = ::recvmmsg(fd, _msgs.data(), static_cast<unsigned>(_msgs.size()), MSG_DONTWAIT, nullptr);
+    if (n <= 0) {
+      return n == 0 || errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -errno;
+    }
+    for (int i = 0; i < n; ++i) {
+      const msghdr & hdr = _msgs[i].msg_hdr;
+      Datagram & dgram = _batch[i];
+      dgram.data = static_cast<const uint8_t *>(_iov[i].iov_base);
+      dgram.len = std::min<size_t>(_msgs[i].msg_len, _slotSize);
+      dgram.rxTime = receiveTime(hdr);
+      dgram.source = _addrs[i];
+      dgram.truncated = (hdr.msg_flags & MSG_TRUNC) != 0;
+      rearm(i);
+    }
+    return n;
+  }
+
+  const Datagram * batch() const noexcept { return _batch.data(); }
+  size_t capacity() const noexcept { return _msgs.size(); }
+
+private:
+  void rearm(size_t i) noexcept {
+    msghdr & hdr = _msgs[i].msg_hdr;
+    hdr.msg_namelen = sizeof(sockaddr_in);
+    hdr.msg_controllen = sizeof(DatagramControl::data);
+    hdr.msg_flags = 0;
+  }
+
+  size_t _slotSize;
+  std::vector<uint8_t> _buffer;
+  std::vector<mmsghdr> _msgs;
+  std::vector<iovec> _iov;
+  std::vector<sockaddr_in> _addrs;
+  std::vector<DatagramControl> _controls;
+  std::vector<Datagram> _batch;
+};
+
+/**
+ * SequenceGapDetector: per-feed sequence tracking for datagram handlers.
+ * - The first number seen (or the one given to reset()) sets the expectation.
+ * - check() reports skipped numbers [from, to) to the gap handler before accepting a jump;
+ *   numbers below the expectation (duplicates, A/B feed copies) come back STALE.
+ */
+class SequenceGapDetector {
+public:
+  enum Result { IN_ORDER, GAP, STALE };
+  using GapHandler = std::function<void(uint64_t from, uint64_t to)>;
+
+  explicit SequenceGapDetector(GapHandler onGap = {}) : _onGap(std::move(onGap)) {}
+
+  Result check(uint64_t seq) {
+    if (!_synced) [[unlikely]] {
+      _synced = true;
+      _expected = seq;
+    }
+    if (seq == _expected) [[likely]] {
+      ++_expected;
+      return IN_ORDER;
+    }
+    if (seq < _expected) {
+      ++_stale;
+      return STALE;
+    }
+    ++_gaps;
+    _missing += seq - _expected;
+    if (_onGap) {
+      _onGap(_expected, seq);
+    }
+    _expected = seq + 1;
+    return GAP;
+  }
+
+  void reset(uint64_t next) noexcept {
+    _synced = true;
+    _expected = next;
+  }
+
+  uint64_t expected() const noexcept { return _expected; }
+  uint64_t gaps() const noexcept { return _gaps; }
+  uint64_t missing() const noexcept { return _missing; }
+  uint64_t stale() const noexcept { return _stale; }
+
+private:
+  GapHandler _onGap;
+  uint64_t _expected = 0;
+  uint64_t _gaps = 0;
+  uint64_t _missing = 0;
+  uint64_t _stale = 0;
+  bool _synced = false;
+};
+
+} // namespace hw::utility
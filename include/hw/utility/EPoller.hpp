@@ -2,17 +2,26 @@
 
 #include <sys/epoll.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <arpa/inet.h>
 #include <netinet/in.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <algorithm>
+#include <cstring>
 #include <vector>
 #include <string>
 #include <functional>
+#include <memory>
 #include <unordered_map>
 #include <stdexcept>
 
+#include <hw/utility/Buffer.hpp>
+#include <hw/utility/Clock.hpp>
+#include <hw/utility/Datagram.hpp>
+#include <hw/utility/Framer.hpp>
+
 namespace hw::utility {
 
 enum class SocketState {
@@ -20,21 +29,90 @@ enum class SocketState {
   ACCEPT_READY,
   CONNECTED,    // connection established
   DISCONNECTED, // remote end close or error
-  ERROR         // unrecoverable error
+  ERROR,        // unrecoverable error
+  WRITE_READY   // framed connection: send queue drained after send() refused bytes or the socket pushed back
 };
 
 enum class SocketType {
-  TCP_CLIENT, TCP_SERVER
+  TCP_CLIENT, TCP_SERVER, UDP
 };
 
 using EventHandler = std::function<void(int fd, SocketState state, int err)>;
 
+// Low-latency mode: connected sockets are read directly every poll() instead of through epoll.
+struct BusyPollConfig {
+  bool enabled = false;
+  int busyPollUs = 50;                  // SO_BUSY_POLL: time the kernel may spin on the NIC queue per recv
+  int budget = 64;                      // SO_BUSY_POLL_BUDGET: packets per busy-poll pass
+  size_t rxBufferSize = 64 * 1024;      // per-connection staging buffer of stageReads() sockets
+  CPUCycles epollIntervalCycles = 100'000; // minimum TSC distance between epoll_wait calls
+};
+
+/**
+ * EPoller: epoll reactor for TCP sockets.
+ * - Default mode: every poll() is one epoll_wait; handlers read with ::read or read().
+ * - Busy-poll mode (BusyPollConfig::enabled): accepted and connected sockets get SO_BUSY_POLL /
+ *   SO_PREFER_BUSY_POLL and leave the epoll set. poll() checks each of them with a non-blocking
+ *   one-byte MSG_PEEK and calls the handler with DATA_READY while bytes (or EOF) are pending,
+ *   so handlers read as in default mode. A socket marked with stageReads() is instead received
+ *   with recvmsg into a staging buffer, saving the handler's own syscall; its handler must
+ *   drain through read(). epoll is left with listen sockets and pending connects, and
+ *   epoll_wait runs at most once per epollIntervalCycles.
+ * - Socket options that need CAP_NET_ADMIN are best effort; the direct-read loop works without them.
+ * - Framed connections (frame()): the poller owns a mirrored receive and send ring per socket.
+ *   Received bytes are split by a Framer and delivered whole to a FrameHandler; send() queues
+ *   into the send ring and flush() (dispatcher batch end) writes each queue with one syscall.
+ *   EPOLLOUT is armed only while a send queue is non-empty.
+ * - UDP sockets (bindUdp()): unicast or multicast; every readiness drains the socket with
+ *   recvmmsg into preallocated slots and hands each batch to a DatagramHandler. In busy-poll
+ *   mode they are read directly like TCP sockets. Without a DatagramHandler the socket is raw:
+ *   the handler gets DATA_READY and reads it itself (e.g. straight into ether slots).
+ */
 class EPoller {
+  struct Stream;
+  struct Udp;
+
   struct Connection {
     int fd = -1;
     bool connected = false;
     SocketType type = SocketType::TCP_CLIENT;
     EventHandler handler;
+    uint32_t events = 0;   // registered epoll interest
+    // busy-poll mode only
+    bool hot = false;
+    bool staged = false;   // stageReads(): received into rx, handler drains through read()
+    bool eof = false;
+    size_t rxOff = 0;
+    size_t rxLen = 0;
+    std::vector<uint8_t> rx {};
+    std::unique_ptr<Stream> stream {};  // framed connections only
+    std::unique_ptr<Udp> udp {};        // UDP sockets only
+  };
+
+public:
+  static constexpr size_t STREAM_BUFFER_SIZE = 64 * 1024;
+
+private:
+  struct Stream {
+    Stream(int fd, Framer framer, FrameHandler onFrame)
+      : rx(frmt::format("epoller.{}.{}.rx", ::getpid(), fd).c_str()),
+        tx(frmt::format("epoller.{}.{}.tx", ::getpid(), fd).c_str()),
+        framer(std::move(framer)), onFrame(std::move(onFrame)) {}
+
+    BoundedBuffer<STREAM_BUFFER_SIZE> rx;
+    BoundedBuffer<STREAM_BUFFER_SIZE> tx;
+    Framer framer;
+    FrameHandler onFrame;
+    bool txDirty = false;   // listed in _txDirty
+    bool txBlocked = false; // send() refused or socket pushed back; report WRITE_READY once drained
+  };
+
+  struct Udp {
+    Udp(size_t batch, size_t slotSize, DatagramHandler onBatch)
+      : receiver(batch, slotSize), onBatch(std::move(onBatch)) {}
+
+    DatagramReceiver receiver;
+    DatagramHandler onBatch;
   };
 
   int _epfd = -1;
@@ -48,23 +126,254 @@ class EPoller {
   static constexpr int MAX_EVENTS = 64;
   epoll_event _events[MAX_EVENTS];
 
+  BusyPollConfig _busy;
+  std::vector<Connection *> _hot;   // busy-poll mode: sockets read directly, nullptr once closed
+  bool _hotDirty = false;
+  CPUCycles _lastWait = 0;
+
+  std::vector<int> _txDirty;                       // framed sockets with sends queued this batch
+  std::vector<std::unique_ptr<Stream>> _retired;   // streams of sockets closed inside a callback
+  std::vector<std::unique_ptr<Udp>> _retiredUdp;
+
 static int make_address (sockaddr_in & addr, const std::string & host, uint16_t port) {
   addr.sin_family = AF_INET;
   addr.sin_port = htons(port);
   return ::inet_pton(AF_INET, host.c_str(), &addr.sin_addr);
 }
 
+static int membership(int sock, int option, const std::string & group, const std::string & interface) {
+  ip_mreq mreq {};
+  if (::inet_pton(AF_INET, group.c_str(), &mreq.imr_multiaddr) <= 0 ||
+      ::inet_pton(AF_INET, interface.c_str(), &mreq.imr_interface) <= 0) {
+    errno = EINVAL;
+    return -1;
+  }
+  return ::setsockopt(sock, IPPROTO_IP, option, &mreq, sizeof(mreq));
+}
+
 static std::pair<int, int> return_error(int sock) {
   int ec = errno;
   ::close (sock);
   return std::make_pair(-1, ec);
 }
 
+  // Busy-poll mode: takes a connected socket out of epoll and reads it from poll() directly.
+  void makeHot(Connection & conn) {
+#ifdef SO_BUSY_POLL
+    ::setsockopt(conn.fd, SOL_SOCKET, SO_BUSY_POLL, &_busy.busyPollUs, sizeof(_busy.busyPollUs));
+#endif
+#ifdef SO_PREFER_BUSY_POLL
+    int prefer = 1;
+    ::setsockopt(conn.fd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &prefer, sizeof(prefer));
+#endif
+#ifdef SO_BUSY_POLL_BUDGET
+    ::setsockopt(conn.fd, SOL_SOCKET, SO_BUSY_POLL_BUDGET, &_busy.budget, sizeof(_busy.budget));
+#endif
+    conn.hot = true;
+    if (conn.staged) {
+      conn.rx.resize(_busy.rxBufferSize);
+    }
+    _hot.push_back(&conn);
+  }
+
+  // Wanted epoll interest: input unless read directly (busy-poll), output while sends are queued.
+  void updateEvents(Connection & conn) {
+    uint32_t events = conn.hot ? 0 : EPOLLIN | EPOLLRDHUP;
+    if (conn.stream && conn.stream->tx.size()) {
+      events |= EPOLLOUT;
+    }
+    if (events == conn.events) {
+      return;
+    }
+    epoll_event ev {};
+    ev.events = events;
+    ev.data.ptr = &conn;
+    ::epoll_ctl(_epfd, conn.events == 0 ? EPOLL_CTL_ADD : events == 0 ? EPOLL_CTL_DEL : EPOLL_CTL_MOD, conn.fd, &ev);
+    conn.events = events;
+  }
+
+  // False once the socket is gone (closed by a callback or after an error).
+  bool alive(int fd, const Stream * stream) const {
+    auto it = _connections.find(fd);
+    return it != _connections.end() && it->second.stream.get() == stream;
+  }
+
+  void fail(Connection & conn, SocketState state, int err) {
+    const int fd = conn.fd;
+    const Stream * stream = conn.stream.get();
+    conn.handler(fd, state, err);
+    if (alive(fd, stream)) {
+      close(fd);
+    }
+  }
+
+  // Framed input: drains the socket into the receive ring, delivering whole frames as they complete.
+  void receive(Connection & conn) {
+    Stream & st = *conn.stream;
+    const int fd = conn.fd;
+    for (;;) {
+      const size_t room = st.rx.available();
+      if (room == 0) [[unlikely]] {
+        fail(conn, SocketState::ERROR, EMSGSIZE); // frame larger than the ring
+        return;
+      }
+      ssize_t n = ::read(fd, st.rx.beginWrite(), room);
+      if (n > 0) [[likely]] {
+        st.rx.commitWrite(static_cast<size_t>(n));
+        if (!deliver(conn) || static_cast<size_t>(n) < room) {
+          return;
+        }
+      }
+      else if (n == 0) {
+        fail(conn, SocketState::DISCONNECTED, 0);
+        return;
+      }
+      else {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+          fail(conn, SocketState::ERROR, errno);
+        }
+        return;
+      }
+    }
+  }
+
+  bool deliver(Connection & conn) {
+    Stream & st = *conn.stream;
+    const int fd = conn.fd;
+    while (st.rx.size()) {
+      const size_t len = st.framer(st.rx.beginRead(), st.rx.size());
+      if (len == 0) {
+        break;
+      }
+      if (len == FRAME_ERROR) [[unlikely]] {
+        fail(conn, SocketState::ERROR, EBADMSG);
+        return false;
+      }
+      const char * frame = st.rx.beginRead();
+      st.rx.commitRead(len); // the bytes stay put until the next read
+      st.onFrame(fd, frame, len);
+      if (!alive(fd, &st)) [[unlikely]] {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Reads batches until the socket is empty (a short batch) or the handler closes it.
+  void receiveDatagrams(Connection & conn) {
+    Udp & udp = *conn.udp;
+    const int fd = conn.fd;
+    for (;;) {
+      const int n = udp.receiver.receive(fd);
+      if (n < 0) [[unlikely]] {
+        conn.handler(fd, SocketState::ERROR, -n); // e.g. ICMP errors on unicast; the socket stays open
+        return;
+      }
+      if (n == 0) {
+        return;
+      }
+      udp.onBatch(fd, udp.receiver.batch(), static_cast<size_t>(n));
+      auto it = _connections.find(fd);
+      if (it == _connections.end() || it->second.udp.get() != &udp || static_cast<size_t>(n) < udp.receiver.capacity()) {
+        return;
+      }
+    }
+  }
+
+  // Writes the whole send queue (contiguous thanks to the mirror) and re-arms EPOLLOUT as needed.
+  void drain(Connection & conn) {
+    Stream & st = *conn.stream;
+    while (st.tx.size()) {
+      ssize_t n = ::write(conn.fd, st.tx.beginRead(), st.tx.size());
+      if (n > 0) [[likely]] {
+        st.tx.commitRead(static_cast<size_t>(n));
+        continue;
+      }
+      if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+        fail(conn, SocketState::ERROR, errno);
+        return;
+      }
+      st.txBlocked = true;
+      break;
+    }
+    updateEvents(conn);
+    if (st.tx.size() == 0 && st.txBlocked) {
+      st.txBlocked = false;
+      conn.handler(conn.fd, SocketState::WRITE_READY, 0);
+    }
+  }
+
+  // One non-blocking syscall per hot socket; the handler sees DATA_READY while bytes or EOF
+  // remain (level-triggered, as with epoll): peeked in the socket, or staged in rx.
+  int pollHot() {
+    int n = 0;
+    for (size_t i = 0; i < _hot.size(); ++i) {
+      Connection * conn = _hot[i];
+      if (!conn) [[unlikely]] continue;
+      if (conn->stream) {
+        receive(*conn);
+        continue;
+      }
+      if (conn->udp) {
+        receiveDatagrams(*conn);
+        continue;
+      }
+      if (conn->type == SocketType::UDP) {
+        // raw UDP: a zero-length peek tells whether a datagram is pending without consuming it
+        if (::recv(conn->fd, nullptr, 0, MSG_PEEK | MSG_DONTWAIT) < 0) [[likely]] continue;
+        ++n;
+        conn->handler(conn->fd, SocketState::DATA_READY, 0);
+        continue;
+      }
+      if (!conn->staged) {
+        // nothing consumed: the handler may read the socket any way it likes
+        char byte;
+        if (::recv(conn->fd, &byte, 1, MSG_PEEK | MSG_DONTWAIT) < 0) {
+          if (errno == EAGAIN || errno == EWOULDBLOCK) [[likely]] continue;
+          const int err = errno;
+          const int fd = conn->fd;
+          conn->handler(fd, SocketState::ERROR, err);
+          close(fd);
+          continue;
+        }
+      }
+      else if (conn->rxOff == conn->rxLen && !conn->eof) {
+        iovec iov {conn->rx.data(), conn->rx.size()};
+        msghdr msg {};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        ssize_t rc = ::recvmsg(conn->fd, &msg, MSG_DONTWAIT);
+        if (rc < 0) {
+          if (errno == EAGAIN || errno == EWOULDBLOCK) [[likely]] continue;
+          const int err = errno;
+          const int fd = conn->fd;
+          conn->handler(fd, SocketState::ERROR, err);
+          close(fd);
+          continue;
+        }
+        conn->rxOff = 0;
+        conn->rxLen = static_cast<size_t>(rc);
+        conn->eof = rc == 0;
+      }
+      ++n;
+      conn->handler(conn->fd, SocketState::DATA_READY, 0);
+    }
+    if (_hotDirty) [[unlikely]] {
+      std::erase(_hot, nullptr);
+      _hotDirty = false;
+    }
+    return n;
+  }
+
 public:
   EPoller() {
     _epfd = epoll_create1(0);
   }
 
+  explicit EPoller(const BusyPollConfig & busy) : EPoller() {
+    _busy = busy;
+  }
+
   ~EPoller() {
     for (auto & [sock, _] : _connections) {
       ::close(sock);
@@ -89,7 +398,8 @@ public:
 
     // Insert first to get stable address
     auto [it, _] = _connections.emplace(sock, Connection{sock, true, SocketType::TCP_SERVER, handler});
-    
+    it->second.events = EPOLLIN;
+
     epoll_event ev {};
     ev.events = EPOLLIN;
     ev.data.ptr = &it->second; // Fast pointer access
@@ -105,12 +415,17 @@ public:
     int sock = ::accept4(svrsock, reinterpret_cast<sockaddr *>(&addr), &addrlen, SOCK_NONBLOCK);
     if (sock > 0) {
       auto [it, _] = _connections.emplace(sock, Connection{sock, true, SocketType::TCP_CLIENT, handler});
-      
+      if (_busy.enabled) {
+        makeHot(it->second);
+        return std::make_pair(sock, 0);
+      }
+
+      it->second.events = EPOLLIN | EPOLLRDHUP;
       epoll_event ev {};
       ev.events = EPOLLIN | EPOLLRDHUP;
       ev.data.ptr = &it->second; // Fast pointer access
       ::epoll_ctl(_epfd, EPOLL_CTL_ADD, sock, &ev);
-      
+
       return std::make_pair(sock, 0);
     }
     return return_error(-1);
@@ -129,7 +444,8 @@ public:
     }
 
     auto [it, _] = _connections.emplace(sock, Connection{sock, false, SocketType::TCP_CLIENT, handler});
-    
+    it->second.events = EPOLLOUT;
+
     epoll_event ev {};
     ev.events = EPOLLOUT;
     ev.data.ptr = &it->second; // Fast pointer access
@@ -147,6 +463,11 @@ public:
     ::shutdown (sock, SHUT_WR);
     ::close(sock);
 
+    if (it->second.hot) {
+      std::replace(_hot.begin(), _hot.end(), &it->second, static_cast<Connection *>(nullptr));
+      _hotDirty = true;
+    }
+
     // CRITICAL FIX: If we are currently polling, we must remove any pending
     // references to this connection in the current event batch to prevent Use-After-Free.
     // This scan is extremely fast (max 64 integers in L1 cache).
@@ -162,10 +483,132 @@ public:
         }
     }
 
+    // a frame callback may be closing its own socket: keep the stream until poll() returns
+    if (it->second.stream) {
+      _retired.push_back(std::move(it->second.stream));
+    }
+    if (it->second.udp) {
+      _retiredUdp.push_back(std::move(it->second.udp));
+    }
+
     _connections.erase(it); // Immediate deletion
     return 0;
   }
 
+  // Hands the socket's input and output to the poller: bytes are read into a receive ring and
+  // passed to onFrame one frame at a time, the handler only sees DISCONNECTED, ERROR and
+  // WRITE_READY. Returns -1 for an unknown socket.
+  int frame (int sock, Framer framer, FrameHandler onFrame) {
+    auto it = _connections.find(sock);
+    if (it == _connections.end() || it->second.type != SocketType::TCP_CLIENT) return -1;
+    it->second.stream = std::make_unique<Stream>(sock, std::move(framer), std::move(onFrame));
+    return 0;
+  }
+
+  // Framed sockets: queues bytes for the next flush(). Returns ENOBUFS (nothing queued) when
+  // the send ring cannot take them, -1 for an unknown or unframed socket.
+  int send (int sock, const void *data, size_t datalen) {
+    auto it = _connections.find(sock);
+    if (it == _connections.end() || !it->second.stream) [[unlikely]] return -1;
+    Stream & st = *it->second.stream;
+    if (datalen > st.tx.available()) [[unlikely]] {
+      st.txBlocked = true;
+      return ENOBUFS;
+    }
+    std::memcpy(st.tx.beginWrite(), data, datalen);
+    st.tx.commitWrite(datalen);
+    if (!st.txDirty) {
+      st.txDirty = true;
+      _txDirty.push_back(sock);
+    }
+    return 0;
+  }
+
+  // Gathering variant of send(): all segments are queued or none.
+  int send (int sock, const iovec *iov, int iovcnt) {
+    auto it = _connections.find(sock);
+    if (it == _connections.end() || !it->second.stream) [[unlikely]] return -1;
+    size_t total = 0;
+    for (int i = 0; i < iovcnt; ++i) total += iov[i].iov_len;
+    if (total > it->second.stream->tx.available()) [[unlikely]] {
+      it->second.stream->txBlocked = true;
+      return ENOBUFS;
+    }
+    for (int i = 0; i < iovcnt; ++i) {
+      send(sock, iov[i].iov_base, iov[i].iov_len);
+    }
+    return 0;
+  }
+
+  size_t sendQueueSize (int sock) const {
+    auto it = _connections.find(sock);
+    return it != _connections.end() && it->second.stream ? it->second.stream->tx.size() : 0;
+  }
+
+  // Busy-poll mode: receive this TCP socket into a staging buffer (one syscall per arrival
+  // instead of a peek plus the handler's read). Its handler must read only through read(),
+  // bytes taken with ::read would skip the staged ones. Returns -1 for an unknown socket.
+  int stageReads (int sock) {
+    auto it = _connections.find(sock);
+    if (it == _connections.end() || it->second.type != SocketType::TCP_CLIENT) return -1;
+    Connection & conn = it->second;
+    conn.staged = true;
+    if (conn.hot && conn.rx.empty()) {
+      conn.rx.resize(_busy.rxBufferSize);
+    }
+    return 0;
+  }
+
+  // Opens a UDP socket bound to config.address:port (the group address for multicast) and joins
+  // config.group if set. handler receives ERROR for socket errors; batches go to onBatch, or
+  // with an empty onBatch the handler gets DATA_READY and reads the socket itself.
+  std::pair<int, int> bindUdp (const UdpConfig & config, const DatagramHandler & onBatch, const EventHandler & handler) {
+    int sock = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (sock < 0) {
+      return return_error(-1);
+    }
+    int optval = 1;
+    ::setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval));
+    if (config.rcvBuf > 0 &&
+        ::setsockopt(sock, SOL_SOCKET, SO_RCVBUFFORCE, &config.rcvBuf, sizeof(config.rcvBuf)) < 0) {
+      ::setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &config.rcvBuf, sizeof(config.rcvBuf)); // capped by rmem_max
+    }
+    if (config.timestamps) {
+      ::setsockopt(sock, SOL_SOCKET, SO_TIMESTAMPNS, &optval, sizeof(optval));
+    }
+
+    sockaddr_in addr {};
+    // binding the group address keeps other groups on the same port out of this socket
+    if (make_address(addr, config.group.empty() ? config.address : config.group, config.port) <= 0 ||
+        ::bind(sock, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+      return return_error(sock);
+    }
+    if (!config.group.empty() && membership(sock, IP_ADD_MEMBERSHIP, config.group, config.interface) < 0) {
+      return return_error(sock);
+    }
+
+    auto [it, _] = _connections.emplace(sock, Connection{sock, true, SocketType::UDP, handler});
+    if (onBatch) {
+      it->second.udp = std::make_unique<Udp>(config.batch, config.slotSize, onBatch);
+    }
+    if (_busy.enabled) {
+      makeHot(it->second);
+    }
+    else {
+      updateEvents(it->second);
+    }
+    return std::make_pair(sock, 0);
+  }
+
+  // Multicast membership for a UDP socket; 0 or errno.
+  int join (int sock, const std::string & group, const std::string & interface = "0.0.0.0") {
+    return membership(sock, IP_ADD_MEMBERSHIP, group, interface) < 0 ? errno : 0;
+  }
+
+  int leave (int sock, const std::string & group, const std::string & interface = "0.0.0.0") {
+    return membership(sock, IP_DROP_MEMBERSHIP, group, interface) < 0 ? errno : 0;
+  }
+
   bool connected (int sock) const {
     auto it =_connections.find(sock);
     return it != _connections.end() && it->second.connected;
@@ -191,7 +634,65 @@ public:
     return rc;
   }
 
+  // Same return convention as write(): 0 with bytes_read (0 means the peer closed),
+  // EAGAIN when nothing is pending, errno otherwise. Handlers that read through the
+  // poller instead of ::read work unchanged with URingPoller.
+  int read (int sock, void *data, size_t datalen, size_t & bytes_read) {
+    if (_busy.enabled) {
+      if (auto it = _connections.find(sock); it != _connections.end() && it->second.staged) {
+        Connection & conn = it->second;
+        if (conn.rxOff < conn.rxLen) {
+          bytes_read = std::min(datalen, conn.rxLen - conn.rxOff);
+          std::memcpy(data, conn.rx.data() + conn.rxOff, bytes_read);
+          conn.rxOff += bytes_read;
+          return 0;
+        }
+        if (conn.eof) {
+          bytes_read = 0;
+          return 0;
+        }
+      }
+    }
+    ssize_t n = ::read(sock, data, datalen);
+    if (n >= 0) [[likely]] {
+      bytes_read = static_cast<size_t>(n);
+      return 0;
+    }
+    bytes_read = 0;
+    const int rc = errno;
+    return rc == EWOULDBLOCK ? EAGAIN : rc;
+  }
+
+  // Writes the send queues filled since the last flush; write() itself is not buffered.
+  void flush () {
+    for (size_t i = 0; i < _txDirty.size(); ++i) {
+      auto it = _connections.find(_txDirty[i]);
+      if (it != _connections.end() && it->second.stream && it->second.stream->txDirty) {
+        it->second.stream->txDirty = false;
+        drain(it->second);
+      }
+    }
+    _txDirty.clear();
+    _retired.clear();
+    _retiredUdp.clear();
+  }
+
   int poll (int timeout_ms = 0) {
+    int hot = 0;
+    if (_busy.enabled) {
+      hot = pollHot();
+      const CPUCycles now = SystemClockTSC::tsc();
+      if (now - _lastWait < _busy.epollIntervalCycles) {
+        _retired.clear();
+        _retiredUdp.clear();
+        return hot;
+      }
+      _lastWait = now;
+      if (hot > 0 || !_hot.empty()) {
+        timeout_ms = 0; // never sleep in epoll while sockets are read directly
+      }
+    }
+
     int n = ::epoll_wait(_epfd, _events, MAX_EVENTS, timeout_ms);
     if (n < 0) return -1;
 
@@ -211,25 +712,38 @@ public:
       int sock = conn->fd;
 
       if (ev.events & EPOLLIN) [[likely]] {
-        conn->handler(sock, conn->type == SocketType::TCP_SERVER ? SocketState::ACCEPT_READY : SocketState::DATA_READY, 0);
+        if (conn->stream) {
+          receive(*conn);
+        }
+        else if (conn->udp) {
+          receiveDatagrams(*conn);
+        }
+        else {
+          conn->handler(sock, conn->type == SocketType::TCP_SERVER ? SocketState::ACCEPT_READY : SocketState::DATA_READY, 0);
+        }
         
         // SAFETY: Check again. The handler might have called close(sock) (suicide)
         // or close() on another socket that happens to be next in the list.
         if (_events[i].data.ptr == nullptr) continue;
       }
 
+      if ((ev.events & EPOLLOUT) && conn->stream && conn->connected) {
+        drain(*conn); // queued output can move again
+        continue;
+      }
+
       if (ev.events & EPOLLOUT) [[unlikely]] {
         int err = 0;
         socklen_t len = sizeof(err);
         if (::getsockopt(sock, SOL_SOCKET, SO_ERROR, &err, &len) == 0 && err == 0) [[likely]] {
           conn->connected = true;
           conn->handler(sock, SocketState::CONNECTED, 0);
-          
+
           if (_events[i].data.ptr != nullptr) {
-             epoll_event mod_ev {};
-             mod_ev.events = EPOLLIN | EPOLLRDHUP;
-             mod_ev.data.ptr = conn; 
-             ::epoll_ctl(_epfd, EPOLL_CTL_MOD, sock, &mod_ev);
+             if (_busy.enabled) {
+               makeHot(*conn);
+             }
+             updateEvents(*conn); // EPOLLIN (or nothing when read directly), EPOLLOUT if sends queued
           }
         }
         else {
@@ -240,7 +754,9 @@ public:
     }
     
     _current_event_count = 0; // Reset
-    return n;
+    _retired.clear();
+    _retiredUdp.clear();
+    return n + hot;
   }
 
 
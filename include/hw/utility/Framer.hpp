@@ -0,0 +1,62 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <type_traits>
+
+namespace hw::utility {
+
+/**
+ * Framer: splits a byte stream into messages.
+ * - Called with the unread bytes of a connection (always contiguous); returns the length of
+ *   the first complete frame, 0 if more bytes are needed, FRAME_ERROR if the stream is corrupt.
+ * - Stateless: the same bytes are offered again until a frame completes.
+ */
+using Framer = std::function<size_t(const char * data, size_t len)>;
+using FrameHandler = std::function<void(int fd, const char * frame, size_t len)>;
+
+inline constexpr size_t FRAME_ERROR = std::numeric_limits<size_t>::max();
+
+/**
+ * LengthPrefixFramer: frames that carry their length in an integer header.
+ * - LengthType: header integer, NETWORK_ORDER for big-endian.
+ * - OFFSET: bytes before the length field (e.g. a message type).
+ * - INCLUDES_HEADER: whether the length counts OFFSET and the length field itself.
+ */
+template <typename LengthType, bool NETWORK_ORDER = true, bool INCLUDES_HEADER = false, size_t OFFSET = 0>
+struct LengthPrefixFramer {
+  static_assert(std::is_unsigned_v<LengthType>);
+  static constexpr size_t HEADER_SIZE = OFFSET + sizeof(LengthType);
+
+  size_t operator()(const char * data, size_t len) const noexcept {
+    if (len < HEADER_SIZE) {
+      return 0;
+    }
+    LengthType raw;
+    std::memcpy(&raw, data + OFFSET, sizeof(raw));
+    if constexpr (NETWORK_ORDER != (std::endian::native == std::endian::big)) {
+      raw = std::byteswap(raw);
+    }
+    const size_t frame = INCLUDES_HEADER ? static_cast<size_t>(raw) : HEADER_SIZE + raw;
+    if (frame < HEADER_SIZE) [[unlikely]] {
+      return FRAME_ERROR;
+    }
+    return frame <= len ? frame : 0;
+  }
+};
+
+// DelimiterFramer: frames end with (and include) a delimiter byte, e.g. a newline.
+struct DelimiterFramer {
+  char delimiter = '\n';
+
+  size_t operator()(const char * data, size_t len) const noexcept {
+    const void * end = std::memchr(data, delimiter, len);
+    return end ? static_cast<const char *>(end) - data + 1 : 0;
+  }
+};
+
+} // namespace hw::utility
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <algorithm>
+
+#include <hw/utility/Allocator.hpp>
+#include <hw/utility/SwissTable.hpp>
+
+namespace hw::utility {
+
+/**
+ * HandlePool: fixed-capacity pool addressed by 32-bit handles instead of pointers.
+ * - Handle = generation (upper 32 - INDEX_BITS bits) | slot index + 1 (lower INDEX_BITS bits);
+ *   0 is the null handle.
+ * - free() bumps the slot generation, so a stale handle resolves to nullptr instead of
+ *   aliasing a later occupant, as long as its slot has been reused fewer than
+ *   2^(32 - INDEX_BITS) times since (4096 with the default 20 index bits). The generation
+ *   then wraps and a handle held that long validates again: size INDEX_BITS to the pool,
+ *   every bit not needed for the index is generation.
+ * - All blocks live in one contiguous allocation; the pool plus anything storing handles
+ *   can be copied or snapshotted byte for byte (Type permitting).
+ * - Same allocate/construct/destroy/free split as AllocatorTrivial.
+ */
+template <typename Type, uint32_t INDEX_BITS = 20>
+class HandlePool {
+  static_assert(INDEX_BITS > 0 && INDEX_BITS < 32);
+
+  static constexpr size_t ALIGNMENT = std::max(alignof(Type), alignof(uint32_t));
+  static constexpr size_t BLOCK_SIZE = (std::max(sizeof(Type), sizeof(uint32_t)) + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+public:
+  using Handle = uint32_t;
+  static constexpr Handle NULL_HANDLE = 0;
+  static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+  static constexpr uint32_t GENERATION_MASK = ~INDEX_MASK >> INDEX_BITS;
+  static constexpr size_t MAX_CAPACITY = INDEX_MASK;
+
+  explicit HandlePool(size_t capacity) : _capacity(capacity) {
+    if (_capacity == 0 || _capacity > MAX_CAPACITY) {
+      throw std::invalid_argument("HandlePool: invalid capacity " + std::to_string(capacity));
+    }
+    if (posix_memalign(reinterpret_cast<void**>(&_data), std::max(ALIGNMENT, sizeof(void*)), _capacity * BLOCK_SIZE)) {
+      throw std::bad_alloc();
+    }
+    _generations = static_cast<uint32_t*>(std::calloc(_capacity, sizeof(uint32_t)));
+    if (!_generations) {
+      ::free(_data);
+      throw std::bad_alloc();
+    }
+    // free list threaded through idle blocks as slot indices; first allocation gets slot 0
+    for (size_t i = 0; i < _capacity; ++i) {
+      next(i) = static_cast<uint32_t>(i + 1);
+    }
+    _free = 0;
+    _stats.capacity = _capacity;
+  }
+
+  ~HandlePool() {
+    ::free(_generations);
+    ::free(_data);
+  }
+
+  HandlePool(const HandlePool&) = delete;
+  HandlePool& operator=(const HandlePool&) = delete;
+  HandlePool(HandlePool&&) = delete;
+  HandlePool& operator=(HandlePool&&) = delete;
+
+  // Returns handle to uninitialized memory, or NULL_HANDLE when the pool is exhausted.
+  inline Handle allocate() noexcept {
+    if (_free == _capacity) [[unlikely]] {
+      ++_stats.fallbackCnt;
+      return NULL_HANDLE;
+    }
+    const uint32_t slot = _free;
+    _free = next(slot);
+    if (++_stats.inUse > _stats.highWater) {
+      _stats.highWater = _stats.inUse;
+    }
+    return makeHandle(slot, _generations[slot]);
+  }
+
+  // Releases the slot; returns false for a null or stale handle.
+  inline bool free(Handle handle) noexcept {
+    if (!valid(handle)) [[unlikely]] {
+      return false;
+    }
+    const uint32_t slot = slotOf(handle);
+    _generations[slot] = (_generations[slot] + 1) & GENERATION_MASK;
+    next(slot) = _free;
+    _free = slot;
+    --_stats.inUse;
+    return true;
+  }
+
+  template <typename ... Args>
+  inline Type* construct(Handle handle, Args&&... args) {
+    return new (block(slotOf(handle))) Type(std::forward<Args>(args)...);
+  }
+
+  inline void destroy(Handle handle) {
+    if (Type* ptr = get(handle); ptr) {
+      ptr->~Type();
+    }
+  }
+
+  inline bool valid(Handle handle) const noexcept {
+    const uint32_t index = handle & INDEX_MASK;
+    return index != 0 && index <= _capacity && _generations[index - 1] == (handle >> INDEX_BITS);
+  }
+
+  // Checked lookup: nullptr for null or stale handles.
+  inline Type* get(Handle handle) noexcept {
+    return valid(handle) ? block(slotOf(handle)) : nullptr;
+  }
+
+  inline const Type* get(Handle handle) const noexcept {
+    return valid(handle) ? block(slotOf(handle)) : nullptr;
+  }
+
+  // Unchecked lookup for handles known to be live.
+  inline Type& operator[](Handle handle) noexcept {
+    assert(valid(handle));
+    return *block(slotOf(handle));
+  }
+
+  inline const Type& operator[](Handle handle) const noexcept {
+    assert(valid(handle));
+    return *block(slotOf(handle));
+  }
+
+  size_t capacity() const noexcept { return _capacity; }
+  const PoolStats& stats() const noexcept { return _stats; }
+
+  static constexpr uint32_t slotOf(Handle handle) noexcept { return (handle & INDEX_MASK) - 1; }
+  static constexpr uint32_t generationOf(Handle handle) noexcept { return handle >> INDEX_BITS; }
+
+private:
+  static constexpr Handle makeHandle(uint32_t slot, uint32_t generation) noexcept {
+    return (generation << INDEX_BITS) | (slot + 1);
+  }
+
+  inline Type* block(uint32_t slot) const noexcept {
+    return reinterpret_cast<Type*>(_data + slot * BLOCK_SIZE);
+  }
+
+  inline uint32_t& next(size_t slot) noexcept {
+    return *reinterpret_cast<uint32_t*>(_data + slot * BLOCK_SIZE);
+  }
+
+  std::byte* _data = nullptr;
+  uint32_t* _generations = nullptr;
+  size_t _capacity = 0;
+  uint32_t _free = 0;   // first free slot, _capacity when exhausted
+  PoolStats _stats;
+};
+
+/**
+ * PooledHashmap: swiss table of 32-bit handles paired with a HandlePool of values.
+ * - Stores uint32 handles where HashmapST stores Value*, halving the value array.
+ * - Owns the values: emplace() constructs in the pool, erase() destroys and frees.
+ * - Handles returned by handle() stay valid until the key is erased; afterwards get()
+ *   on a kept handle returns nullptr.
+ */
+template <typename Value, size_t MAX_KEYS, uint32_t INDEX_BITS = 20>
+class PooledHashmap {
+public:
+  using Pool = HandlePool<Value, INDEX_BITS>;
+  using Handle = typename Pool::Handle;
+  using Table = swisstable::HashmapST<Value, MAX_KEYS, swisstable::DuplicatePolicy::Reject, Handle>;
+
+  // capacity: number of values; defaults to the table capacity.
+  explicit PooledHashmap(size_t capacity = MAX_KEYS) : _pool(std::min(capacity, Pool::MAX_CAPACITY)) {}
+
+  // Returns {value, true} on insert, {existing, false} on duplicate, {nullptr, false} when full.
+  template <typename ... Args>
+  std::pair<Value*, bool> emplace(uint64_t key, Args&&... args) {
+    if (Handle existing = _table.find(key); existing != Pool::NULL_HANDLE) {
+      return {&_pool[existing], false};
+    }
+    Handle handle = _pool.allocate();
+    if (handle == Pool::NULL_HANDLE) {
+      return {nullptr, false};
+    }
+    Value* value = nullptr;
+    try {
+      value = _pool.construct(handle, std::forward<Args>(args)...);
+    }
+    catch (...) {
+      _pool.free(handle);
+      throw;
+    }
+    if (!_table.insert(key, handle)) {
+      _pool.destroy(handle);
+      _pool.free(handle);
+      return {nullptr, false};
+    }
+    return {value, true};
+  }
+
+  inline Value* find(uint64_t key) noexcept {
+    Handle handle = _table.find(key);
+    return handle != Pool::NULL_HANDLE ? &_pool[handle] : nullptr;
+  }
+
+  inline const Value* find(uint64_t key) const noexcept {
+    Handle handle = _table.find(key);
+    return handle != Pool::NULL_HANDLE ? &_pool[handle] : nullptr;
+  }
+
+  inline Handle handle(uint64_t key) const noexcept {
+    return _table.find(key);
+  }
+
+  inline Value* get(Handle handle) noexcept {
+    return _pool.get(handle);
+  }
+
+  bool erase(uint64_t key) {
+    Handle handle = _table.find(key);
+    if (handle == Pool::NULL_HANDLE) {
+      return false;
+    }
+    _table.erase(key);
+    _pool.destroy(handle);
+    _pool.free(handle);
+    return true;
+  }
+
+  size_t size() const noexcept { return _table.size(); }
+  static constexpr size_t capacity() noexcept { return MAX_KEYS; }
+  const Pool& pool() const noexcept { return _pool; }
+
+private:
+  Pool _pool;
+  Table _table;
+};
+
+} // namespace hw::utility
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+  #include <immintrin.h>
+#endif
+
+namespace hw::utility {
+
+namespace detail {
+  // Two lower-case hex digits per byte value.
+  inline constexpr auto HEX_PAIRS = [] {
+    constexpr char digits[] = "0123456789abcdef";
+    std::array<char, 512> table {};
+    for (size_t i = 0; i < 256; ++i) {
+      table[2 * i] = digits[i >> 4];
+      table[2 * i + 1] = digits[i & 0x0f];
+    }
+    return table;
+  }();
+
+  // Nibble value of a hex digit (either case), 0xff for anything else.
+  inline constexpr auto HEX_NIBBLES = [] {
+    std::array<uint8_t, 256> table {};
+    for (size_t i = 0; i < 256; ++i) {
+      table[i] = 0xff;
+    }
+    for (size_t i = 0; i < 10; ++i) {
+      table['0' + i] = static_cast<uint8_t>(i);
+    }
+    for (size_t i = 0; i < 6; ++i) {
+      table['a' + i] = static_cast<uint8_t>(10 + i);
+      table['A' + i] = static_cast<uint8_t>(10 + i);
+    }
+    return table;
+  }();
+}
+
+/**
+ * hexEncode: writes 2 * len lower-case hex digits of src to dst and returns the end.
+ * - SSE2 converts 16 bytes per step (nibbles + '0', + 39 more for a-f); the tail goes
+ *   through a 256-entry digit-pair table.
+ * - No terminator is written, dst is caller-provided.
+ */
+inline char* hexEncode(const void* src, size_t len, char* dst) noexcept {
+  const uint8_t* in = static_cast<const uint8_t*>(src);
+  size_t i = 0;
+#if defined(__SSE2__)
+  const __m128i low = _mm_set1_epi8(0x0f);
+  const __m128i nine = _mm_set1_epi8(9);
+  const __m128i zero = _mm_set1_epi8('0');
+  const __m128i alpha = _mm_set1_epi8('a' - '0' - 10);
+  auto ascii = [&] (__m128i nibbles) {
+    const __m128i over = _mm_and_si128(_mm_cmpgt_epi8(nibbles, nine), alpha);
+    return _mm_add_epi8(_mm_add_epi8(nibbles, zero), over);
+  };
+  for (; i + 16 <= len; i += 16) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+    const __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), low);
+    const __m128i lo = _mm_and_si128(v, low);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i), ascii(_mm_unpacklo_epi8(hi, lo)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i + 16), ascii(_mm_unpackhi_epi8(hi, lo)));
+  }
+#endif
+  for (; i < len; ++i) {
+    std::memcpy(dst + 2 * i, &detail::HEX_PAIRS[2 * in[i]], 2);
+  }
+  return dst + 2 * len;
+}
+
+/**
+ * hexDecode: reads 2 * len hex digits (either case) from src into len bytes at dst.
+ * - Returns false on the first block holding a non-hex character; dst is then partly written.
+ * - SSE2 validates and converts 16 digits per step; the tail uses a nibble table.
+ */
+inline bool hexDecode(const char* src, size_t len, void* dst) noexcept {
+  uint8_t* out = static_cast<uint8_t*>(dst);
+  size_t i = 0;
+#if defined(__SSE2__)
+  const __m128i caseBit = _mm_set1_epi8(0x20);
+  const __m128i belowDigit = _mm_set1_epi8('0' - 1);
+  const __m128i aboveDigit = _mm_set1_epi8('9' + 1);
+  const __m128i belowAlpha = _mm_set1_epi8('a' - 1);
+  const __m128i aboveAlpha = _mm_set1_epi8('f' + 1);
+  const __m128i digitBase = _mm_set1_epi8('0');
+  const __m128i alphaBase = _mm_set1_epi8('a' - 10);
+  const __m128i lowByte = _mm_set1_epi16(0x00ff);
+  for (; i + 8 <= len; i += 8) {
+    const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * i));
+    const __m128i l = _mm_or_si128(c, caseBit);
+    const __m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(c, belowDigit), _mm_cmplt_epi8(c, aboveDigit));
+    const __m128i isAlpha = _mm_and_si128(_mm_cmpgt_epi8(l, belowAlpha), _mm_cmplt_epi8(l, aboveAlpha));
+    if (_mm_movemask_epi8(_mm_or_si128(isDigit, isAlpha)) != 0xffff) {
+      return false;
+    }
+    const __m128i nibbles = _mm_or_si128(_mm_and_si128(isDigit, _mm_sub_epi8(c, digitBase)),
+                                         _mm_and_si128(isAlpha, _mm_sub_epi8(l, alphaBase)));
+    // 16-bit lane k holds digit 2k in its low byte and digit 2k+1 in its high byte
+    const __m128i bytes = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(nibbles, lowByte), 4), _mm_srli_epi16(nibbles, 8));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(bytes, bytes));
+  }
+#endif
+  for (; i < len; ++i) {
+    const uint8_t hi = detail::HEX_NIBBLES[static_cast<uint8_t>(src[2 * i])];
+    const uint8_t lo = detail::HEX_NIBBLES[static_cast<uint8_t>(src[2 * i + 1])];
+    if ((hi | lo) & 0xf0) {
+      return false;
+    }
+    out[i] = static_cast<uint8_t>((hi << 4) | lo);
+  }
+  return true;
+}
+
+}
@@ -11,6 +11,7 @@
 #include <initializer_list>
 
 #include <hw/type/NameTag.hpp>
+#include <hw/type/PerfectHash.hpp>
 #include <hw/type/TypeList.hpp>
 
 namespace hw::utility {
@@ -71,9 +72,11 @@ class KeyBuilder<T, type::type_list<Fields...>> {
     static constexpr std::byte value = Attr::default_byte;
   };
 
-  // Shared implementation for matchList
+  // Shared implementation for matchList; each token is resolved through a perfect hash of Tags
   template <type::NameTag... Tags>
   static constexpr bool matchTags(std::string_view list) noexcept {
+    constexpr auto& tags = type::NAME_TAG_HASH<Tags...>;
+    std::array<bool, sizeof...(Tags)> seen {};
     std::string_view remaining = list;
     size_t found_count = 0;
 
@@ -86,8 +89,9 @@ class KeyBuilder<T, type::type_list<Fields...>> {
       token = trim(token);
       
       if (!token.empty()) {
-        bool found = ((token == Tags.toString()) || ...);
-        if (!found) return false;
+        const size_t index = tags.find(token);
+        if (index == tags.NOT_FOUND || seen[index]) return false;
+        seen[index] = true;
         found_count++;
       }
 
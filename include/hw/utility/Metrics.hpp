@@ -0,0 +1,419 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+
+#include <hw/utility/MMap.hpp>
+
+namespace hw::utility {
+
+enum class MetricKind : uint32_t { Counter = 1, Gauge = 2, Histogram = 3 };
+
+namespace metrics {
+
+/**
+ * Stats region layout, shared by the registry (writer) and MetricsView (readers):
+ *   Header | MetricDescriptor[maxMetrics] | ShardDescriptor[maxShards] | shard words[maxShards][shardWords]
+ * - A metric is a name and a kind with the same word offset in every shard; a shard is the
+ *   storage of one writer thread, so threads never share a cache line.
+ * - Counter and gauge take one word. A histogram takes HISTOGRAM_WORDS: count, sum and one bucket
+ *   per bit width of the value (bucket b holds values in [2^(b-1), 2^b)).
+ * - Descriptors are written before metricCnt / shardCnt are raised (release), so a reader
+ *   that loads the counts (acquire) sees complete names.
+ */
+inline constexpr uint64_t MAGIC = 0x31305254454d5748; // "HWMETR01"
+inline constexpr uint32_t VERSION = 1;
+inline constexpr size_t NAME_SIZE = 56;
+inline constexpr size_t HISTOGRAM_BUCKETS = 65;
+inline constexpr size_t HISTOGRAM_WORDS = 2 + HISTOGRAM_BUCKETS;
+
+using Word = std::atomic<uint64_t>;
+static_assert(Word::is_always_lock_free && sizeof(Word) == sizeof(uint64_t));
+
+struct alignas(64) Header {
+  uint64_t              magic;
+  uint32_t              version;
+  uint32_t              maxMetrics;
+  uint32_t              maxShards;
+  uint32_t              shardWords;
+  std::atomic<uint32_t> metricCnt;
+  std::atomic<uint32_t> shardCnt;
+  uint32_t              usedWords;
+  int32_t               pid;
+};
+
+struct MetricDescriptor {
+  char        name[NAME_SIZE];
+  MetricKind  kind;
+  uint32_t    offset;
+};
+
+struct ShardDescriptor {
+  char      name[NAME_SIZE];
+  uint64_t  reserved;
+};
+
+static_assert(sizeof(Header) == 64 && sizeof(MetricDescriptor) == 64 && sizeof(ShardDescriptor) == 64);
+
+constexpr size_t wordCount(MetricKind kind) noexcept {
+  return kind == MetricKind::Histogram ? HISTOGRAM_WORDS : 1;
+}
+
+constexpr size_t regionSize(size_t maxMetrics, size_t maxShards, size_t shardWords) noexcept {
+  return sizeof(Header) + maxMetrics * sizeof(MetricDescriptor) + maxShards * sizeof(ShardDescriptor)
+       + maxShards * shardWords * sizeof(Word);
+}
+
+// Single writer: a relaxed load and store, no read-modify-write.
+inline void bump(Word & word, uint64_t delta) noexcept {
+  word.store(word.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+inline Word SINK[HISTOGRAM_WORDS];
+
+}
+
+/**
+ * Metric handles: a pointer into the owning thread's shard. Only that thread may update them;
+ * every update is a relaxed load and store (plain moves on x86), no lock prefix.
+ * Default-constructed handles write to a sink and are never published.
+ */
+class Counter {
+public:
+  Counter() = default;
+  explicit Counter(metrics::Word * word) noexcept : _word(word) {}
+
+  void add(uint64_t delta = 1) noexcept { metrics::bump(*_word, delta); }
+  // For mirrors of counts kept elsewhere (e.g. a limiter's rejects): publishes the running total.
+  void set(uint64_t total) noexcept { _word->store(total, std::memory_order_relaxed); }
+
+private:
+  metrics::Word * _word = metrics::SINK;
+};
+
+class Gauge {
+public:
+  Gauge() = default;
+  explicit Gauge(metrics::Word * word) noexcept : _word(word) {}
+
+  void set(int64_t value) noexcept { _word->store(static_cast<uint64_t>(value), std::memory_order_relaxed); }
+  void add(int64_t delta) noexcept { metrics::bump(*_word, static_cast<uint64_t>(delta)); }
+
+private:
+  metrics::Word * _word = metrics::SINK;
+};
+
+class Histogram {
+public:
+  Histogram() = default;
+  explicit Histogram(metrics::Word * words) noexcept : _words(words) {}
+
+  void record(uint64_t value) noexcept {
+    metrics::bump(_words[0], 1);
+    metrics::bump(_words[1], value);
+    metrics::bump(_words[2 + std::bit_width(value)], 1);
+  }
+
+private:
+  metrics::Word * _words = metrics::SINK;
+};
+
+class MetricsRegistry;
+
+/**
+ * MetricShard: one writer thread's slice of the registry. Declaring a metric (slow path, locks
+ * the registry) returns a handle into this shard; a name declared by several shards is one
+ * metric, added up by readers.
+ */
+class MetricShard {
+public:
+  MetricShard(MetricsRegistry & registry, metrics::Word * words) noexcept : _registry(registry), _words(words) {}
+
+  MetricShard(const MetricShard &) = delete;
+  MetricShard & operator = (const MetricShard &) = delete;
+
+  inline Counter counter(std::string_view name);
+  inline Gauge gauge(std::string_view name);
+  inline Histogram histogram(std::string_view name);
+
+private:
+  MetricsRegistry & _registry;
+  metrics::Word *   _words;
+};
+
+/**
+ * MetricsRegistry: named counters, gauges and histograms in a stats region.
+ * - With a path, the region is a WritableMmap file that other processes (hw_metrics) map and
+ *   read while the application runs; without one it lives on the heap.
+ * - shard(name) hands out per-thread storage; declarations and shard creation lock, updates
+ *   through handles never do.
+ * - Throws std::invalid_argument when a name is redeclared with another kind or does not fit,
+ *   std::length_error when metrics, shards or shard words run out.
+ */
+class MetricsRegistry {
+public:
+  static constexpr size_t DEFAULT_METRICS = 1024;
+  static constexpr size_t DEFAULT_SHARDS = 64;
+  static constexpr size_t DEFAULT_SHARD_WORDS = 4096;
+
+  explicit MetricsRegistry(const std::string & path = "", size_t maxMetrics = DEFAULT_METRICS,
+                           size_t maxShards = DEFAULT_SHARDS, size_t shardWords = DEFAULT_SHARD_WORDS)
+    : _maxMetrics(maxMetrics), _maxShards(maxShards),
+      _shardWords((shardWords + 7) & ~size_t{7}), // whole cache lines per shard
+      _size(metrics::regionSize(_maxMetrics, _maxShards, _shardWords))
+  {
+    if (_maxMetrics == 0 || _maxShards == 0 || _shardWords == 0) {
+      throw std::invalid_argument("MetricsRegistry: empty region");
+    }
+    if (path.empty()) {
+      _heap.reset(static_cast<uint8_t *>(std::aligned_alloc(64, (_size + 63) & ~size_t{63})));
+      if (!_heap) {
+        throw std::bad_alloc();
+      }
+      std::memset(_heap.get(), 0, _size);
+      _data = _heap.get();
+    }
+    else {
+      _file = std::make_unique<WritableMmap>(path, _size, true);
+      _data = _file->data();
+    }
+    _header = new (_data) metrics::Header{};
+    _header->maxMetrics = static_cast<uint32_t>(_maxMetrics);
+    _header->maxShards = static_cast<uint32_t>(_maxShards);
+    _header->shardWords = static_cast<uint32_t>(_shardWords);
+    _header->pid = static_cast<int32_t>(::getpid());
+    _header->version = metrics::VERSION;
+    std::atomic_thread_fence(std::memory_order_release);
+    _header->magic = metrics::MAGIC;
+  }
+
+  MetricsRegistry(const MetricsRegistry &) = delete;
+  MetricsRegistry & operator = (const MetricsRegistry &) = delete;
+
+  // New storage for one writer thread, named for readers (e.g. the dispatcher name).
+  MetricShard & shard(std::string_view name) {
+    std::lock_guard lock(_mutex);
+    const uint32_t index = _header->shardCnt.load(std::memory_order_relaxed);
+    if (index == _maxShards) {
+      throw std::length_error("MetricsRegistry: out of shards");
+    }
+    setName(shardDescriptors()[index].name, name);
+    metrics::Word * words = reinterpret_cast<metrics::Word *>(_data + shardsOffset()) + index * _shardWords;
+    MetricShard & shard = _shards.emplace_back(*this, words);
+    _header->shardCnt.store(index + 1, std::memory_order_release);
+    return shard;
+  }
+
+  const uint8_t * data() const noexcept { return _data; }
+  size_t size() const noexcept { return _size; }
+
+private:
+  friend class MetricShard;
+
+  struct FreeDeleter {
+    void operator () (uint8_t * ptr) const noexcept { std::free(ptr); }
+  };
+
+  // Word offset of the metric in every shard; declared on first use.
+  uint32_t declare(std::string_view name, MetricKind kind) {
+    if (name.empty() || name.size() >= metrics::NAME_SIZE) {
+      throw std::invalid_argument("MetricsRegistry: invalid metric name '" + std::string(name) + "'");
+    }
+    std::lock_guard lock(_mutex);
+    const uint32_t count = _header->metricCnt.load(std::memory_order_relaxed);
+    metrics::MetricDescriptor * descriptors = metricDescriptors();
+    for (uint32_t i = 0; i < count; ++i) {
+      if (name == descriptors[i].name) {
+        if (descriptors[i].kind != kind) {
+          throw std::invalid_argument("MetricsRegistry: '" + std::string(name) + "' declared with another kind");
+        }
+        return descriptors[i].offset;
+      }
+    }
+    if (count == _maxMetrics) {
+      throw std::length_error("MetricsRegistry: out of metrics");
+    }
+    const size_t words = metrics::wordCount(kind);
+    if (_header->usedWords + words > _shardWords) {
+      throw std::length_error("MetricsRegistry: out of shard words");
+    }
+    metrics::MetricDescriptor & descriptor = descriptors[count];
+    setName(descriptor.name, name);
+    descriptor.kind = kind;
+    descriptor.offset = _header->usedWords;
+    _header->usedWords += static_cast<uint32_t>(words);
+    _header->metricCnt.store(count + 1, std::memory_order_release);
+    return descriptor.offset;
+  }
+
+  static void setName(char (&target)[metrics::NAME_SIZE], std::string_view name) noexcept {
+    std::memset(target, 0, metrics::NAME_SIZE);
+    std::memcpy(target, name.data(), std::min(name.size(), metrics::NAME_SIZE - 1));
+  }
+
+  metrics::MetricDescriptor * metricDescriptors() const noexcept {
+    return reinterpret_cast<metrics::MetricDescriptor *>(_data + sizeof(metrics::Header));
+  }
+
+  metrics::ShardDescriptor * shardDescriptors() const noexcept {
+    return reinterpret_cast<metrics::ShardDescriptor *>(metricDescriptors() + _maxMetrics);
+  }
+
+  size_t shardsOffset() const noexcept {
+    return sizeof(metrics::Header) + _maxMetrics * sizeof(metrics::MetricDescriptor)
+         + _maxShards * sizeof(metrics::ShardDescriptor);
+  }
+
+  const size_t                          _maxMetrics;
+  const size_t                          _maxShards;
+  const size_t                          _shardWords;
+  const size_t                          _size;
+  std::unique_ptr<uint8_t, FreeDeleter> _heap;
+  std::unique_ptr<WritableMmap>         _file;
+  uint8_t *                             _data = nullptr;
+  metrics::Header *                     _header = nullptr;
+  std::deque<MetricShard>               _shards;    // stable addresses
+  std::mutex                            _mutex;
+};
+
+inline Counter MetricShard::counter(std::string_view name) {
+  return Counter(_words + _registry.declare(name, MetricKind::Counter));
+}
+
+inline Gauge MetricShard::gauge(std::string_view name) {
+  return Gauge(_words + _registry.declare(name, MetricKind::Gauge));
+}
+
+inline Histogram MetricShard::histogram(std::string_view name) {
+  return Histogram(_words + _registry.declare(name, MetricKind::Histogram));
+}
+
+/**
+ * MetricsView: the reading side, over a registry's region or a mapped stats file.
+ * - Reads are relaxed loads of live words: each value is current, a histogram's count,
+ *   sum and buckets may be a few updates apart.
+ * - total() adds a metric up over the shards (gauges too, e.g. the ether lag of every dispatcher).
+ */
+class MetricsView {
+public:
+  struct HistogramValue {
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    std::array<uint64_t, metrics::HISTOGRAM_BUCKETS> buckets {};
+
+    // Upper bound of the bucket holding the q-th quantile (power-of-two resolution).
+    uint64_t percentile(double q) const noexcept {
+      const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(q * static_cast<double>(count) + 0.5));
+      uint64_t seen = 0;
+      for (size_t b = 0; b < metrics::HISTOGRAM_BUCKETS; ++b) {
+        seen += buckets[b];
+        if (seen >= rank) {
+          return b == 0 ? 0 : b == 64 ? UINT64_MAX : (uint64_t{1} << b) - 1;
+        }
+      }
+      return 0;
+    }
+  };
+
+  MetricsView(const uint8_t * data, size_t size) : _data(data) {
+    if (size < sizeof(metrics::Header) || header().magic != metrics::MAGIC || header().version != metrics::VERSION ||
+        size < metrics::regionSize(header().maxMetrics, header().maxShards, header().shardWords)) {
+      throw std::invalid_argument("MetricsView: not a metrics region");
+    }
+  }
+
+  explicit MetricsView(const MetricsRegistry & registry) : MetricsView(registry.data(), registry.size()) {}
+
+  size_t metricCnt() const noexcept { return header().metricCnt.load(std::memory_order_acquire); }
+  size_t shardCnt() const noexcept { return header().shardCnt.load(std::memory_order_acquire); }
+  int pid() const noexcept { return header().pid; }
+
+  std::string_view name(size_t metric) const noexcept { return metricDescriptor(metric).name; }
+  MetricKind kind(size_t metric) const noexcept { return metricDescriptor(metric).kind; }
+  std::string_view shardName(size_t shard) const noexcept { return shardDescriptors()[shard].name; }
+
+  size_t find(std::string_view name) const noexcept {
+    const size_t count = metricCnt();
+    for (size_t i = 0; i < count; ++i) {
+      if (this->name(i) == name) {
+        return i;
+      }
+    }
+    return NOT_FOUND;
+  }
+
+  // Counter or gauge (as its two's complement bits) in one shard.
+  uint64_t value(size_t metric, size_t shard) const noexcept {
+    return words(shard)[metricDescriptor(metric).offset].load(std::memory_order_relaxed);
+  }
+
+  uint64_t total(size_t metric) const noexcept {
+    uint64_t sum = 0;
+    for (size_t shard = 0, count = shardCnt(); shard < count; ++shard) {
+      sum += value(metric, shard);
+    }
+    return sum;
+  }
+
+  HistogramValue histogram(size_t metric, size_t shard) const noexcept {
+    HistogramValue result;
+    add(result, metric, shard);
+    return result;
+  }
+
+  HistogramValue histogram(size_t metric) const noexcept {
+    HistogramValue result;
+    for (size_t shard = 0, count = shardCnt(); shard < count; ++shard) {
+      add(result, metric, shard);
+    }
+    return result;
+  }
+
+  static constexpr size_t NOT_FOUND = SIZE_MAX;
+
+private:
+  const metrics::Header & header() const noexcept {
+    return *reinterpret_cast<const metrics::Header *>(_data);
+  }
+
+  const metrics::MetricDescriptor & metricDescriptor(size_t metric) const noexcept {
+    return reinterpret_cast<const metrics::MetricDescriptor *>(_data + sizeof(metrics::Header))[metric];
+  }
+
+  const metrics::ShardDescriptor * shardDescriptors() const noexcept {
+    return reinterpret_cast<const metrics::ShardDescriptor *>(
+      _data + sizeof(metrics::Header) + header().maxMetrics * sizeof(metrics::MetricDescriptor));
+  }
+
+  const metrics::Word * words(size_t shard) const noexcept {
+    return reinterpret_cast<const metrics::Word *>(reinterpret_cast<const uint8_t *>(shardDescriptors() + header().maxShards))
+         + shard * header().shardWords;
+  }
+
+  void add(HistogramValue & result, size_t metric, size_t shard) const noexcept {
+    const metrics::Word * hist = words(shard) + metricDescriptor(metric).offset;
+    result.count += hist[0].load(std::memory_order_relaxed);
+    result.sum += hist[1].load(std::memory_order_relaxed);
+    for (size_t b = 0; b < metrics::HISTOGRAM_BUCKETS; ++b) {
+      result.buckets[b] += hist[2 + b].load(std::memory_order_relaxed);
+    }
+  }
+
+  const uint8_t * _data;
+};
+
+}
@@ -77,6 +77,7 @@ public:
              if (delta_back >= SLOTS) {
                  // Too old: exceeds window size. Ignore this event.
                  // "impossibility in practice" but handled safely.
+                 ++_rejected;
                  return false; 
              }
              // Else: It falls into a valid past slot. We will increment it below.
@@ -117,6 +118,7 @@ public:
                 size_t new_abs_slot = tm / _current_config->slot_width_ns;
                 _last_abs_slot = new_abs_slot;
                 increment_(new_abs_slot);
+                ++_rejected;
                 return false;
             }
         } else {
@@ -134,10 +136,16 @@ public:
             }
             
             increment_(abs_slot);
+            ++_rejected;
             return false;
         }
     }
 
+    /**
+     * @return orders rejected since construction, for monitoring.
+     */
+    size_t rejected() const { return _rejected; }
+
 private:
     struct Config {
         int64_t window_ns;
@@ -176,6 +184,7 @@ private:
     std::array<size_t, SLOTS> _counters;
     size_t _total_count = 0;
     size_t _last_abs_slot = 0;
+    size_t _rejected = 0;
 };
 
 } // namespace hw::utility
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#if defined(__x86_64__)
+  #include <x86intrin.h>
+#endif
+
+namespace hw::utility {
+
+enum class PerfEvent : uint8_t {
+  Cycles,
+  Instructions,
+  L1DMisses,
+  LLCMisses,
+  BranchMisses,
+};
+
+inline constexpr size_t PERF_EVENT_CNT = 5;
+
+inline constexpr std::array<std::string_view, PERF_EVENT_CNT> PERF_EVENT_NAMES {
+  "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses"
+};
+
+using PerfSample = std::array<uint64_t, PERF_EVENT_CNT>;
+
+namespace detail {
+
+// PERF_TYPE_HW_CACHE event config: cache id, operation, result
+constexpr uint64_t perfCacheConfig(uint64_t cache, uint64_t op, uint64_t result) noexcept {
+  return cache | (op << 8) | (result << 16);
+}
+
+}
+
+/**
+ * PerfCounterGroup: cycles, instructions, L1D read misses, LLC misses and branch misses of the
+ * calling thread, user space only, opened as one perf_event_open group.
+ * - Must be created and read on the thread it measures.
+ * - read() takes each counter with rdpmc through the event's mmap page (tens of cycles, no
+ *   system call); a counter the kernel does not expose to user space is read with read(2).
+ * - Degrades instead of failing: without a PMU (VMs, containers, perf_event_paranoid) the group
+ *   is unavailable and read() leaves the sample at zero; events the PMU lacks read as zero
+ *   while the others keep counting. error() says what failed.
+ */
+class PerfCounterGroup {
+public:
+  PerfCounterGroup() {
+    _fds.fill(-1);
+    _pages.fill(nullptr);
+    for (size_t i = 0; i < PERF_EVENT_CNT; ++i) {
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = EVENTS[i].type;
+      attr.config = EVENTS[i].config;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP;
+      attr.disabled = i == 0; // the leader starts the whole group
+      const int fd = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, i ? _fds[0] : -1, 0));
+      if (fd < 0) {
+        if (i == 0) {
+          _error = std::string("perf_event_open: ") + std::strerror(errno);
+          return;
+        }
+        _error += std::string(_error.empty() ? "" : "; ") + std::string(PERF_EVENT_NAMES[i]) + ": " + std::strerror(errno);
+        continue;
+      }
+      _fds[i] = fd;
+      void * page = ::mmap(nullptr, static_cast<size_t>(::sysconf(_SC_PAGESIZE)), PROT_READ, MAP_SHARED, fd, 0);
+      if (page != MAP_FAILED) {
+        _pages[i] = static_cast<const perf_event_mmap_page *>(page);
+      }
+    }
+    ::ioctl(_fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ::ioctl(_fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+
+  PerfCounterGroup(const PerfCounterGroup &) = delete;
+  PerfCounterGroup & operator = (const PerfCounterGroup &) = delete;
+
+  ~PerfCounterGroup() {
+    const size_t pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    for (size_t i = 0; i < PERF_EVENT_CNT; ++i) {
+      if (_pages[i]) {
+        ::munmap(const_cast<perf_event_mmap_page *>(_pages[i]), pageSize);
+      }
+      if (_fds[i] >= 0) {
+        ::close(_fds[i]);
+      }
+    }
+  }
+
+  bool available() const noexcept { return _fds[0] >= 0; }
+  bool available(PerfEvent event) const noexcept { return _fds[static_cast<size_t>(event)] >= 0; }
+
+  // Empty when every event opened.
+  const std::string & error() const noexcept { return _error; }
+
+  void read(PerfSample & sample) noexcept {
+    if (!available()) [[unlikely]] {
+      sample.fill(0);
+      return;
+    }
+    bool fallback = false;
+    for (size_t i = 0; i < PERF_EVENT_CNT; ++i) {
+      sample[i] = 0;
+      if (_pages[i] && !rdpmc(*_pages[i], sample[i])) [[unlikely]] {
+        fallback = true;
+      }
+      fallback = fallback || (_fds[i] >= 0 && !_pages[i]);
+    }
+    if (fallback) [[unlikely]] {
+      readGroup(sample);
+    }
+  }
+
+private:
+  struct EventConfig {
+    uint32_t type;
+    uint64_t config;
+  };
+
+  static constexpr EventConfig EVENTS[PERF_EVENT_CNT] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE, detail::perfCacheConfig(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+  };
+
+  // The kernel updates the page under us: every field is read once, through a volatile access.
+  template <typename Type>
+  static Type readOnce(const Type & field) noexcept {
+    return *static_cast<const volatile Type *>(&field);
+  }
+
+  static constexpr uint64_t CAP_USER_RDPMC = uint64_t{1} << 2; // perf_event_mmap_page::cap_user_rdpmc
+
+  // Seqlock protocol of perf_event_mmap_page; false when the counter is not readable in user space.
+  static bool rdpmc(const perf_event_mmap_page & page, uint64_t & value) noexcept {
+#if defined(__x86_64__)
+    uint32_t seq;
+    do {
+      seq = readOnce(page.lock);
+      std::atomic_signal_fence(std::memory_order_seq_cst);
+      const uint32_t index = readOnce(page.index);
+      if (!(readOnce(page.capabilities) & CAP_USER_RDPMC) || index == 0) {
+        return false;
+      }
+      int64_t count = static_cast<int64_t>(__rdpmc(static_cast<int>(index - 1)));
+      const uint16_t width = readOnce(page.pmc_width);
+      count = (count << (64 - width)) >> (64 - width);
+      value = static_cast<uint64_t>(readOnce(page.offset) + count);
+      std::atomic_signal_fence(std::memory_order_seq_cst);
+    } while (readOnce(page.lock) != seq);
+    return true;
+#else
+    (void) page;
+    (void) value;
+    return false;
+#endif
+  }
+
+  // PERF_FORMAT_GROUP read of the leader: { nr, value[nr] } in the order the events were opened.
+  void readGroup(PerfSample & sample) noexcept {
+    uint64_t buffer[1 + PERF_EVENT_CNT] = {};
+    if (::read(_fds[0], buffer, sizeof(buffer)) <= 0) {
+      return;
+    }
+    size_t next = 1;
+    for (size_t i = 0; i < PERF_EVENT_CNT && next <= buffer[0]; ++i) {
+      if (_fds[i] >= 0) {
+        sample[i] = buffer[next++];
+      }
+    }
+  }
+
+  std::array<int, PERF_EVENT_CNT>                           _fds;
+  std::array<const perf_event_mmap_page *, PERF_EVENT_CNT>  _pages;
+  std::string                                               _error;
+};
+
+}
@@ -0,0 +1,465 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <hw/type/TypeInfo.hpp>
+#include <hw/utility/CPU.hpp>
+
+namespace hw::utility {
+
+// Position-independent reference to an object in a shared region: 1-based block index, 0 is null.
+using ShmHandle = uint32_t;
+static constexpr ShmHandle SHM_NULL = 0;
+
+namespace detail {
+  // Hash must give the same value in every process mapping the region, so std::hash is not used.
+  template <typename Key>
+  inline uint64_t shmHash(const Key& key) noexcept {
+    uint64_t k = 0;
+    if constexpr (std::is_integral_v<Key> && sizeof(Key) <= sizeof(uint64_t)) {
+      k = static_cast<uint64_t>(key);
+    }
+    else {
+      k = 0xcbf29ce484222325;
+      const auto* ptr = reinterpret_cast<const uint8_t*>(&key);
+      for (size_t i = 0; i < sizeof(Key); ++i) {
+        k ^= ptr[i];
+        k *= 0x100000001b3;
+      }
+    }
+    // murmur3 finalizer, same as swisstable::detail::hash
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+  }
+
+  template <typename ... Types>
+  constexpr uint64_t shmSignature(uint64_t kind) {
+    uint64_t retval = 0xcbf29ce484222325 ^ kind;
+    ((retval = (retval ^ type::TypeInfo<Types>::name_hash ^ (sizeof(Types) << 1)) * 0x100000001b3), ...);
+    return retval;
+  }
+
+  constexpr size_t shmAlign(size_t size) noexcept {
+    return (size + ALIGNAS - 1) & ~size_t(ALIGNAS - 1);
+  }
+
+  inline void shmCheck(bool ok, const char* what, const char* name) {
+    if (!ok) {
+      throw std::invalid_argument(std::string(name) + ": " + what);
+    }
+  }
+}
+
+/**
+ * SharedPool: fixed-capacity object pool that lives entirely inside a caller-provided
+ * region (e.g. WritableMmap), so several processes can map the same pool.
+ * - Objects are addressed by ShmHandle (block index), never by pointer; get() turns a
+ *   handle into a pointer valid in the calling process.
+ * - Free list links are handles stored in idle blocks.
+ * - Type must be trivially copyable: the region outlives and is shared between processes.
+ * - One writer; readers may map the region read-only (see attach(const uint8_t*, size_t)).
+ */
+template <typename Type>
+class SharedPool {
+  static_assert(std::is_trivially_copyable_v<Type>, "shared pool objects must be trivially copyable");
+
+  struct alignas (ALIGNAS) PoolHdr {
+    uint64_t signature;
+    uint64_t capacity;
+    uint64_t blockSize;
+    uint64_t next;      // blocks handed out at least once
+    uint64_t inUse;
+    ShmHandle free;     // head of free list
+  };
+
+public:
+  static constexpr size_t ALIGNMENT = std::max(alignof(Type), alignof(ShmHandle));
+  static constexpr size_t BLOCK_SIZE = (std::max(sizeof(Type), sizeof(ShmHandle)) + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+  static constexpr size_t HEADER_SIZE = detail::shmAlign(sizeof(PoolHdr));
+  static constexpr uint64_t SIGNATURE = detail::shmSignature<Type>(0x706f6f6c);
+
+  static constexpr size_t requiredSize(size_t capacity) noexcept {
+    return HEADER_SIZE + capacity * BLOCK_SIZE;
+  }
+
+  // Formats the region for capacity objects.
+  void initialize(uint8_t* buffer, size_t size, size_t capacity) {
+    detail::shmCheck(capacity < UINT32_MAX && size >= requiredSize(capacity), "region too small", "SharedPool");
+    detail::shmCheck(reinterpret_cast<uintptr_t>(buffer) % ALIGNAS == 0, "region misaligned", "SharedPool");
+    _hdr = reinterpret_cast<PoolHdr*>(buffer);
+    std::memset(_hdr, 0, HEADER_SIZE);
+    _hdr->signature = SIGNATURE;
+    _hdr->capacity = capacity;
+    _hdr->blockSize = BLOCK_SIZE;
+    _data = buffer + HEADER_SIZE;
+    _readOnly = false;
+  }
+
+  // Attaches to a region formatted by initialize(), possibly in another process.
+  void attach(uint8_t* buffer, size_t size) {
+    attach(static_cast<const uint8_t*>(buffer), size);
+    _readOnly = false;
+  }
+
+  void attach(const uint8_t* buffer, size_t size) {
+    detail::shmCheck(size >= HEADER_SIZE, "region too small", "SharedPool");
+    const PoolHdr* hdr = reinterpret_cast<const PoolHdr*>(buffer);
+    detail::shmCheck(hdr->signature == SIGNATURE, "signature mismatch", "SharedPool");
+    detail::shmCheck(hdr->blockSize == BLOCK_SIZE, "block size mismatch", "SharedPool");
+    detail::shmCheck(size >= requiredSize(hdr->capacity), "region too small", "SharedPool");
+    _hdr = const_cast<PoolHdr*>(hdr);
+    _data = const_cast<uint8_t*>(buffer) + HEADER_SIZE;
+    _readOnly = true;
+  }
+
+  // Returns SHM_NULL when the pool is full.
+  ShmHandle allocate() {
+    writable();
+    ShmHandle handle = _hdr->free;
+    if (handle != SHM_NULL) {
+      std::memcpy(&_hdr->free, block(handle), sizeof(ShmHandle));
+    }
+    else if (_hdr->next < _hdr->capacity) {
+      handle = static_cast<ShmHandle>(++_hdr->next);
+    }
+    else {
+      return SHM_NULL;
+    }
+    ++_hdr->inUse;
+    return handle;
+  }
+
+  void free(ShmHandle handle) {
+    writable();
+    if (handle == SHM_NULL) return;
+    std::memcpy(block(handle), &_hdr->free, sizeof(ShmHandle));
+    _hdr->free = handle;
+    --_hdr->inUse;
+  }
+
+  Type* get(ShmHandle handle) noexcept {
+    return handle != SHM_NULL ? reinterpret_cast<Type*>(block(handle)) : nullptr;
+  }
+
+  const Type* get(ShmHandle handle) const noexcept {
+    return handle != SHM_NULL ? reinterpret_cast<const Type*>(block(handle)) : nullptr;
+  }
+
+  // Handle of an object obtained through get().
+  ShmHandle handle(const Type* ptr) const noexcept {
+    return ptr ? static_cast<ShmHandle>((reinterpret_cast<const uint8_t*>(ptr) - _data) / BLOCK_SIZE + 1) : SHM_NULL;
+  }
+
+  size_t capacity() const noexcept { return _hdr->capacity; }
+  size_t size() const noexcept { return _hdr->inUse; }
+  bool readOnly() const noexcept { return _readOnly; }
+
+private:
+  uint8_t* block(ShmHandle handle) const noexcept {
+    return _data + (handle - 1) * BLOCK_SIZE;
+  }
+
+  void writable() const {
+    if (_readOnly) [[unlikely]] {
+      throw std::logic_error("SharedPool: region attached read-only");
+    }
+  }
+
+  PoolHdr* _hdr = nullptr;
+  uint8_t* _data = nullptr;
+  bool _readOnly = true;
+};
+
+/**
+ * SharedIndex: fixed-capacity open-addressing hash index (Key -> ShmHandle) inside a
+ * caller-provided region.
+ * - Keys are stored in the slots and compared bytewise, so Key must be trivially copyable
+ *   with unique object representations (integers, fixed char arrays, packed structs).
+ * - Each slot has one 64-bit control word: 32-bit hash tag | handle. A writer fills the key,
+ *   then publishes the control word with a release store; readers in other processes can
+ *   look up concurrently with a single writer.
+ * - erase() leaves a tombstone that is not reused, so a concurrent reader never sees a key
+ *   being overwritten. The index is meant for reference data loaded once, not churn.
+ * - Slot count is a power of 2, at least twice the capacity.
+ */
+template <typename Key>
+class SharedIndex {
+  static_assert(std::is_trivially_copyable_v<Key>, "shared index keys must be trivially copyable");
+  static_assert(std::has_unique_object_representations_v<Key>, "shared index keys are compared bytewise");
+
+  static constexpr uint64_t EMPTY = 0;
+  static constexpr uint64_t TOMBSTONE = 0xFFFFFFFF00000000ULL;
+
+  struct alignas (ALIGNAS) IndexHdr {
+    uint64_t signature;
+    uint64_t slotCnt;
+    uint64_t slotSize;
+    std::atomic<uint64_t> size;
+    uint64_t used;  // live entries plus tombstones
+  };
+
+  struct Slot {
+    std::atomic<uint64_t> ctrl;
+    Key key;
+  };
+  static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+public:
+  static constexpr size_t HEADER_SIZE = detail::shmAlign(sizeof(IndexHdr));
+  static constexpr uint64_t SIGNATURE = detail::shmSignature<Key>(0x696e6478);
+
+  static constexpr size_t slotCount(size_t capacity) noexcept {
+    return std::bit_ceil(std::max<size_t>(capacity * 2, 16));
+  }
+
+  static constexpr size_t requiredSize(size_t capacity) noexcept {
+    return HEADER_SIZE + slotCount(capacity) * sizeof(Slot);
+  }
+
+  void initialize(uint8_t* buffer, size_t size, size_t capacity) {
+    detail::shmCheck(size >= requiredSize(capacity), "region too small", "SharedIndex");
+    detail::shmCheck(reinterpret_cast<uintptr_t>(buffer) % ALIGNAS == 0, "region misaligned", "SharedIndex");
+    std::memset(buffer, 0, requiredSize(capacity));
+    _hdr = reinterpret_cast<IndexHdr*>(buffer);
+    _hdr->signature = SIGNATURE;
+    _hdr->slotCnt = slotCount(capacity);
+    _hdr->slotSize = sizeof(Slot);
+    _slots = reinterpret_cast<Slot*>(buffer + HEADER_SIZE);
+    _mask = _hdr->slotCnt - 1;
+    _readOnly = false;
+  }
+
+  void attach(uint8_t* buffer, size_t size) {
+    attach(static_cast<const uint8_t*>(buffer), size);
+    _readOnly = false;
+  }
+
+  void attach(const uint8_t* buffer, size_t size) {
+    detail::shmCheck(size >= HEADER_SIZE, "region too small", "SharedIndex");
+    const IndexHdr* hdr = reinterpret_cast<const IndexHdr*>(buffer);
+    detail::shmCheck(hdr->signature == SIGNATURE, "signature mismatch", "SharedIndex");
+    detail::shmCheck(hdr->slotSize == sizeof(Slot), "slot size mismatch", "SharedIndex");
+    detail::shmCheck(std::has_single_bit(hdr->slotCnt), "corrupt slot count", "SharedIndex");
+    detail::shmCheck(size >= HEADER_SIZE + hdr->slotCnt * sizeof(Slot), "region too small", "SharedIndex");
+    _hdr = const_cast<IndexHdr*>(hdr);
+    _slots = reinterpret_cast<Slot*>(const_cast<uint8_t*>(buffer) + HEADER_SIZE);
+    _mask = _hdr->slotCnt - 1;
+    _readOnly = true;
+  }
+
+  // Returns SHM_NULL if key is not present.
+  ShmHandle find(const Key& key) const noexcept {
+    const uint64_t h = detail::shmHash(key);
+    const uint64_t tag = tagOf(h);
+    for (size_t i = h & _mask;; i = (i + 1) & _mask) {
+      const uint64_t ctrl = _slots[i].ctrl.load(std::memory_order_acquire);
+      if (ctrl == EMPTY) {
+        return SHM_NULL;
+      }
+      if ((ctrl & TOMBSTONE) == tag && equal(_slots[i].key, key)) {
+        return static_cast<ShmHandle>(ctrl);
+      }
+    }
+  }
+
+  // Returns false if key is already present or the index is full.
+  bool insert(const Key& key, ShmHandle handle) {
+    writable();
+    if (handle == SHM_NULL || _hdr->used + 1 >= _hdr->slotCnt) {
+      return false;
+    }
+    const uint64_t h = detail::shmHash(key);
+    const uint64_t tag = tagOf(h);
+    for (size_t i = h & _mask;; i = (i + 1) & _mask) {
+      Slot& slot = _slots[i];
+      const uint64_t ctrl = slot.ctrl.load(std::memory_order_relaxed);
+      if (ctrl == EMPTY) {
+        slot.key = key;
+        slot.ctrl.store(tag | handle, std::memory_order_release);
+        ++_hdr->used;
+        _hdr->size.fetch_add(1, std::memory_order_relaxed);
+        return true;
+      }
+      if ((ctrl & TOMBSTONE) == tag && equal(slot.key, key)) {
+        return false;
+      }
+    }
+  }
+
+  // Returns erased handle or SHM_NULL.
+  ShmHandle erase(const Key& key) {
+    writable();
+    const uint64_t h = detail::shmHash(key);
+    const uint64_t tag = tagOf(h);
+    for (size_t i = h & _mask;; i = (i + 1) & _mask) {
+      Slot& slot = _slots[i];
+      const uint64_t ctrl = slot.ctrl.load(std::memory_order_relaxed);
+      if (ctrl == EMPTY) {
+        return SHM_NULL;
+      }
+      if ((ctrl & TOMBSTONE) == tag && equal(slot.key, key)) {
+        slot.ctrl.store(TOMBSTONE, std::memory_order_release);
+        _hdr->size.fetch_sub(1, std::memory_order_relaxed);
+        return static_cast<ShmHandle>(ctrl);
+      }
+    }
+  }
+
+  // Calls handler(key, handle) for every live entry, in slot order.
+  template <typename Handler>
+  void forEach(Handler&& handler) const {
+    for (size_t i = 0; i < _hdr->slotCnt; ++i) {
+      const uint64_t ctrl = _slots[i].ctrl.load(std::memory_order_acquire);
+      if (ctrl != EMPTY && ctrl != TOMBSTONE) {
+        handler(_slots[i].key, static_cast<ShmHandle>(ctrl));
+      }
+    }
+  }
+
+  size_t size() const noexcept { return _hdr->size.load(std::memory_order_relaxed); }
+  size_t slotCount() const noexcept { return _hdr->slotCnt; }
+  bool readOnly() const noexcept { return _readOnly; }
+
+private:
+  // Upper 32 bits of the hash, never 0 and never all ones so it cannot collide with EMPTY/TOMBSTONE.
+  static uint64_t tagOf(uint64_t h) noexcept {
+    uint64_t tag = (h | 0x100000000ULL) & TOMBSTONE;
+    return tag == TOMBSTONE ? 0xFFFFFFFE00000000ULL : tag;
+  }
+
+  static bool equal(const Key& lhs, const Key& rhs) noexcept {
+    return std::memcmp(&lhs, &rhs, sizeof(Key)) == 0;
+  }
+
+  void writable() const {
+    if (_readOnly) [[unlikely]] {
+      throw std::logic_error("SharedIndex: region attached read-only");
+    }
+  }
+
+  IndexHdr* _hdr = nullptr;
+  Slot* _slots = nullptr;
+  size_t _mask = 0;
+  bool _readOnly = true;
+};
+
+/**
+ * SharedTable: SharedPool of Values plus SharedIndex by Key in one region.
+ * Typical use: a loader process creates the table in a WritableMmap file and fills it;
+ * other processes map the same file with ReadableMmap and attach read-only, so reference
+ * data (instruments, accounts) is loaded and hashed once.
+ */
+template <typename Key, typename Value>
+class SharedTable {
+  struct alignas (ALIGNAS) TableHdr {
+    uint64_t signature;
+    uint64_t capacity;
+    uint64_t indexSize;
+  };
+
+public:
+  using Index = SharedIndex<Key>;
+  using Pool = SharedPool<Value>;
+  static constexpr size_t HEADER_SIZE = detail::shmAlign(sizeof(TableHdr));
+  static constexpr uint64_t SIGNATURE = detail::shmSignature<Key, Value>(0x7461626c);
+
+  static constexpr size_t requiredSize(size_t capacity) noexcept {
+    return HEADER_SIZE + detail::shmAlign(Index::requiredSize(capacity)) + Pool::requiredSize(capacity);
+  }
+
+  void initialize(uint8_t* buffer, size_t size, size_t capacity) {
+    detail::shmCheck(size >= requiredSize(capacity), "region too small", "SharedTable");
+    TableHdr* hdr = reinterpret_cast<TableHdr*>(buffer);
+    hdr->signature = SIGNATURE;
+    hdr->capacity = capacity;
+    hdr->indexSize = detail::shmAlign(Index::requiredSize(capacity));
+    _index.initialize(buffer + HEADER_SIZE, hdr->indexSize, capacity);
+    _pool.initialize(buffer + HEADER_SIZE + hdr->indexSize, Pool::requiredSize(capacity), capacity);
+  }
+
+  void attach(uint8_t* buffer, size_t size) {
+    const TableHdr& hdr = header(buffer, size);
+    _index.attach(buffer + HEADER_SIZE, hdr.indexSize);
+    _pool.attach(buffer + HEADER_SIZE + hdr.indexSize, size - HEADER_SIZE - hdr.indexSize);
+  }
+
+  void attach(const uint8_t* buffer, size_t size) {
+    const TableHdr& hdr = header(buffer, size);
+    _index.attach(buffer + HEADER_SIZE, hdr.indexSize);
+    _pool.attach(buffer + HEADER_SIZE + hdr.indexSize, size - HEADER_SIZE - hdr.indexSize);
+  }
+
+  // Constructs value for key; the entry becomes visible to readers once fully written.
+  // Returns {existing, false} if key is present, {nullptr, false} if the table is full.
+  template <typename ... Args>
+  std::pair<Value*, bool> emplace(const Key& key, Args&&... args) {
+    if (ShmHandle existing = _index.find(key); existing != SHM_NULL) {
+      return {_pool.get(existing), false};
+    }
+    ShmHandle handle = _pool.allocate();
+    if (handle == SHM_NULL) {
+      return {nullptr, false};
+    }
+    Value* value = new (_pool.get(handle)) Value(std::forward<Args>(args)...);
+    if (!_index.insert(key, handle)) {
+      _pool.free(handle);
+      return {nullptr, false};
+    }
+    return {value, true};
+  }
+
+  bool erase(const Key& key) {
+    ShmHandle handle = _index.erase(key);
+    _pool.free(handle);
+    return handle != SHM_NULL;
+  }
+
+  Value* find(const Key& key) noexcept {
+    return _pool.get(_index.find(key));
+  }
+
+  const Value* find(const Key& key) const noexcept {
+    return _pool.get(_index.find(key));
+  }
+
+  ShmHandle handle(const Key& key) const noexcept {
+    return _index.find(key);
+  }
+
+  Value* get(ShmHandle handle) noexcept { return _pool.get(handle); }
+  const Value* get(ShmHandle handle) const noexcept { return _pool.get(handle); }
+
+  size_t size() const noexcept { return _index.size(); }
+  size_t capacity() const noexcept { return _pool.capacity(); }
+  bool readOnly() const noexcept { return _pool.readOnly(); }
+
+  const Index& index() const noexcept { return _index; }
+
+private:
+  static const TableHdr& header(const uint8_t* buffer, size_t size) {
+    detail::shmCheck(size >= HEADER_SIZE, "region too small", "SharedTable");
+    const TableHdr& hdr = *reinterpret_cast<const TableHdr*>(buffer);
+    detail::shmCheck(hdr.signature == SIGNATURE, "signature mismatch", "SharedTable");
+    detail::shmCheck(size >= HEADER_SIZE + hdr.indexSize, "region too small", "SharedTable");
+    return hdr;
+  }
+
+  Index _index;
+  Pool _pool;
+};
+
+} // namespace hw::utility
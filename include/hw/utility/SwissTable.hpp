@@ -49,7 +49,9 @@ enum class DuplicatePolicy    { Reject, Overwrite };
 // https://www.intel.com/content/www/us/en/docs/intrinsics-guide/index.html#techs=SSE_ALL
 
 
-template <typename Value, size_t MAX_KEYS, DuplicatePolicy Policy>
+// Payload is what the table stores per key: Value* by default, or a compact 32-bit pool
+// handle (see HandlePool.hpp) where Payload{} marks an absent value.
+template <typename Value, size_t MAX_KEYS, DuplicatePolicy Policy, typename Payload = Value*>
 class HashmapST {
   static_assert (!(MAX_KEYS & (MAX_KEYS - 1)));
   static_assert (MAX_KEYS >= 16);
@@ -63,15 +65,15 @@ class HashmapST {
 #endif
 
 public:
-  HashmapST() :_size(0) {
+  HashmapST() :_size(0), _tombstones(0) {
     _ctrl.fill(Control::Empty);
     mirror_tail_();
     _keys.fill(0);
-    _values.fill(nullptr);
+    _values.fill(Payload{});
   }
 
-  // returns payload pointer or nullptr
-  inline Value * find (uint64_t key) const noexcept {
+  // returns payload (pointer or handle) or Payload{} if not found
+  inline Payload find (uint64_t key) const noexcept {
     const uint64_t h = detail::hash(key);
     const int8_t tag = static_cast<int8_t>(h & 0x7F); // tag is first 7 bits
     const size_t idx = (h >> 7) & (MAX_KEYS - 1);        // starting slot
@@ -117,13 +119,13 @@ public:
 
       // early exit if nay byte in the group is Empty
       const uint32_t emptyMask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8 (Control:: Empty))));
-      if (emptyMask) [[likely]] return nullptr;
+      if (emptyMask) [[likely]] return Payload{};
     }
-    return nullptr;
+    return Payload{};
   }
 
   // insert or update; returns false if table is fuLl
-  inline bool insert(uint64_t key, Value* value) noexcept {
+  inline bool insert(uint64_t key, Payload value) noexcept {
     const uint64_t hashval = detail::hash(key);
     const int8_t tag = static_cast<int8_t>(hashval & 0x7F);
     const size_t idx = (hashval >> 7) & (MAX_KEYS - 1);
@@ -134,6 +136,7 @@ public:
 
       // Empty or Deleted: claim slot
       if (ctrl < 0) {
+        if (ctrl == Control::Deleted) --_tombstones;
         set_ctrl_(pos, tag);
         _keys   [pos] = key;
         _values [pos] = value;
@@ -166,8 +169,9 @@ public:
       if (c == Control::Empty) return;
       if (c == tag && _keys[pos] == key) {
         set_ctrl_(pos, Control::Deleted);
-        _values[pos] = nullptr;
+        _values[pos] = Payload{};
         if (_size) --_size;
+        ++_tombstones;
         return;
       }
     }
@@ -175,15 +179,18 @@ public:
 
   inline size_t size() const noexcept { return _size; }
   static constexpr size_t capacity() noexcept { return MAX_KEYS; }
+  // Deleted slots not yet reused; they lengthen probes like live keys do.
+  inline size_t tombstones() const noexcept { return _tombstones; }
 
   inline void clear() noexcept {
     for (size_t i = 0; i < MAX_KEYS; ++i) {
       _ctrl   [i] = Control::Empty;
       _keys   [i] = 0;
-      _values [i] = nullptr;
+      _values [i] = Payload{};
     }
     mirror_tail_();
     _size = 0;
+    _tombstones = 0;
   }
 
 
@@ -196,7 +203,7 @@ public:
       const int8_t c = _ctrl[pos];
       if (c >= 0) {// Skip Empty/Deleted
         const uint64_t key = _keys[pos];
-        if (_values[pos] == nullptr) continue;
+        if (_values[pos] == Payload{}) continue;
         const uint64_t h = detail::hash(key);
         const size_t idx = (h >> 7) & (MAX_KEYS -1);
         const size_t distance = (pos + MAX_KEYS - idx) & (MAX_KEYS -1);
@@ -209,8 +216,9 @@ private:
   // control bytes with tail padding to allow safe 16-byte Loads near the end
   alignas (16) std::array<int8_t, MAX_KEYS + SIMD_SIZE> _ctrl;
   std::array<uint64_t, MAX_KEYS> _keys;
-  std::array<Value*, MAX_KEYS> _values;
+  std::array<Payload, MAX_KEYS> _values;
   size_t _size;
+  size_t _tombstones;
 
   // copy first SIMD_SIZE control bytes to tail (indices [MAX_KEYS ... MAX_KEYS+SIMD_SIZE-1])
   inline void mirror_tail_() noexcept {
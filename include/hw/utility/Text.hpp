@@ -100,40 +100,93 @@ inline std::string toLower(std::string s) {
   return s;
 }
 
+// Case-insensitive ASCII comparison without building lower-case copies.
+[[nodiscard]]
+inline constexpr bool equalsIgnoreCase(std::string_view a, std::string_view b) noexcept {
+  if (a.size() != b.size()) return false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    const char x = (a[i] >= 'A' && a[i] <= 'Z') ? static_cast<char>(a[i] + 32) : a[i];
+    const char y = (b[i] >= 'A' && b[i] <= 'Z') ? static_cast<char>(b[i] + 32) : b[i];
+    if (x != y) return false;
+  }
+  return true;
+}
+
+/**
+ * fromChars: string_view parsing of numbers with no temporary strings.
+ * - Integers: decimal, or hex with a 0x prefix; 128-bit integers included.
+ * - bool: true/false (any case), 1 or 0, as fromString accepts them.
+ * - Errors throw std::invalid_argument, the only path that allocates.
+ */
 template <typename T>
-T fromString(const std::string& str) {
-  if constexpr (std::is_same_v<T, std::string>) {
-    return str;
+T fromChars(std::string_view str) {
+  const char* begin = str.data();
+  const char* end = begin + str.size();
+  if constexpr (std::is_same_v<T, bool>) {
+    if (str == "1" || equalsIgnoreCase(str, "true")) return true;
+    if (str == "0" || equalsIgnoreCase(str, "false")) return false;
+    throw std::invalid_argument("Invalid boolean value: '" + std::string(str) + "'");
   }
-  else if constexpr (std::is_same_v<T, bool>) {
-    const std::string s = trim(toLower(str));
-    if (s == "true" || s == "1") return true;
-    if (s == "false" || s == "0") return false;
-    throw std::invalid_argument("Invalid boolean value: '" + str + "'");
+  else if constexpr (std::is_same_v<T, __int128_t> || std::is_same_v<T, __uint128_t>) {
+    const bool negative = std::is_same_v<T, __int128_t> && begin != end && *begin == '-';
+    begin += negative;
+    unsigned base = 10;
+    if (end - begin > 2 && begin[0] == '0' && (begin[1] == 'x' || begin[1] == 'X')) {
+      base = 16;
+      begin += 2;
+    }
+    __uint128_t value = 0;
+    const char* p = begin;
+    for (; p != end; ++p) {
+      unsigned digit;
+      if (*p >= '0' && *p <= '9') digit = static_cast<unsigned>(*p - '0');
+      else if (base == 16 && (*p | 0x20) >= 'a' && (*p | 0x20) <= 'f') digit = static_cast<unsigned>((*p | 0x20) - 'a' + 10);
+      else break;
+      if (__builtin_mul_overflow(value, base, &value) || __builtin_add_overflow(value, digit, &value)) break;
+    }
+    const __uint128_t limit = std::is_same_v<T, __int128_t> ? (~__uint128_t{0} >> 1) + negative : ~__uint128_t{0};
+    if (p == begin || p != end || value > limit) {
+      throw std::invalid_argument("Invalid integral conversion for: " + std::string(str));
+    }
+    return negative ? static_cast<T>(-value) : static_cast<T>(value);
   }
   else if constexpr (std::is_integral_v<T>) {
     T value;
     int base = 10;
-    const char* begin = str.data();
-    const char* end = begin + str.size();
-    if ((str.size() > 2) && (str[0] == '0') && (std::tolower(str[1]) == 'x')) {
+    if ((str.size() > 2) && (str[0] == '0') && (str[1] == 'x' || str[1] == 'X')) {
       base = 16;
       begin += 2;
     }
     auto [ptr, ec] = std::from_chars(begin, end, value, base);
     if (ec != std::errc() || ptr != end) {
-      throw std::invalid_argument("Invalid integral conversion for: " + str);
+      throw std::invalid_argument("Invalid integral conversion for: " + std::string(str));
     }
     return value;
   }
   else if constexpr (std::is_floating_point_v<T>) {
     T value;
-    auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
-    if (ec != std::errc() || ptr != (str.data() + str.size())) {
-      throw std::invalid_argument("Invalid numeric conversion for: " + str);
+    auto [ptr, ec] = std::from_chars(begin, end, value);
+    if (ec != std::errc() || ptr != end) {
+      throw std::invalid_argument("Invalid numeric conversion for: " + std::string(str));
     }
     return value;
   }
+  else {
+    static_assert(sizeof(T) == 0, "Unsupported type for conversion");
+  }
+}
+
+template <typename T>
+T fromString(const std::string& str) {
+  if constexpr (std::is_same_v<T, std::string>) {
+    return str;
+  }
+  else if constexpr (std::is_same_v<T, bool>) {
+    return fromChars<bool>(trim(str));
+  }
+  else if constexpr (std::is_integral_v<T> || std::is_floating_point_v<T>) {
+    return fromChars<T>(str);
+  }
   else if constexpr (std::is_same_v<T, std::chrono::system_clock::time_point>) {
     std::tm tm = {};
     std::istringstream iss(str);
@@ -0,0 +1,752 @@
+#pragma once
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <errno.h>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <hw/utility/EPoller.hpp>
+
+namespace hw::utility {
+
+struct URingConfig {
+  unsigned entries = 256;       // submission queue entries; completion queue gets twice as many
+  unsigned bufferCount = 256;   // provided receive buffers (power of 2)
+  unsigned bufferSize = 4096;   // bytes per receive buffer
+  bool sqpoll = false;          // kernel thread polls the submission queue; no syscalls on the hot path
+  unsigned sqpollIdleMs = 100;  // idle time before the SQPOLL thread sleeps
+  int sqpollCpu = -1;           // pin the SQPOLL thread
+};
+
+/**
+ * URingPoller: io_uring backend with the same interface and EventHandler contract as EPoller.
+ * - Listening sockets use multishot accept; accepted sockets are handed out by accept()
+ *   from ACCEPT_READY, exactly as with EPoller.
+ * - Connected sockets use multishot recv into a registered ring of provided buffers.
+ *   DATA_READY is raised once per poll() for every socket with pending data; the handler
+ *   drains it with read() (0 bytes means the peer closed). Unread data is reported again
+ *   on the next poll(), like level-triggered epoll.
+ * - write() queues the data and returns at once; queued writes of all sockets are
+ *   submitted together by flush() (dispatcher batch end) or the next poll().
+ * - Without SQPOLL a poll() enters the kernel only when there is something to submit or
+ *   the kernel flags pending completions (COOP_TASKRUN); with SQPOLL it never does.
+ * - Requires Linux 6.0+ (provided buffer rings, multishot accept/recv).
+ */
+class URingPoller {
+  enum Op : uint64_t { OP_ACCEPT = 1, OP_RECV = 2, OP_CONNECT = 3, OP_SEND = 4, OP_MASK = 7 };
+
+  struct RxChunk {
+    uint16_t bid;
+    uint32_t len;
+    uint32_t off;
+  };
+
+  struct alignas (8) Connection {
+    int fd = -1;
+    SocketType type = SocketType::TCP_CLIENT;
+    bool connected = false;
+    bool closing = false;
+    bool recvArmed = false;
+    bool eof = false;
+    bool txQueued = false;
+    int err = 0;
+    int inflight = 0;           // submitted requests that will still produce a completion
+    EventHandler handler;
+    sockaddr_in addr {};        // connect() target; must outlive the request
+    std::deque<int> accepted;   // server: sockets accepted but not yet taken by accept()
+    std::deque<RxChunk> rx;
+    std::vector<uint8_t> txFlight;
+    size_t txFlightOff = 0;
+    std::vector<uint8_t> txQueue;
+  };
+
+  static constexpr uint16_t BUFFER_GROUP = 0;
+  static constexpr size_t MAX_TX_QUEUE = 4 * 1024 * 1024;
+
+public:
+  explicit URingPoller(const URingConfig & config = {}) : _config(config) {
+    if (!std::has_single_bit(config.bufferCount) || config.bufferCount > 32768) {
+      throw std::invalid_argument("URingPoller: bufferCount must be a power of 2 <= 32768");
+    }
+    try {
+      setupRing();
+      setupBuffers();
+    }
+    catch (...) {
+      release();
+      throw;
+    }
+  }
+
+  ~URingPoller() {
+    for (auto & conn : _connections) {
+      if (conn) {
+        for (int sock : conn->accepted) ::close(sock);
+        ::close(conn->fd);
+      }
+    }
+    release();
+  }
+
+  URingPoller(const URingPoller &) = delete;
+  URingPoller & operator = (const URingPoller &) = delete;
+
+  std::pair<int, int> listen (const std::string & host, uint16_t port, const EventHandler & handler) {
+    int sock = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (sock < 0) {
+      return returnError(sock);
+    }
+    int optval = 1;
+    ::setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval));
+
+    sockaddr_in addr {};
+    if (makeAddress(addr, host, port) <= 0) {
+      return returnError(sock);
+    }
+    if (::bind(sock, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0 ||
+        ::listen(sock, SOMAXCONN) < 0) {
+      return returnError(sock);
+    }
+    Connection & conn = add(sock, SocketType::TCP_SERVER, true, handler);
+    armAccept(conn);
+    return std::make_pair(sock, 0);
+  }
+
+  std::pair<int, int> accept (int svrsock, const EventHandler & handler) {
+    Connection * server = find(svrsock);
+    if (!server || server->accepted.empty()) {
+      return std::make_pair(-1, EAGAIN);
+    }
+    int sock = server->accepted.front();
+    server->accepted.pop_front();
+    Connection & conn = add(sock, SocketType::TCP_CLIENT, true, handler);
+    armRecv(conn);
+    return std::make_pair(sock, 0);
+  }
+
+  std::pair<int, int> connect (const std::string & host, uint16_t port, const EventHandler & handler) {
+    int sock = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (sock < 0) {
+      return returnError(sock);
+    }
+    sockaddr_in addr {};
+    if (makeAddress(addr, host, port) <= 0) {
+      return returnError(sock);
+    }
+    Connection & conn = add(sock, SocketType::TCP_CLIENT, false, handler);
+    conn.addr = addr;
+    io_uring_sqe & sqe = nextSqe();
+    sqe.opcode = IORING_OP_CONNECT;
+    sqe.fd = sock;
+    sqe.addr = reinterpret_cast<uint64_t>(&conn.addr);
+    sqe.off = sizeof(conn.addr);
+    commitSqe(sqe, conn, OP_CONNECT);
+    return std::make_pair(sock, 0);
+  }
+
+  // Queued writes and data not yet read are dropped; call flush() first to send queued data.
+  int close (int sock) {
+    Connection * conn = find(sock);
+    if (!conn) return -1;
+
+    conn->closing = true;
+    std::erase(_readable, conn);
+    std::erase(_rearm, conn);
+    std::erase(_txDirty, conn);
+    std::replace(_dispatching.begin(), _dispatching.end(), conn, static_cast<Connection *>(nullptr));
+    for (const RxChunk & chunk : conn->rx) {
+      recycle(chunk.bid);
+    }
+    conn->rx.clear();
+    for (int fd : conn->accepted) {
+      ::close(fd);
+    }
+    conn->accepted.clear();
+
+    // shutdown completes pending recv/accept; cancel covers the rest
+    ::shutdown(sock, SHUT_RDWR);
+    if (conn->inflight > 0) {
+      cancel(*conn, conn->type == SocketType::TCP_SERVER ? OP_ACCEPT : OP_RECV);
+      submit();
+      _zombies.emplace_back(std::move(_connections[sock]));
+    }
+    else {
+      _connections[sock].reset();
+    }
+    ::close(sock);
+    return 0;
+  }
+
+  bool connected (int sock) const {
+    const Connection * conn = find(sock);
+    return conn && conn->connected;
+  }
+
+  int write (int sock, const void *data, size_t datalen, size_t & bytes_written) {
+    bytes_written = 0;
+    Connection * conn = find(sock);
+    if (!conn) [[unlikely]] {
+      return EBADF;
+    }
+    if (!conn->connected || conn->txQueue.size() + datalen > MAX_TX_QUEUE) [[unlikely]] {
+      return EAGAIN;
+    }
+    const uint8_t * bytes = static_cast<const uint8_t *>(data);
+    conn->txQueue.insert(conn->txQueue.end(), bytes, bytes + datalen);
+    if (!conn->txQueued) {
+      conn->txQueued = true;
+      _txDirty.push_back(conn);
+    }
+    bytes_written = datalen;
+    return 0;
+  }
+
+  int read (int sock, void *data, size_t datalen, size_t & bytes_read) {
+    bytes_read = 0;
+    Connection * conn = find(sock);
+    if (!conn) [[unlikely]] {
+      return EBADF;
+    }
+    uint8_t * out = static_cast<uint8_t *>(data);
+    while (datalen && !conn->rx.empty()) {
+      RxChunk & chunk = conn->rx.front();
+      const size_t n = std::min<size_t>(datalen, chunk.len - chunk.off);
+      std::memcpy(out + bytes_read, buffer(chunk.bid) + chunk.off, n);
+      bytes_read += n;
+      datalen -= n;
+      chunk.off += n;
+      if (chunk.off == chunk.len) {
+        recycle(chunk.bid);
+        conn->rx.pop_front();
+      }
+    }
+    if (bytes_read || conn->eof) {
+      return 0;
+    }
+    return conn->err ? conn->err : EAGAIN;
+  }
+
+  // EPoller interface: every socket is received into provided buffers and drained through read().
+  int stageReads (int sock) {
+    return find(sock) ? 0 : -1;
+  }
+
+  // Starts queued sends, re-arms receives and submits everything in one system call.
+  void flush () {
+    prepare();
+    submit();
+  }
+
+  int poll (int timeout_ms = 0) {
+    prepare();
+    submit();
+    int n = reap();
+    if (n == 0 && timeout_ms > 0) {
+      __kernel_timespec ts {timeout_ms / 1000, (timeout_ms % 1000) * 1'000'000LL};
+      submit(1, &ts);
+      n = reap();
+    }
+    dispatchReadable();
+    return n;
+  }
+
+  std::pair<std::string, uint16_t> peerinfo(int sock) {
+    std::string ip;
+    uint16_t port = 0;
+    sockaddr_storage as;
+    socklen_t len = sizeof (as);
+    if (getpeername(sock, reinterpret_cast<sockaddr*>(&as), &len) == 0 && as.ss_family == AF_INET) {
+      sockaddr_in* sin = reinterpret_cast<sockaddr_in*>(&as);
+      char ip_buf[INET_ADDRSTRLEN];
+      inet_ntop (AF_INET, & (sin->sin_addr), ip_buf, INET_ADDRSTRLEN);
+      ip = ip_buf;
+      port = ntohs(sin->sin_port);
+    }
+    return {ip, port};
+  }
+
+  // True if the kernel accepted IORING_SETUP_SQPOLL (it may be refused without privileges).
+  bool sqpoll() const noexcept { return _sqpoll; }
+
+private:
+  static int makeAddress (sockaddr_in & addr, const std::string & host, uint16_t port) {
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    return ::inet_pton(AF_INET, host.c_str(), &addr.sin_addr);
+  }
+
+  static std::pair<int, int> returnError(int sock) {
+    int ec = errno;
+    if (sock >= 0) {
+      ::close (sock);
+    }
+    return std::make_pair(-1, ec);
+  }
+
+  static int setup(unsigned entries, io_uring_params & params) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+  }
+
+  int enter(unsigned toSubmit, unsigned minComplete, unsigned flags, const void * arg = nullptr, size_t argsz = 0) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, _fd, toSubmit, minComplete, flags, arg, argsz));
+  }
+
+  void setupRing() {
+    io_uring_params params {};
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = _config.entries * 2;
+    if (_config.sqpoll) {
+      params.flags |= IORING_SETUP_SQPOLL;
+      params.sq_thread_idle = _config.sqpollIdleMs;
+      if (_config.sqpollCpu >= 0) {
+        params.flags |= IORING_SETUP_SQ_AFF;
+        params.sq_thread_cpu = static_cast<uint32_t>(_config.sqpollCpu);
+      }
+      _fd = setup(_config.entries, params);
+      _sqpoll = _fd >= 0;
+    }
+    if (_fd < 0) {
+      params = {};
+      params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_COOP_TASKRUN | IORING_SETUP_TASKRUN_FLAG;
+      params.cq_entries = _config.entries * 2;
+      _fd = setup(_config.entries, params);
+    }
+    if (_fd < 0) {
+      throw std::system_error(std::error_code(errno, std::system_category()), "io_uring_setup failed");
+    }
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_EXT_ARG)) {
+      throw std::runtime_error("io_uring: kernel too old");
+    }
+
+    _ringSize = std::max(params.sq_off.array + params.sq_entries * sizeof(unsigned),
+                         params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+    _ringMem = ::mmap(nullptr, _ringSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQ_RING);
+    _sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    _sqes = static_cast<io_uring_sqe *>(::mmap(nullptr, _sqesSize, PROT_READ | PROT_WRITE,
+                                               MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQES));
+    if (_ringMem == MAP_FAILED || _sqes == MAP_FAILED) {
+      auto cerrno = errno;
+      // release() unmaps whichever mapping succeeded and closes the ring
+      _ringMem = _ringMem == MAP_FAILED ? nullptr : _ringMem;
+      _sqes = _sqes == MAP_FAILED ? nullptr : _sqes;
+      throw std::system_error(std::error_code(cerrno, std::system_category()), "io_uring mmap failed");
+    }
+
+    uint8_t * ring = static_cast<uint8_t *>(_ringMem);
+    _sqHead    = reinterpret_cast<unsigned *>(ring + params.sq_off.head);
+    _sqTailPtr = reinterpret_cast<unsigned *>(ring + params.sq_off.tail);
+    _sqFlags   = reinterpret_cast<unsigned *>(ring + params.sq_off.flags);
+    _sqMask    = *reinterpret_cast<unsigned *>(ring + params.sq_off.ring_mask);
+    _sqEntries = params.sq_entries;
+    _cqHead    = reinterpret_cast<unsigned *>(ring + params.cq_off.head);
+    _cqTail    = reinterpret_cast<unsigned *>(ring + params.cq_off.tail);
+    _cqMask    = *reinterpret_cast<unsigned *>(ring + params.cq_off.ring_mask);
+    _cqes      = reinterpret_cast<io_uring_cqe *>(ring + params.cq_off.cqes);
+    // SQE slots are used in ring order, so the indirection array is identity
+    unsigned * array = reinterpret_cast<unsigned *>(ring + params.sq_off.array);
+    for (unsigned i = 0; i < _sqEntries; ++i) {
+      array[i] = i;
+    }
+    _sqTail = *_sqTailPtr;
+  }
+
+  // Closing the ring cancels everything still in flight; also undoes a partial setup.
+  void release() noexcept {
+    if (_fd >= 0) {
+      ::close(_fd);
+    }
+    if (_sqes) {
+      ::munmap(_sqes, _sqesSize);
+    }
+    if (_ringMem) {
+      ::munmap(_ringMem, _ringSize);
+    }
+    if (_bufRing) {
+      ::munmap(_bufRing, _bufRingSize);
+    }
+    if (_buffers) {
+      ::munmap(_buffers, size_t(_config.bufferCount) * _config.bufferSize);
+    }
+  }
+
+  void setupBuffers() {
+    const size_t bufferBytes = size_t(_config.bufferCount) * _config.bufferSize;
+    _bufRingSize = std::max<size_t>(_config.bufferCount * sizeof(io_uring_buf), ::sysconf(_SC_PAGESIZE));
+    _bufRing = static_cast<io_uring_buf_ring *>(::mmap(nullptr, _bufRingSize, PROT_READ | PROT_WRITE,
+                                                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0));
+    _buffers = static_cast<uint8_t *>(::mmap(nullptr, bufferBytes, PROT_READ | PROT_WRITE,
+                                             MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0));
+    if (_bufRing == MAP_FAILED || _buffers == MAP_FAILED) {
+      _bufRing = _bufRing == MAP_FAILED ? nullptr : _bufRing;
+      _buffers = _buffers == MAP_FAILED ? nullptr : _buffers;
+      throw std::bad_alloc();
+    }
+    _bufMask = static_cast<uint16_t>(_config.bufferCount - 1);
+
+    io_uring_buf_reg reg {};
+    reg.ring_addr = reinterpret_cast<uint64_t>(_bufRing);
+    reg.ring_entries = _config.bufferCount;
+    reg.bgid = BUFFER_GROUP;
+    if (::syscall(__NR_io_uring_register, _fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+      throw std::system_error(std::error_code(errno, std::system_category()), "io_uring buffer ring registration failed");
+    }
+    for (unsigned bid = 0; bid < _config.bufferCount; ++bid) {
+      recycle(static_cast<uint16_t>(bid));
+    }
+  }
+
+  uint8_t * buffer(uint16_t bid) const noexcept {
+    return _buffers + size_t(bid) * _config.bufferSize;
+  }
+
+  // Gives a receive buffer back to the kernel.
+  void recycle(uint16_t bid) noexcept {
+    // Entries start at the ring base (bufs[0].resv overlays the tail). The header's bufs
+    // member is declared through __DECLARE_FLEX_ARRAY, which C++ lays out at offset 8.
+    io_uring_buf & buf = reinterpret_cast<io_uring_buf *>(_bufRing)[_bufTail & _bufMask];
+    buf.addr = reinterpret_cast<uint64_t>(buffer(bid));
+    buf.len = _config.bufferSize;
+    buf.bid = bid;
+    ++_bufTail;
+    std::atomic_ref<uint16_t>(_bufRing->tail).store(_bufTail, std::memory_order_release);
+  }
+
+  Connection * find(int sock) const noexcept {
+    return sock >= 0 && static_cast<size_t>(sock) < _connections.size() ? _connections[sock].get() : nullptr;
+  }
+
+  Connection & add(int sock, SocketType type, bool connected, const EventHandler & handler) {
+    if (static_cast<size_t>(sock) >= _connections.size()) {
+      _connections.resize(std::max<size_t>(sock + 1, _connections.size() * 2));
+    }
+    auto & conn = _connections[sock];
+    conn = std::make_unique<Connection>();
+    conn->fd = sock;
+    conn->type = type;
+    conn->connected = connected;
+    conn->handler = handler;
+    return *conn;
+  }
+
+  static uint64_t key(const Connection & conn, Op op) noexcept {
+    return reinterpret_cast<uint64_t>(&conn) | op;
+  }
+
+  io_uring_sqe & nextSqe() {
+    while (_sqTail - std::atomic_ref<unsigned>(*_sqHead).load(std::memory_order_acquire) >= _sqEntries) {
+      submit();
+    }
+    io_uring_sqe & sqe = _sqes[_sqTail & _sqMask];
+    std::memset(&sqe, 0, sizeof(sqe));
+    return sqe;
+  }
+
+  void commitSqe(io_uring_sqe & sqe, Connection & conn, Op op) noexcept {
+    sqe.user_data = key(conn, op);
+    ++conn.inflight;
+    commitSqe(sqe);
+  }
+
+  // Requests without a connection (cancel) complete with user_data 0.
+  void commitSqe(io_uring_sqe &) noexcept {
+    ++_sqTail;
+    ++_toSubmit;
+    std::atomic_ref<unsigned>(*_sqTailPtr).store(_sqTail, std::memory_order_release);
+  }
+
+  void armAccept(Connection & conn) {
+    io_uring_sqe & sqe = nextSqe();
+    sqe.opcode = IORING_OP_ACCEPT;
+    sqe.fd = conn.fd;
+    sqe.ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe.accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+    commitSqe(sqe, conn, OP_ACCEPT);
+  }
+
+  void armRecv(Connection & conn) {
+    io_uring_sqe & sqe = nextSqe();
+    sqe.opcode = IORING_OP_RECV;
+    sqe.fd = conn.fd;
+    sqe.ioprio = IORING_RECV_MULTISHOT;
+    sqe.flags = IOSQE_BUFFER_SELECT;
+    sqe.buf_group = BUFFER_GROUP;
+    commitSqe(sqe, conn, OP_RECV);
+    conn.recvArmed = true;
+  }
+
+  void send(Connection & conn) {
+    io_uring_sqe & sqe = nextSqe();
+    sqe.opcode = IORING_OP_SEND;
+    sqe.fd = conn.fd;
+    sqe.addr = reinterpret_cast<uint64_t>(conn.txFlight.data() + conn.txFlightOff);
+    sqe.len = static_cast<uint32_t>(conn.txFlight.size() - conn.txFlightOff);
+    sqe.msg_flags = MSG_NOSIGNAL;
+    commitSqe(sqe, conn, OP_SEND);
+  }
+
+  void cancel(Connection & conn, Op op) {
+    io_uring_sqe & sqe = nextSqe();
+    sqe.opcode = IORING_OP_ASYNC_CANCEL;
+    sqe.addr = key(conn, op);
+    commitSqe(sqe);
+  }
+
+  // Moves queued writes in flight (one send per socket at a time keeps stream order)
+  // and re-arms receives stopped for lack of buffers.
+  void prepare() {
+    for (Connection * conn : _txDirty) {
+      conn->txQueued = false;
+      if (conn->txFlight.empty() && !conn->txQueue.empty()) {
+        std::swap(conn->txFlight, conn->txQueue);
+        conn->txFlightOff = 0;
+        send(*conn);
+      }
+    }
+    _txDirty.clear();
+    for (Connection * conn : _rearm) {
+      if (!conn->recvArmed && !conn->eof && !conn->err) {
+        armRecv(*conn);
+      }
+    }
+    _rearm.clear();
+  }
+
+  void submit(unsigned minComplete = 0, const __kernel_timespec * ts = nullptr) {
+    if (_sqpoll) {
+      // orders the tail store before the NEED_WAKEUP check, or a sleeping poller thread is missed
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+    const unsigned sqFlags = std::atomic_ref<unsigned>(*_sqFlags).load(std::memory_order_relaxed);
+    unsigned flags = 0;
+    if (_sqpoll) {
+      if (sqFlags & IORING_SQ_NEED_WAKEUP) {
+        flags |= IORING_ENTER_SQ_WAKEUP;
+      }
+    }
+    else if (!_toSubmit && !minComplete && !(sqFlags & (IORING_SQ_TASKRUN | IORING_SQ_CQ_OVERFLOW))) [[likely]] {
+      return;
+    }
+    if (minComplete || (sqFlags & (IORING_SQ_TASKRUN | IORING_SQ_CQ_OVERFLOW))) {
+      flags |= IORING_ENTER_GETEVENTS;
+    }
+    if (!flags && _sqpoll) {
+      _toSubmit = 0;
+      return;
+    }
+    io_uring_getevents_arg arg {};
+    const void * argp = nullptr;
+    size_t argsz = 0;
+    if (ts) {
+      arg.ts = reinterpret_cast<uint64_t>(ts);
+      argp = &arg;
+      argsz = sizeof(arg);
+      flags |= IORING_ENTER_EXT_ARG;
+    }
+    const int rc = enter(_sqpoll ? 0 : _toSubmit, minComplete, flags, argp, argsz);
+    if (rc >= 0 && !_sqpoll) {
+      _toSubmit -= std::min<unsigned>(_toSubmit, rc);
+    }
+    else if (_sqpoll) {
+      _toSubmit = 0;
+    }
+  }
+
+  int reap() {
+    unsigned head = *_cqHead;
+    unsigned tail = std::atomic_ref<unsigned>(*_cqTail).load(std::memory_order_acquire);
+    int n = 0;
+    while (head != tail) {
+      const io_uring_cqe cqe = _cqes[head & _cqMask];
+      std::atomic_ref<unsigned>(*_cqHead).store(++head, std::memory_order_release);
+      complete(cqe);
+      ++n;
+      if (head == tail) {
+        tail = std::atomic_ref<unsigned>(*_cqTail).load(std::memory_order_acquire);
+      }
+    }
+    return n;
+  }
+
+  void markReadable(Connection & conn) {
+    if (std::find(_readable.begin(), _readable.end(), &conn) == _readable.end()) {
+      _readable.push_back(&conn);
+    }
+  }
+
+  void release(Connection * conn) {
+    std::erase_if(_zombies, [conn] (const auto & zombie) { return zombie.get() == conn; });
+  }
+
+  void complete(const io_uring_cqe & cqe) {
+    if (cqe.user_data == 0) {
+      return; // cancel request
+    }
+    Connection * conn = reinterpret_cast<Connection *>(cqe.user_data & ~uint64_t(OP_MASK));
+    const Op op = static_cast<Op>(cqe.user_data & OP_MASK);
+    const bool more = cqe.flags & IORING_CQE_F_MORE;
+    if (!more) {
+      --conn->inflight;
+    }
+    if (conn->closing) [[unlikely]] {
+      if (cqe.flags & IORING_CQE_F_BUFFER) {
+        recycle(static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT));
+      }
+      if (op == OP_ACCEPT && cqe.res >= 0) {
+        ::close(cqe.res);
+      }
+      if (conn->inflight == 0) {
+        release(conn);
+      }
+      return;
+    }
+
+    switch (op) {
+      case OP_ACCEPT:
+        if (cqe.res >= 0) {
+          conn->accepted.push_back(cqe.res);
+          markReadable(*conn);
+        }
+        if (!more) {
+          armAccept(*conn);
+        }
+        break;
+
+      case OP_RECV:
+        if (cqe.flags & IORING_CQE_F_BUFFER) {
+          const uint16_t bid = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+          if (cqe.res > 0) {
+            conn->rx.push_back(RxChunk{bid, static_cast<uint32_t>(cqe.res), 0});
+          }
+          else {
+            recycle(bid);
+          }
+        }
+        if (cqe.res == 0) {
+          conn->eof = true;
+        }
+        else if (cqe.res < 0 && cqe.res != -ENOBUFS) {
+          conn->err = -cqe.res;
+        }
+        if (!more) {
+          conn->recvArmed = false;
+          if (!conn->eof && !conn->err) {
+            _rearm.push_back(conn);
+          }
+        }
+        if (cqe.res != -ENOBUFS) {
+          markReadable(*conn);
+        }
+        break;
+
+      case OP_CONNECT:
+        if (cqe.res == 0) {
+          conn->connected = true;
+          conn->handler(conn->fd, SocketState::CONNECTED, 0);
+          if (!conn->closing) {
+            armRecv(*conn);
+          }
+        }
+        else {
+          conn->handler(conn->fd, SocketState::ERROR, -cqe.res);
+          if (!conn->closing) {
+            close(conn->fd);
+          }
+        }
+        break;
+
+      case OP_SEND:
+        if (cqe.res < 0) {
+          conn->handler(conn->fd, SocketState::ERROR, -cqe.res);
+          if (!conn->closing) {
+            close(conn->fd);
+          }
+          break;
+        }
+        conn->txFlightOff += cqe.res;
+        if (conn->txFlightOff < conn->txFlight.size()) {
+          send(*conn); // short send: rest of the same buffer goes first
+        }
+        else {
+          conn->txFlight.clear();
+          conn->txFlightOff = 0;
+          if (!conn->txQueue.empty()) {
+            std::swap(conn->txFlight, conn->txQueue);
+            send(*conn);
+          }
+        }
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  // One callback per socket with pending data (or pending accepted sockets) per poll.
+  void dispatchReadable() {
+    if (_readable.empty()) [[likely]] {
+      return;
+    }
+    _dispatching.swap(_readable);
+    for (size_t i = 0; i < _dispatching.size(); ++i) {
+      Connection * conn = _dispatching[i];
+      if (!conn) continue;
+      conn->handler(conn->fd, conn->type == SocketType::TCP_SERVER ? SocketState::ACCEPT_READY : SocketState::DATA_READY, 0);
+      // close() clears entries of this list, so a socket closed by the handler is skipped
+      if (_dispatching[i] && (!conn->rx.empty() || !conn->accepted.empty() || conn->eof || conn->err)) {
+        markReadable(*conn);
+      }
+    }
+    _dispatching.clear();
+  }
+
+  URingConfig _config;
+  int _fd = -1;
+  bool _sqpoll = false;
+
+  void * _ringMem = nullptr;
+  size_t _ringSize = 0;
+  io_uring_sqe * _sqes = nullptr;
+  size_t _sqesSize = 0;
+  unsigned * _sqHead = nullptr;
+  unsigned * _sqTailPtr = nullptr;
+  unsigned * _sqFlags = nullptr;
+  unsigned _sqMask = 0;
+  unsigned _sqEntries = 0;
+  unsigned _sqTail = 0;
+  unsigned _toSubmit = 0;
+  unsigned * _cqHead = nullptr;
+  unsigned * _cqTail = nullptr;
+  unsigned _cqMask = 0;
+  io_uring_cqe * _cqes = nullptr;
+
+  io_uring_buf_ring * _bufRing = nullptr;
+  size_t _bufRingSize = 0;
+  uint8_t * _buffers = nullptr;
+  uint16_t _bufTail = 0;
+  uint16_t _bufMask = 0;
+
+  // indexed by socket descriptor
+  std::vector<std::unique_ptr<Connection>> _connections;
+  // closed connections waiting for their last completions
+  std::vector<std::unique_ptr<Connection>> _zombies;
+  std::vector<Connection *> _readable;
+  std::vector<Connection *> _dispatching;
+  std::vector<Connection *> _rearm;
+  std::vector<Connection *> _txDirty;
+};
+
+}
@@ -43,6 +43,7 @@ public:
     rollWindow_(timestamp);
 
     if (_totalValue >= _limit) [[unlikely]] {
+      ++_rejected;
       return false;
     }
 
@@ -55,6 +56,7 @@ public:
 
   inline size_t	      value()         const noexcept { return _totalValue; }
   inline size_t	      limit()         const noexcept { return _limit; }
+  inline size_t	      rejected()      const noexcept { return _rejected; }
   inline Nanoseconds  resolution()    const noexcept { return _resolution; }
   inline Nanoseconds  lastTimestamp() const noexcept { return _lastTimestamp; }
   inline Nanoseconds  window() const noexcept {
@@ -118,6 +120,7 @@ private:
   std::array<size_t, BUCKETS> _buckets;
   Nanoseconds                 _lastTimestamp;
   size_t                      _totalValue;
+  size_t                      _rejected = 0;
 };
 
 }
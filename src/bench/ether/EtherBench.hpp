@@ -0,0 +1,320 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+#include <hw/utility/Format.hpp>
+#include <hw/assembly/Assembly.hpp>
+
+#include "Histogram.hpp"
+
+namespace hw::bench {
+
+using namespace boost::mp11;
+using utility::Timestamp;
+
+/**
+ * Ether/Dispatcher benchmark: an Assembly of N compartments, each an ether with one producer
+ * dispatcher and M consumer dispatchers, built from a compile-time Setup.
+ * - Producers stamp every message with the assembly clock right before commitMsg; consumers
+ *   take the commit-to-dispatch latency on arrival.
+ * - A producer stays within half a ring of its slowest consumer, so an unthrottled run
+ *   measures the throughput the consumers sustain rather than ending in an overflow.
+ * - Shared ethers live in files under Options::shmDir; the Context config names them, marks
+ *   them for initialization and carries the dispatcher pinning.
+ */
+template <typename EtherMode, size_t N, size_t M, size_t MsgSize, size_t Capacity>
+struct Setup {
+  static_assert(N > 0 && N <= 10 && M > 0 && M <= 10, "up to 10 compartments and 10 consumers each");
+  using EtherTraits = EtherMode;
+  static constexpr bool SHARED = std::is_base_of_v<assembly::SharedEther, EtherMode>;
+  static constexpr size_t COMPARTMENT_CNT = N;
+  static constexpr size_t CONSUMER_CNT = M;
+  static constexpr size_t MSG_SIZE = MsgSize;
+  static constexpr size_t CAPACITY = Capacity;
+};
+
+template <size_t Size>
+struct BenchMsg {
+  static_assert(Size >= 16);
+  Timestamp committed;
+  uint64_t  seqno;
+  uint8_t   payload[Size - 16];
+};
+
+// Prefix followed by one digit per index: IndexedName<"Consumer", 1, 2>() is "Consumer12".
+template <type::NameTag Prefix, size_t... Index>
+consteval auto IndexedName() {
+  static_assert(((Index < 10) && ...));
+  constexpr size_t prefixSize = decltype(Prefix)::tag_size;
+  char name[prefixSize + sizeof...(Index) + 1] {};
+  std::copy_n(Prefix._nametag, prefixSize, name);
+  size_t pos = prefixSize;
+  ((name[pos++] = static_cast<char>('0' + Index)), ...);
+  return type::NameTag(name);
+}
+
+static_assert(IndexedName<"Consumer", 1, 2>().toString() == "Consumer12");
+
+struct alignas(ALIGNAS) ProducerStats {
+  std::atomic<uint64_t> published {0};
+};
+
+struct alignas(ALIGNAS) ConsumerStats {
+  std::atomic<uint64_t> received {0};
+  LatencyHistogram      latency;
+};
+
+template <typename Setup> struct BenchContext;
+template <typename Setup, size_t I> class Producer;
+template <typename Setup, size_t I, size_t J> class Consumer;
+
+template <typename Setup, size_t I>
+using BenchEther = assembly::Ether<IndexedName<"Ether", I>(), type::type_list<BenchMsg<Setup::MSG_SIZE>>,
+                                   Setup::CAPACITY, typename Setup::EtherTraits>;
+
+template <typename Setup, size_t I>
+using ProducerDispatcher = assembly::Dispatcher<IndexedName<"Producer", I>(), BenchContext<Setup>,
+                                                BenchEther<Setup, I>, type::type_list<Producer<Setup, I>>>;
+
+template <typename Setup, size_t I, size_t J>
+using ConsumerDispatcher = assembly::Dispatcher<IndexedName<"Consumer", I, J>(), BenchContext<Setup>,
+                                                BenchEther<Setup, I>, type::type_list<Consumer<Setup, I, J>>>;
+
+template <typename Setup, size_t I, typename = std::make_index_sequence<Setup::CONSUMER_CNT>>
+struct MakeCompartment;
+
+template <typename Setup, size_t I, size_t... J>
+struct MakeCompartment<Setup, I, std::index_sequence<J...>> {
+  using type = assembly::Compartment<BenchContext<Setup>, BenchEther<Setup, I>,
+                                     ProducerDispatcher<Setup, I>, ConsumerDispatcher<Setup, I, J>...>;
+};
+
+template <typename Setup, typename = std::make_index_sequence<Setup::COMPARTMENT_CNT>>
+struct MakeAssembly;
+
+template <typename Setup, size_t... I>
+struct MakeAssembly<Setup, std::index_sequence<I...>> {
+  using type = assembly::Assembly<BenchContext<Setup>, typename MakeCompartment<Setup, I>::type...>;
+};
+
+template <typename Setup>
+struct BenchContext : assembly::Context {
+  using Assembly = typename MakeAssembly<Setup>::type;
+
+  BenchContext(const char * cfgfile, uint64_t rate) : Context("ether_bench", cfgfile), rate(rate) {}
+
+  const uint64_t          rate; // messages per second per producer, 0 for as fast as the ring allows
+  std::atomic<bool>       measuring {false};
+  ProducerStats           producers[Setup::COMPARTMENT_CNT];
+  ConsumerStats           consumers[Setup::COMPARTMENT_CNT][Setup::CONSUMER_CNT];
+};
+
+template <typename Setup, size_t I>
+struct ProducerTraits {
+  using Dispatcher = ProducerDispatcher<Setup, I>;
+};
+
+template <typename Setup, size_t I, size_t J>
+struct ConsumerTraits {
+  using Dispatcher = ConsumerDispatcher<Setup, I, J>;
+};
+
+template <typename Setup, size_t I>
+class Producer : public assembly::ComponentBase<Producer<Setup, I>, IndexedName<"Producer", I>(),
+                                                type::type_list<>, ProducerTraits<Setup, I>> {
+  using Base = assembly::ComponentBase<Producer<Setup, I>, IndexedName<"Producer", I>(),
+                                       type::type_list<>, ProducerTraits<Setup, I>>;
+  using Msg = BenchMsg<Setup::MSG_SIZE>;
+  static constexpr uint64_t BURST = 32;             // per loop, well within the dispatcher's own batch
+  static constexpr uint64_t WINDOW = Setup::CAPACITY / 2;
+
+public:
+  Producer(typename Base::Dispatcher & dispatcher, BenchContext<Setup> & context)
+    : Base(dispatcher, context), _context(context) {}
+
+  void processBegin() {
+    _start = this->clock().now();
+  }
+
+  void processBatchEnd() {
+    uint64_t limit = _published + BURST;
+    for (const ConsumerStats & consumer : _context.consumers[I]) {
+      limit = std::min(limit, consumer.received.load(std::memory_order_acquire) + WINDOW);
+    }
+    if (_context.rate) {
+      const auto elapsed = static_cast<uint64_t>(this->clock().now() - _start);
+      limit = std::min(limit, static_cast<uint64_t>(static_cast<double>(elapsed) * 1e-9 * static_cast<double>(_context.rate)));
+    }
+    if (limit <= _published) {
+      return;
+    }
+    for (; _published < limit; ++_published) {
+      Msg & msg = this->template allocMsg<Msg>();
+      msg.seqno = _published;
+      msg.committed = this->clock().now();
+      this->commitMsg(msg);
+    }
+    _context.producers[I].published.store(_published, std::memory_order_release);
+  }
+
+private:
+  BenchContext<Setup> & _context;
+  uint64_t              _published = 0;
+  Timestamp             _start = 0;
+};
+
+template <typename Setup, size_t I, size_t J>
+class Consumer : public assembly::ComponentBase<Consumer<Setup, I, J>, IndexedName<"Consumer", I, J>(),
+                                                type::type_list<BenchMsg<Setup::MSG_SIZE>>, ConsumerTraits<Setup, I, J>> {
+  using Base = assembly::ComponentBase<Consumer<Setup, I, J>, IndexedName<"Consumer", I, J>(),
+                                       type::type_list<BenchMsg<Setup::MSG_SIZE>>, ConsumerTraits<Setup, I, J>>;
+  using Msg = BenchMsg<Setup::MSG_SIZE>;
+
+public:
+  Consumer(typename Base::Dispatcher & dispatcher, BenchContext<Setup> & context)
+    : Base(dispatcher, context), _stats(context.consumers[I][J]), _measuring(context.measuring) {}
+
+  void processMsg(const Msg & msg) {
+    const Timestamp now = this->clock().now();
+    if (_measuring.load(std::memory_order_relaxed)) {
+      _stats.latency.record(now - msg.committed);
+    }
+    _stats.received.store(++_received, std::memory_order_release);
+  }
+
+private:
+  ConsumerStats &           _stats;
+  const std::atomic<bool> & _measuring;
+  uint64_t                  _received = 0;
+};
+
+struct Options {
+  std::chrono::milliseconds warmup {500};
+  std::chrono::milliseconds duration {2000};
+  uint64_t                  rate = 0;
+  std::string               shmDir = "/dev/shm";
+  std::vector<int>          cores;       // dispatchers are pinned round-robin, unpinned if empty
+  std::string               metricsFile; // assembly metrics of the last scenario, for hw_metrics
+};
+
+struct Result {
+  std::string name;
+  std::string ether;
+  size_t      compartments = 0;
+  size_t      consumers = 0;
+  size_t      msgSize = 0;
+  size_t      capacity = 0;
+  uint64_t    messages = 0;   // published in the measured window, all producers
+  double      msgsPerSec = 0;
+  uint64_t    p50 = 0;
+  uint64_t    p99 = 0;
+  uint64_t    p999 = 0;
+  uint64_t    max = 0;
+};
+
+template <typename Setup>
+std::string ScenarioName() {
+  return frmt::format("{}/n:{}/m:{}/size:{}/capacity:{}", Setup::SHARED ? "shared" : "private",
+    Setup::COMPARTMENT_CNT, Setup::CONSUMER_CNT, Setup::MSG_SIZE, Setup::CAPACITY);
+}
+
+template <typename Setup>
+Result RunScenario(const Options & options) {
+  namespace pt = boost::property_tree;
+  using Context = BenchContext<Setup>;
+  constexpr size_t N = Setup::COMPARTMENT_CNT;
+  constexpr size_t M = Setup::CONSUMER_CNT;
+
+  // Context configuration: shared ether files, dispatcher pinning and the metrics file
+  const std::string prefix = frmt::format("{}/ether_bench.{}.", options.shmDir, ::getpid());
+  std::vector<std::string> etherFiles;
+  pt::ptree config;
+  size_t dispatcher = 0;
+  auto pin = [&] (std::string_view name) {
+    if (!options.cores.empty()) {
+      config.put(pt::ptree::path_type("cpu_affinity/" + std::string(name), '/'),
+                 options.cores[dispatcher++ % options.cores.size()]);
+    }
+  };
+  mp_for_each<mp_iota_c<N>>([&] (auto I) {
+    if constexpr (Setup::SHARED) {
+      const std::string name(IndexedName<"Ether", I>().toString());
+      etherFiles.push_back(prefix + name);
+      config.put(pt::ptree::path_type("ethers/" + name, '/'), etherFiles.back());
+      config.put(pt::ptree::path_type("ether_init/" + name, '/'), "true");
+    }
+    pin(IndexedName<"Producer", I>().toString());
+    mp_for_each<mp_iota_c<M>>([&] (auto J) {
+      pin(IndexedName<"Consumer", I, J>().toString());
+    });
+  });
+  if (!options.metricsFile.empty()) {
+    config.put(pt::ptree::path_type("metrics/file", '/'), options.metricsFile);
+  }
+  const std::string cfgfile = prefix + "json";
+  pt::write_json(cfgfile, config);
+  auto context = std::make_unique<Context>(cfgfile.c_str(), options.rate);
+  std::remove(cfgfile.c_str());
+
+  auto published = [&context] {
+    uint64_t total = 0;
+    for (const ProducerStats & producer : context->producers) {
+      total += producer.published.load(std::memory_order_acquire);
+    }
+    return total;
+  };
+
+  Result result {
+    .name = ScenarioName<Setup>(), .ether = Setup::SHARED ? "shared" : "private",
+    .compartments = N, .consumers = M, .msgSize = Setup::MSG_SIZE, .capacity = Setup::CAPACITY,
+  };
+  {
+    typename Context::Assembly assembly(*context);
+    assembly.initialize();
+    assembly.start();
+    std::this_thread::sleep_for(options.warmup);
+
+    context->measuring = true;
+    const auto start = std::chrono::steady_clock::now();
+    const uint64_t first = published();
+    std::this_thread::sleep_for(options.duration);
+    const uint64_t last = published();
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    context->measuring = false;
+    assembly.stop();
+
+    result.messages = last - first;
+    result.msgsPerSec = static_cast<double>(result.messages) / elapsed;
+  }
+  for (const std::string & file : etherFiles) {
+    std::remove(file.c_str());
+  }
+
+  LatencyHistogram latency;
+  for (auto & compartment : context->consumers) {
+    for (ConsumerStats & consumer : compartment) {
+      latency.merge(consumer.latency);
+    }
+  }
+  result.p50 = latency.percentile(0.50);
+  result.p99 = latency.percentile(0.99);
+  result.p999 = latency.percentile(0.999);
+  result.max = latency.max();
+  return result;
+}
+
+}
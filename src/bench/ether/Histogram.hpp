@@ -0,0 +1,96 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace hw::bench {
+
+/**
+ * LatencyHistogram: log-linear histogram of nanosecond latencies, fixed size, no allocation.
+ * - Values below 64 get a bucket each; every power of two above that is split into 32 buckets,
+ *   so a reported percentile is within ~3% of the recorded values it stands for.
+ * - Written by one thread and read once that thread is done; merge() adds up consumers.
+ * - Negative samples (TSC skew between cores) count as zero.
+ */
+class LatencyHistogram {
+public:
+  static constexpr int SUB_BITS = 5;
+  static constexpr uint64_t SUB_CNT = 1u << SUB_BITS;
+  static constexpr uint64_t LINEAR_CNT = 2 * SUB_CNT;
+  static constexpr size_t BUCKET_CNT = LINEAR_CNT + (64 - SUB_BITS - 1) * SUB_CNT;
+
+  void record(int64_t nanoseconds) noexcept {
+    const uint64_t value = nanoseconds > 0 ? static_cast<uint64_t>(nanoseconds) : 0;
+    ++_buckets[bucket(value)];
+    ++_count;
+    _max = std::max(_max, value);
+  }
+
+  void merge(const LatencyHistogram & other) noexcept {
+    for (size_t i = 0; i < BUCKET_CNT; ++i) {
+      _buckets[i] += other._buckets[i];
+    }
+    _count += other._count;
+    _max = std::max(_max, other._max);
+  }
+
+  // Upper bound of the bucket holding the q-th quantile, q in (0, 1]; never above max().
+  uint64_t percentile(double q) const noexcept {
+    if (_count == 0) {
+      return 0;
+    }
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * static_cast<double>(_count))));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_CNT; ++i) {
+      seen += _buckets[i];
+      if (seen >= rank) {
+        return std::min(highest(i), _max);
+      }
+    }
+    return _max;
+  }
+
+  uint64_t count() const noexcept { return _count; }
+  uint64_t max() const noexcept { return _max; }
+
+  static constexpr size_t bucket(uint64_t value) noexcept {
+    if (value < LINEAR_CNT) {
+      return static_cast<size_t>(value);
+    }
+    const int shift = std::bit_width(value) - SUB_BITS - 1;
+    return static_cast<size_t>(LINEAR_CNT + (shift - 1) * SUB_CNT + (value >> shift) - SUB_CNT);
+  }
+
+  static constexpr uint64_t lowest(size_t index) noexcept {
+    if (index < LINEAR_CNT) {
+      return index;
+    }
+    const uint64_t shift = (index - LINEAR_CNT) / SUB_CNT + 1;
+    return ((index - LINEAR_CNT) % SUB_CNT + SUB_CNT) << shift;
+  }
+
+  static constexpr uint64_t highest(size_t index) noexcept {
+    if (index < LINEAR_CNT) {
+      return index;
+    }
+    const uint64_t shift = (index - LINEAR_CNT) / SUB_CNT + 1;
+    return lowest(index) + ((uint64_t{1} << shift) - 1);
+  }
+
+private:
+  std::array<uint64_t, BUCKET_CNT> _buckets {};
+  uint64_t _count = 0;
+  uint64_t _max = 0;
+};
+
+static_assert(LatencyHistogram::bucket(63) == 63);
+static_assert(LatencyHistogram::bucket(64) == 64 && LatencyHistogram::bucket(65) == 64);
+static_assert(LatencyHistogram::lowest(LatencyHistogram::bucket(1000)) <= 1000);
+static_assert(LatencyHistogram::highest(LatencyHistogram::bucket(1000)) >= 1000);
+static_assert(LatencyHistogram::bucket(UINT64_MAX) == LatencyHistogram::BUCKET_CNT - 1);
+
+}
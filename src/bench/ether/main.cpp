@@ -0,0 +1,158 @@
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <hw/utility/Text.hpp>
+
+#include "EtherBench.hpp"
+
+using namespace hw;
+using namespace hw::bench;
+
+namespace {
+
+using assembly::PrivateEther;
+using assembly::SharedEther;
+
+struct Scenario {
+  std::string name;
+  Result (*run)(const Options &);
+};
+
+template <typename EtherMode, size_t N, size_t M, size_t MsgSize, size_t Capacity>
+Scenario makeScenario() {
+  using S = Setup<EtherMode, N, M, MsgSize, Capacity>;
+  return {ScenarioName<S>(), &RunScenario<S>};
+}
+
+// Fan-out, compartment count, message size and ring size, each varied around 1x1/64B/64K.
+const std::vector<Scenario> & scenarios() {
+  static const std::vector<Scenario> all {
+    makeScenario<PrivateEther, 1, 1, 64,   1 << 16>(),
+    makeScenario<PrivateEther, 1, 2, 64,   1 << 16>(),
+    makeScenario<PrivateEther, 1, 4, 64,   1 << 16>(),
+    makeScenario<PrivateEther, 2, 1, 64,   1 << 16>(),
+    makeScenario<PrivateEther, 2, 2, 64,   1 << 16>(),
+    makeScenario<PrivateEther, 1, 1, 256,  1 << 16>(),
+    makeScenario<PrivateEther, 1, 1, 1024, 1 << 16>(),
+    makeScenario<PrivateEther, 1, 1, 64,   1 << 10>(),
+    makeScenario<PrivateEther, 1, 1, 64,   1 << 13>(),
+    makeScenario<PrivateEther, 1, 1, 64,   1 << 20>(),
+    makeScenario<SharedEther,  1, 1, 64,   1 << 16>(),
+    makeScenario<SharedEther,  1, 2, 64,   1 << 16>(),
+    makeScenario<SharedEther,  2, 2, 64,   1 << 16>(),
+    makeScenario<SharedEther,  1, 1, 1024, 1 << 16>(),
+  };
+  return all;
+}
+
+void usage() {
+  std::cerr <<
+    "usage: ether_bench [options]\n"
+    "  --filter=<text>     run scenarios whose name contains text (all by default)\n"
+    "  --list              print scenario names and exit\n"
+    "  --duration=<ms>     measured window per scenario (2000)\n"
+    "  --warmup=<ms>       run time before measuring (500)\n"
+    "  --rate=<msgs/s>     per producer; 0 publishes as fast as consumers keep up (0)\n"
+    "  --cores=<a,b,...>   pin dispatchers round-robin to these cores\n"
+    "  --shm=<dir>         directory of shared ether files (/dev/shm)\n"
+    "  --json=<file>       JSON results (ether_bench.json)\n"
+    "  --csv=<file>        CSV results\n"
+    "  --metrics=<file>    publish assembly metrics here (hw_metrics reads it)\n";
+}
+
+void writeCsv(const std::string & path, const std::vector<Result> & results) {
+  std::ofstream out(path);
+  out << "name,ether,compartments,consumers,msg_size,capacity,messages,msgs_per_sec,p50_ns,p99_ns,p999_ns,max_ns\n";
+  for (const Result & r : results) {
+    out << frmt::format("{},{},{},{},{},{},{},{:.0f},{},{},{},{}\n", r.name, r.ether, r.compartments,
+      r.consumers, r.msgSize, r.capacity, r.messages, r.msgsPerSec, r.p50, r.p99, r.p999, r.max);
+  }
+}
+
+// Same top-level shape as Google Benchmark's output: a context object and a benchmarks array.
+void writeJson(const std::string & path, const std::vector<Result> & results, const Options & options) {
+  std::ofstream out(path);
+  out << frmt::format("{{\n  \"context\": {{\n    \"executable\": \"ether_bench\",\n"
+                      "    \"duration_ms\": {},\n    \"warmup_ms\": {},\n    \"rate\": {}\n  }},\n"
+                      "  \"benchmarks\": [",
+                      options.duration.count(), options.warmup.count(), options.rate);
+  for (size_t i = 0; i < results.size(); ++i) {
+    const Result & r = results[i];
+    out << frmt::format("{}\n    {{\"name\": \"{}\", \"ether\": \"{}\", \"compartments\": {}, \"consumers\": {}, "
+                        "\"msg_size\": {}, \"capacity\": {}, \"messages\": {}, \"msgs_per_sec\": {:.0f}, "
+                        "\"p50_ns\": {}, \"p99_ns\": {}, \"p999_ns\": {}, \"max_ns\": {}}}",
+                        i ? "," : "", r.name, r.ether, r.compartments, r.consumers, r.msgSize, r.capacity,
+                        r.messages, r.msgsPerSec, r.p50, r.p99, r.p999, r.max);
+  }
+  out << "\n  ]\n}\n";
+}
+
+}
+
+int main(int argc, char ** argv) {
+  Options options;
+  std::string filter;
+  std::string jsonOut = "ether_bench.json";
+  std::string csvOut;
+  bool list = false;
+
+  try {
+    for (int i = 1; i < argc; ++i) {
+      const std::string_view arg(argv[i]);
+      const size_t eq = arg.find('=');
+      const std::string_view key = arg.substr(0, eq);
+      const std::string value(eq == std::string_view::npos ? std::string_view() : arg.substr(eq + 1));
+      if (key == "--filter") filter = value;
+      else if (key == "--list") list = true;
+      else if (key == "--duration") options.duration = std::chrono::milliseconds(utility::fromString<int64_t>(value));
+      else if (key == "--warmup") options.warmup = std::chrono::milliseconds(utility::fromString<int64_t>(value));
+      else if (key == "--rate") options.rate = utility::fromString<uint64_t>(value);
+      else if (key == "--shm") options.shmDir = value;
+      else if (key == "--json") jsonOut = value;
+      else if (key == "--csv") csvOut = value;
+      else if (key == "--metrics") options.metricsFile = value;
+      else if (key == "--cores") {
+        for (const std::string & core : utility::splitString(value, ',')) {
+          options.cores.push_back(utility::fromString<int>(core));
+        }
+      }
+      else {
+        usage();
+        return arg == "--help" ? 0 : 1;
+      }
+    }
+  }
+  catch (const std::exception & ex) {
+    std::cerr << ex.what() << std::endl;
+    usage();
+    return 1;
+  }
+
+  std::vector<Result> results;
+  for (const Scenario & scenario : scenarios()) {
+    if (scenario.name.find(filter) == std::string::npos) {
+      continue;
+    }
+    if (list) {
+      std::cout << scenario.name << std::endl;
+      continue;
+    }
+    const Result & r = results.emplace_back(scenario.run(options));
+    std::cout << frmt::format("{:<44} {:>12.0f} msgs/s  p50 {:>7} ns  p99 {:>7} ns  p99.9 {:>8} ns  max {:>9} ns",
+      r.name, r.msgsPerSec, r.p50, r.p99, r.p999, r.max) << std::endl;
+  }
+
+  if (!results.empty()) {
+    if (!jsonOut.empty()) {
+      writeJson(jsonOut, results, options);
+    }
+    if (!csvOut.empty()) {
+      writeCsv(csvOut, results);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,217 @@
+#!/usr/bin/env python3
+"""Performance regression gate.
+
+Runs the benchmark suites (hash maps, ether, timers, rate limiters), compares the results with the
+checked-in baseline and exits non-zero with a readable diff when throughput drops or tail latency
+grows beyond the tolerance of a benchmark.
+
+The checked-in baseline lists the gated benchmarks and their tolerances. Numbers only compare on
+the host that recorded them, so a benchmark without numbers is reported as NO REF and does not fail
+the gate; record them on the reference host (isolated cores, the same --cores on every run) with
+--update, which keeps the list and the tolerance overrides.
+
+  perf_gate.py --build-dir build                            # check every suite against baseline.json
+  perf_gate.py --build-dir build --suite ether              # one suite
+  perf_gate.py --build-dir build --cores 2,3,4,5            # pin benchmark threads (setCpuAffinity)
+  perf_gate.py --build-dir build --cores 2,3,4,5 --update   # record the numbers of this host
+
+Baseline format:
+  "tolerance": default relative tolerance per metric
+  "benchmarks": { "<suite>:<benchmark>": { <metric>: value, ..., "tolerance": { <metric>: override } } }
+  A benchmark with no <metric> values has no reference numbers yet.
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import tempfile
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+DEFAULT_BASELINE = os.path.join(HERE, "baseline.json")
+
+HIGHER, LOWER = "higher", "lower"
+
+# Metric -> the direction that is better
+METRICS = {
+    "items_per_second": HIGHER,
+    "msgs_per_sec": HIGHER,
+    "p99_ns": LOWER,
+    "p999_ns": LOWER,
+}
+
+DEFAULT_TOLERANCE = {
+    "items_per_second": 0.10,
+    "msgs_per_sec": 0.15,
+    "p99_ns": 0.30,
+    "p999_ns": 0.50,
+}
+
+# Google Benchmark suites run in utility_bench, median of the repetitions
+UTILITY_SUITES = {
+    "hashmap": r"^(Find|Build)/[^/]+/16384/load:75(/hit:(0|100))?$",
+    "timer": r"^Timer/",
+    "ratelimit": r"^RateLimit/",
+}
+
+SUITES = list(UTILITY_SUITES) + ["ether"]
+
+
+def run(cmd, cwd):
+    print("$ " + " ".join(cmd), flush=True)
+    proc = subprocess.run(cmd, cwd=cwd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+    if proc.returncode != 0:
+        sys.stdout.write(proc.stdout)
+        raise SystemExit(f"perf_gate: '{cmd[0]}' failed with exit code {proc.returncode}")
+
+
+def run_utility(suite, args, workdir):
+    binary = os.path.join(args.build_dir, "src", "bench", "utility", "utility_bench")
+    out = os.path.join(workdir, f"{suite}.json")
+    cmd = [binary,
+           f"--benchmark_filter={UTILITY_SUITES[suite]}",
+           f"--benchmark_repetitions={args.repetitions}",
+           "--benchmark_report_aggregates_only=true",
+           f"--benchmark_out={out}",
+           "--benchmark_out_format=json"]
+    if args.cores:
+        cmd.append(f"--cpu={args.cores[0]}")
+    run(cmd, workdir)
+    with open(out) as f:
+        report = json.load(f)
+    results = {}
+    for bench in report["benchmarks"]:
+        if bench.get("aggregate_name", "median") != "median" or "error_occurred" in bench:
+            continue
+        results[f"{suite}:{bench['run_name']}"] = {"items_per_second": bench["items_per_second"]}
+    return results
+
+
+def run_ether(args, workdir):
+    binary = os.path.join(args.build_dir, "src", "bench", "ether", "ether_bench")
+    out = os.path.join(workdir, "ether.json")
+    cmd = [binary, f"--duration={args.ether_duration}", "--warmup=200", f"--json={out}"]
+    if args.cores:
+        cmd.append("--cores=" + ",".join(str(core) for core in args.cores))
+    run(cmd, workdir)
+    with open(out) as f:
+        report = json.load(f)
+    return {f"ether:{bench['name']}": {metric: bench[metric] for metric in ("msgs_per_sec", "p99_ns", "p999_ns")}
+            for bench in report["benchmarks"]}
+
+
+def tolerance(baseline, entry, metric):
+    return entry.get("tolerance", {}).get(metric, baseline.get("tolerance", {}).get(metric, DEFAULT_TOLERANCE[metric]))
+
+
+def compare(baseline, results, suites):
+    """Rows of (status, benchmark, metric, baseline, current, change, tolerance); status is one of
+    REGRESSED, MISSING, IMPROVED, NEW, NO REF or ok."""
+    rows = []
+    expected = {name: entry for name, entry in baseline.get("benchmarks", {}).items()
+                if name.split(":", 1)[0] in suites}
+    for name, entry in sorted(expected.items()):
+        current = results.get(name)
+        if current is None:
+            rows.append(("MISSING", name, "", None, None, None, None))
+            continue
+        if not any(metric in METRICS for metric in entry):
+            rows.append(("NO REF", name, "", None, None, None, None))
+            continue
+        for metric, base in sorted(entry.items()):
+            if metric not in METRICS or metric not in current:
+                continue
+            value = current[metric]
+            tol = tolerance(baseline, entry, metric)
+            change = (value - base) / base if base else 0.0
+            worse = -change if METRICS[metric] == HIGHER else change
+            status = "REGRESSED" if worse > tol else "IMPROVED" if -worse > tol else "ok"
+            rows.append((status, name, metric, base, value, change, tol))
+    for name in sorted(set(results) - set(expected)):
+        rows.append(("NEW", name, "", None, None, None, None))
+    return rows
+
+
+def fmt(value):
+    if value is None:
+        return "-"
+    if value >= 1e6:
+        return f"{value / 1e6:.2f}M"
+    if value >= 1e3:
+        return f"{value / 1e3:.1f}k"
+    return f"{value:.0f}"
+
+
+def report(rows, verbose):
+    order = {"REGRESSED": 0, "MISSING": 1, "IMPROVED": 2, "NEW": 3, "NO REF": 4, "ok": 5}
+    shown = [row for row in sorted(rows, key=lambda row: order[row[0]]) if verbose or row[0] != "ok"]
+    if shown:
+        width = max(len(row[1]) for row in shown)
+        print(f"\n{'status':<10} {'benchmark':<{width}} {'metric':<17} {'baseline':>10} {'current':>10} {'change':>8} {'limit':>7}")
+        for status, name, metric, base, value, change, tol in shown:
+            change_str = f"{change:+.1%}" if change is not None else "-"
+            tol_str = f"{tol:.0%}" if tol is not None else "-"
+            print(f"{status:<10} {name:<{width}} {metric:<17} {fmt(base):>10} {fmt(value):>10} {change_str:>8} {tol_str:>7}")
+    counts = {status: sum(1 for row in rows if row[0] == status) for status in order}
+    print("\n" + ", ".join(f"{count} {status.lower()}" for status, count in counts.items() if count))
+    if counts["NO REF"]:
+        print(f"perf_gate: {counts['NO REF']} benchmarks have no reference numbers; "
+              "record them on the reference host with --update")
+    return counts["REGRESSED"] + counts["MISSING"] == 0
+
+
+def update(baseline, results, suites, path):
+    benchmarks = {name: entry for name, entry in baseline.get("benchmarks", {}).items()
+                  if name.split(":", 1)[0] not in suites}
+    for name, metrics in results.items():
+        entry = dict(metrics)
+        if "tolerance" in baseline.get("benchmarks", {}).get(name, {}):
+            entry["tolerance"] = baseline["benchmarks"][name]["tolerance"]
+        benchmarks[name] = entry
+    baseline["tolerance"] = baseline.get("tolerance", DEFAULT_TOLERANCE)
+    baseline["benchmarks"] = dict(sorted(benchmarks.items()))
+    with open(path, "w") as f:
+        json.dump(baseline, f, indent=2)
+        f.write("\n")
+    print(f"baseline updated: {path} ({len(results)} benchmarks)")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--build-dir", default="build", help="CMake build directory (default: build)")
+    parser.add_argument("--baseline", default=DEFAULT_BASELINE, help="baseline file (default: next to this script)")
+    parser.add_argument("--suite", action="append", choices=SUITES, help="suite to run, repeatable (default: all)")
+    parser.add_argument("--cores", type=lambda s: [int(core) for core in s.split(",")], default=[],
+                        help="cores to pin to: utility_bench on the first, ether dispatchers round-robin")
+    parser.add_argument("--repetitions", type=int, default=5, help="Google Benchmark repetitions (default: 5)")
+    parser.add_argument("--ether-duration", type=int, default=1000, help="ether_bench window in ms (default: 1000)")
+    parser.add_argument("--results", help="keep the raw benchmark output in this directory")
+    parser.add_argument("--update", action="store_true", help="write the results as the new baseline")
+    parser.add_argument("--verbose", action="store_true", help="list benchmarks within tolerance too")
+    args = parser.parse_args()
+    args.build_dir = os.path.abspath(args.build_dir)
+    suites = args.suite or SUITES
+
+    baseline = {}
+    if os.path.exists(args.baseline):
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+    elif not args.update:
+        raise SystemExit(f"perf_gate: no baseline at {args.baseline}; run with --update first")
+
+    with tempfile.TemporaryDirectory() as tmp:
+        workdir = args.results or tmp
+        os.makedirs(workdir, exist_ok=True)
+        results = {}
+        for suite in suites:
+            results.update(run_ether(args, workdir) if suite == "ether" else run_utility(suite, args, workdir))
+
+    if args.update:
+        update(baseline, results, suites, args.baseline)
+        return 0
+    return 0 if report(compare(baseline, results, suites), args.verbose) else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
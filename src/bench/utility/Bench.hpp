@@ -0,0 +1,116 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace hw::bench {
+
+using Value = uint64_t;
+
+inline constexpr size_t PROBE_CNT = 1 << 14; // power of two, cycled through by the lookups
+inline constexpr int LOAD_PERCENT[] = {25, 50, 75, 90};
+inline constexpr int HIT_PERCENT[] = {0, 50, 100};
+
+inline uint64_t splitmix64(uint64_t x) noexcept {
+  x += 0x9e3779b97f4a7c15ull;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+  return x ^ (x >> 31);
+}
+
+// Distinct non-zero keys; the ones stored come first, misses are drawn from further on.
+inline uint64_t keyAt(size_t i) noexcept {
+  return splitmix64(i) | 1;
+}
+
+/**
+ * KeySet: keys stored in a map and a shuffled probe sequence with a given share of hits.
+ * Seeded, so every map sees the same keys and probes.
+ */
+struct KeySet {
+  std::vector<uint64_t> stored;
+  std::vector<uint64_t> probes;
+
+  KeySet(size_t count, int hitPercent) : stored(count), probes(PROBE_CNT) {
+    for (size_t i = 0; i < count; ++i) {
+      stored[i] = keyAt(i);
+    }
+    std::mt19937_64 rng(count * 131 + static_cast<size_t>(hitPercent));
+    for (size_t i = 0; i < PROBE_CNT; ++i) {
+      const bool hit = count && static_cast<int>(rng() % 100) < hitPercent;
+      probes[i] = hit ? stored[rng() % count] : keyAt(count + (1u << 30) + i);
+    }
+  }
+};
+
+/**
+ * Map adapters give every container the same face:
+ * - static constexpr size_t CAPACITY, the slot count (fixed-size maps) or reserved key count
+ * - bool insert(uint64_t key, Value* value) and Value* find(uint64_t key)
+ * Maps are heap-allocated: the fixed-size ones hold their arrays inline.
+ */
+template <typename Map>
+void findBenchmark(benchmark::State& state) {
+  const size_t count = Map::CAPACITY * static_cast<size_t>(state.range(0)) / 100;
+  const KeySet keys(count, static_cast<int>(state.range(1)));
+  auto map = std::make_unique<Map>();
+  Value value = 0;
+  for (uint64_t key : keys.stored) {
+    if (!map->insert(key, &value)) {
+      state.SkipWithError("insert failed");
+      return;
+    }
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map->find(keys.probes[i++ & (PROBE_CNT - 1)]));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+// Construction plus filling to the load factor; items are the inserted keys.
+template <typename Map>
+void buildBenchmark(benchmark::State& state) {
+  const size_t count = Map::CAPACITY * static_cast<size_t>(state.range(0)) / 100;
+  const KeySet keys(count, 0);
+  Value value = 0;
+  for (auto _ : state) {
+    auto map = std::make_unique<Map>();
+    for (uint64_t key : keys.stored) {
+      map->insert(key, &value);
+    }
+    benchmark::DoNotOptimize(map.get());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+
+// Find/<name>/<capacity>/load:<percent>/hit:<percent> and Build/<name>/<capacity>/load:<percent>
+template <typename Map>
+void registerMap(const std::string& name) {
+  const std::string suffix = name + "/" + std::to_string(Map::CAPACITY);
+  auto* find = benchmark::RegisterBenchmark(("Find/" + suffix).c_str(), findBenchmark<Map>)->ArgNames({"load", "hit"});
+  auto* build = benchmark::RegisterBenchmark(("Build/" + suffix).c_str(), buildBenchmark<Map>)->ArgNames({"load"});
+  for (int load : LOAD_PERCENT) {
+    for (int hit : HIT_PERCENT) {
+      find->Args({load, hit});
+    }
+    build->Args({load});
+  }
+}
+
+// The same map at the sizes benchmarked: L1/L2-resident, LLC-resident and memory-bound.
+template <template <size_t> class Map>
+void registerSizes(const std::string& name) {
+  registerMap<Map<(1 << 10)>>(name);
+  registerMap<Map<(1 << 14)>>(name);
+  registerMap<Map<(1 << 18)>>(name);
+}
+
+} // namespace hw::bench
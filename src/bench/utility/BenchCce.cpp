@@ -0,0 +1,33 @@
+#include "Bench.hpp"
+
+#include <hw/utility/cce/FastHashTable.hpp>
+#include <hw/utility/cce/HashTable.hpp>
+
+namespace {
+
+using namespace hw::bench;
+using namespace hw::utility::cce;
+
+template <size_t SIZE>
+struct FastMap {
+  static constexpr size_t CAPACITY = SIZE;
+  FastSIMDMap<Value, SIZE> map;
+  bool insert(uint64_t key, Value* value) { return map.insert(key, value); }
+  Value* find(uint64_t key) const { return map.find(key); }
+};
+
+template <size_t SIZE>
+struct SwissMap {
+  static constexpr size_t CAPACITY = SIZE;
+  SwissTableHashmap<Value, SIZE> map;
+  bool insert(uint64_t key, Value* value) { return map.insert(key, value); }
+  Value* find(uint64_t key) const { return map.find(key); }
+};
+
+const bool registered = [] {
+  registerSizes<FastMap>("cce::FastSIMDMap");
+  registerSizes<SwissMap>("cce::SwissTableHashmap");
+  return true;
+}();
+
+} // namespace
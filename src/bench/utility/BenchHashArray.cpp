@@ -0,0 +1,54 @@
+#include "Bench.hpp"
+
+#include <cstring>
+
+#include <hw/utility/HashVarray.hpp>
+#include <hw/utility/HashArray.hpp>
+
+namespace {
+
+using namespace hw::bench;
+using namespace hw::utility::swisstable;
+
+using KeyType = Key<sizeof(uint64_t)>;
+
+inline KeyType toKey(uint64_t key) noexcept {
+  KeyType result;
+  std::memcpy(result.raw(), &key, sizeof(key));
+  return result;
+}
+
+template <size_t SIZE, bool THREAD_SAFE>
+struct ArrayMap {
+  static constexpr size_t CAPACITY = SIZE;
+  HashArray<KeyType, Value, SIZE, THREAD_SAFE> map;
+  bool insert(uint64_t key, Value* value) { return map.insert(toKey(key), value) == InsertResult::Success; }
+  Value* find(uint64_t key) const { return map.find(toKey(key)); }
+};
+
+template <size_t SIZE, bool THREAD_SAFE>
+struct VarrayMap {
+  static constexpr size_t CAPACITY = SIZE;
+  HashVarray<KeyType, Value, THREAD_SAFE> map {SIZE};
+  bool insert(uint64_t key, Value* value) { return map.insert(toKey(key), value) == InsertResult::Success; }
+  Value* find(uint64_t key) const { return map.find(toKey(key)); }
+};
+
+template <size_t SIZE>
+using ArrayST = ArrayMap<SIZE, false>;
+template <size_t SIZE>
+using ArrayMT = ArrayMap<SIZE, true>;
+template <size_t SIZE>
+using VarrayST = VarrayMap<SIZE, false>;
+template <size_t SIZE>
+using VarrayMT = VarrayMap<SIZE, true>;
+
+const bool registered = [] {
+  registerSizes<ArrayST>("swisstable::HashArrayST");
+  registerSizes<ArrayMT>("swisstable::HashArrayMT");
+  registerSizes<VarrayST>("swisstable::HashVarrayST");
+  registerSizes<VarrayMT>("swisstable::HashVarrayMT");
+  return true;
+}();
+
+} // namespace
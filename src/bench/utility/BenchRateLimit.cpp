@@ -0,0 +1,40 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdint>
+
+#include <hw/utility/OrderBurstControl.hpp>
+#include <hw/utility/cce/OrderCounter.hpp>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+// Timestamps advance by range(0) nanoseconds per order: 1000 keeps the limiters saturated
+// (mostly rejecting), 100000 keeps them under the limit (mostly accepting).
+constexpr int64_t START_NS = 1'700'000'000'000'000'000;
+
+void orderBurstControl(benchmark::State& state) {
+  hw::utility::OrderBurstControl<1024> control(20ms, 1000, 10ms, 100);
+  const int64_t step = state.range(0);
+  int64_t now = START_NS;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(control.evaluate(now += step));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+void orderCounter(benchmark::State& state) {
+  hw::utility::cce::OrderCounter<20> counter(20ms, 1000);
+  const int64_t step = state.range(0);
+  int64_t now = START_NS;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(counter.increment(now += step));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK(orderBurstControl)->Name("RateLimit/OrderBurstControl")->ArgName("step_ns")->Arg(1000)->Arg(100000);
+BENCHMARK(orderCounter)->Name("RateLimit/cce::OrderCounter")->ArgName("step_ns")->Arg(1000)->Arg(100000);
+
+} // namespace
@@ -0,0 +1,40 @@
+#include "Bench.hpp"
+
+#include <unordered_map>
+
+#include <hw/utility/HashTableTrivial.hpp>
+
+namespace {
+
+using namespace hw::bench;
+
+template <size_t SIZE>
+struct TrivialMap {
+  static constexpr size_t CAPACITY = SIZE;
+  hw::utility::HashTableTrivial<uint64_t, Value*> map {SIZE};
+  bool insert(uint64_t key, Value* value) { return map.insert(key, value); }
+  Value* find(uint64_t key) const {
+    Value* const* found = map.find(key);
+    return found ? *found : nullptr;
+  }
+};
+
+template <size_t SIZE>
+struct StdMap {
+  static constexpr size_t CAPACITY = SIZE;
+  std::unordered_map<uint64_t, Value*> map;
+  StdMap() { map.reserve(SIZE); }
+  bool insert(uint64_t key, Value* value) { return map.emplace(key, value).second; }
+  Value* find(uint64_t key) const {
+    const auto it = map.find(key);
+    return it != map.end() ? it->second : nullptr;
+  }
+};
+
+const bool registered = [] {
+  registerSizes<TrivialMap>("HashTableTrivial");
+  registerSizes<StdMap>("std::unordered_map");
+  return true;
+}();
+
+} // namespace
@@ -0,0 +1,30 @@
+#include "Bench.hpp"
+
+#include <hw/utility/SwissTable.hpp>
+
+namespace {
+
+using namespace hw::bench;
+using namespace hw::utility::swisstable;
+
+template <size_t SIZE, ThreadSafetyPolicy ThreadSafety>
+struct SwissMap {
+  static constexpr size_t CAPACITY = SIZE;
+  Hashmap<Value, SIZE, ThreadSafety> map;
+  bool insert(uint64_t key, Value* value) { return map.insert(key, value); }
+  Value* find(uint64_t key) const { return map.find(key); }
+};
+
+template <size_t SIZE>
+using SwissST = SwissMap<SIZE, ThreadSafetyPolicy::Single>;
+
+template <size_t SIZE>
+using SwissMT = SwissMap<SIZE, ThreadSafetyPolicy::Multi>;
+
+const bool registered = [] {
+  registerSizes<SwissST>("swisstable::HashmapST");
+  registerSizes<SwissMT>("swisstable::HashmapMT");
+  return true;
+}();
+
+} // namespace
@@ -0,0 +1,49 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include <hw/assembly/Timer.hpp>
+
+namespace {
+
+using hw::assembly::TimerQueue;
+using hw::assembly::TimerType;
+
+constexpr size_t QUEUE_SIZE = 1 << 12;
+
+// Queue with `pending` timers far in the future, the state a dispatcher's queue sits in.
+std::unique_ptr<TimerQueue<QUEUE_SIZE>> makeQueue(int64_t pending) {
+  auto queue = std::make_unique<TimerQueue<QUEUE_SIZE>>();
+  for (int64_t i = 0; i < pending; ++i) {
+    queue->scheduleAfter(TimerType::ONE_TIME, std::chrono::hours(1) + std::chrono::microseconds(i), [] {});
+  }
+  return queue;
+}
+
+// Dispatcher loop without due timers: one clock read and a look at the heap top.
+void pollIdle(benchmark::State& state) {
+  auto queue = makeQueue(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(queue->poll());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+// One timer through its life: scheduled as due, fired and popped by the next poll.
+void scheduleAndFire(benchmark::State& state) {
+  auto queue = makeQueue(state.range(0));
+  uint64_t fired = 0;
+  for (auto _ : state) {
+    queue->scheduleAfter(TimerType::ONE_TIME, std::chrono::nanoseconds(0), [&fired] { ++fired; });
+    benchmark::DoNotOptimize(queue->poll());
+  }
+  benchmark::DoNotOptimize(fired);
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK(pollIdle)->Name("Timer/PollIdle")->ArgName("pending")->Arg(0)->Arg(1000);
+BENCHMARK(scheduleAndFire)->Name("Timer/ScheduleAndFire")->ArgName("pending")->Arg(0)->Arg(1000);
+
+} // namespace
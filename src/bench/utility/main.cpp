@@ -0,0 +1,45 @@
+#include <benchmark/benchmark.h>
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <hw/utility/CPU.hpp>
+#include <hw/utility/Text.hpp>
+
+// Google Benchmark's main, except that results also go to utility_bench.json unless
+// --benchmark_out is given, and --cpu=<core> pins the benchmark thread first.
+int main(int argc, char** argv) {
+  std::vector<char*> args;
+  bool out = false;
+  for (char* arg : std::vector<char*>(argv, argv + argc)) {
+    const std::string_view view(arg);
+    if (view.starts_with("--cpu=")) {
+      const int core = hw::utility::fromString<int>(std::string(view.substr(6)));
+      if (hw::utility::setCpuAffinity(core) != 0) {
+        std::cerr << "failed to set cpu-affinity to core " << core << ": " << std::strerror(errno) << std::endl;
+        return 1;
+      }
+      continue;
+    }
+    out = out || view.starts_with("--benchmark_out=");
+    args.push_back(arg);
+  }
+  char jsonOut[] = "--benchmark_out=utility_bench.json";
+  char jsonFormat[] = "--benchmark_out_format=json";
+  if (!out) {
+    args.push_back(jsonOut);
+    args.push_back(jsonFormat);
+  }
+  int count = static_cast<int>(args.size());
+  benchmark::Initialize(&count, args.data());
+  if (benchmark::ReportUnrecognizedArguments(count, args.data())) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -1,5 +1,6 @@
 #include <boost/test/unit_test.hpp>
 #include <hw/utility/Allocator.hpp>
+#include <vector>
 
 struct MockOrder {
     uint64_t id;
@@ -30,3 +31,68 @@ BOOST_AUTO_TEST_CASE(test_allocator_trivial_basic) {
     allocator.destroy(o2);
     allocator.free(o2);
 }
+
+BOOST_AUTO_TEST_CASE(test_allocator_trivial_cacheline_padding) {
+    using namespace hw::utility;
+    using Allocator = AllocatorTrivial<MockOrder, PoolBacking<BACKING_CACHELINE_PAD>>;
+    BOOST_CHECK_EQUAL(Allocator::blockSize(), ALIGNAS);
+    BOOST_CHECK_EQUAL(AllocatorTrivial<MockOrder>::blockSize(), sizeof(MockOrder));
+
+    Allocator allocator(4, 16);
+    MockOrder* o1 = allocator.allocate();
+    MockOrder* o2 = allocator.allocate();
+    BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(o1) % ALIGNAS, 0);
+    BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(o2) % ALIGNAS, 0);
+    allocator.free(o1);
+    allocator.free(o2);
+
+    // slab blocks are padded the same way
+    std::vector<MockOrder*> orders;
+    for (int i = 0; i < 8; ++i) {
+        orders.push_back(allocator.allocate());
+        BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(orders.back()) % ALIGNAS, 0);
+    }
+    BOOST_CHECK_EQUAL(allocator.stats().slabCnt, 1);
+    for (auto* o : orders) allocator.free(o);
+}
+
+BOOST_AUTO_TEST_CASE(test_allocator_trivial_huge_page_backing) {
+    using namespace hw::utility;
+    using Allocator = AllocatorTrivial<MockOrder, HugePageBacking>;
+    Allocator allocator(1000);
+
+    // pool is 2MB aligned whether hugetlbfs pages or THP back it
+    MockOrder* first = allocator.get(0);
+    BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(first) % HugePageBacking::HUGE_PAGE_SIZE, 0);
+
+    std::vector<MockOrder*> orders;
+    for (int i = 0; i < 1001; ++i) {
+        MockOrder* o = allocator.allocate();
+        allocator.construct(o, MockOrder{uint64_t(i), 1.0, 'B'});
+        orders.push_back(o);
+    }
+    // one slab filling a whole huge page
+    BOOST_CHECK_EQUAL(allocator.stats().slabCnt, 1);
+    BOOST_CHECK(allocator.stats().capacity > 1000 + HugePageBacking::HUGE_PAGE_SIZE / sizeof(MockOrder) / 2);
+    for (int i = 0; i < 1001; ++i) {
+        BOOST_CHECK_EQUAL(orders[i]->id, uint64_t(i));
+        allocator.free(orders[i]);
+    }
+    BOOST_CHECK_EQUAL(allocator.stats().inUse, 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_allocator_trivial_huge_page_large_block) {
+    using namespace hw::utility;
+    // a block that does not fit in the payload of one huge page
+    struct Large { std::byte data[HugePageBacking::HUGE_PAGE_SIZE]; };
+    AllocatorTrivial<Large, HugePageBacking> allocator(1);
+
+    Large* first = allocator.allocate();
+    Large* second = allocator.allocate();
+    BOOST_REQUIRE(second != nullptr);
+    second->data[sizeof(Large::data) - 1] = std::byte{1};
+    BOOST_CHECK_EQUAL(allocator.stats().slabCnt, 1);
+    BOOST_CHECK_EQUAL(allocator.stats().capacity, 2);
+    allocator.free(second);
+    allocator.free(first);
+}
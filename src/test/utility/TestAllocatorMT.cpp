@@ -0,0 +1,156 @@
+#include <boost/test/unit_test.hpp>
+#include <hw/utility/AllocatorMT.hpp>
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace hw::utility;
+
+namespace {
+struct PooledOrder {
+    uint64_t id;
+    double price;
+    char side;
+};
+}
+
+BOOST_AUTO_TEST_SUITE(AllocatorMTTests)
+
+BOOST_AUTO_TEST_CASE(test_allocator_mt_local_recycle) {
+    AllocatorMT<PooledOrder> allocator(100);
+    BOOST_CHECK_EQUAL(allocator.stats().fallbackCnt, 0);
+    BOOST_CHECK(allocator.stats().capacity >= 100);
+
+    PooledOrder* o1 = allocator.allocate();
+    allocator.construct(o1, PooledOrder{1, 100.5, 'B'});
+    BOOST_CHECK_EQUAL(o1->id, 1ULL);
+    allocator.destroy(o1);
+    allocator.free(o1);
+
+    PooledOrder* o2 = allocator.allocate();
+    BOOST_CHECK(o1 == o2);
+    allocator.free(o2);
+    BOOST_CHECK_EQUAL(allocator.stats().inUse, 0);
+    BOOST_CHECK_EQUAL(allocator.heapCount(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_allocator_mt_instances_same_thread) {
+    // two allocators of one type on one thread: frees stay local to each
+    AllocatorMT<PooledOrder> a;
+    AllocatorMT<PooledOrder> b;
+    PooledOrder* pa = a.allocate();
+    PooledOrder* pb = b.allocate();
+    a.free(pa);
+    BOOST_CHECK_EQUAL(a.pendingRemote(), 0);
+    BOOST_CHECK_EQUAL(a.stats().inUse, 0);
+    b.free(pb);
+    BOOST_CHECK_EQUAL(b.pendingRemote(), 0);
+    BOOST_CHECK_EQUAL(b.stats().inUse, 0);
+    BOOST_CHECK(a.allocate() == pa);
+}
+
+BOOST_AUTO_TEST_CASE(test_allocator_mt_remote_free) {
+    using Allocator = AllocatorMT<PooledOrder>;
+    Allocator allocator;
+    constexpr size_t COUNT = Allocator::BLOCKS_PER_SLAB;
+
+    std::vector<PooledOrder*> orders;
+    for (size_t i = 0; i < COUNT; ++i) {
+        orders.push_back(allocator.allocate());
+    }
+    BOOST_CHECK_EQUAL(allocator.stats().slabCnt, 1);
+
+    // release everything from another thread
+    std::thread consumer([&] {
+        for (auto* order : orders) {
+            allocator.free(order);
+        }
+    });
+    consumer.join();
+
+    BOOST_CHECK_EQUAL(allocator.pendingRemote(), COUNT);
+    BOOST_CHECK_EQUAL(allocator.stats().inUse, COUNT);
+    BOOST_CHECK_EQUAL(allocator.reclaim(), COUNT);
+    BOOST_CHECK_EQUAL(allocator.pendingRemote(), 0);
+    BOOST_CHECK_EQUAL(allocator.stats().inUse, 0);
+
+    // reclaimed blocks are reused; no new slab
+    std::set<PooledOrder*> original(orders.begin(), orders.end());
+    for (size_t i = 0; i < COUNT; ++i) {
+        BOOST_CHECK(original.count(allocator.allocate()) == 1);
+    }
+    BOOST_CHECK_EQUAL(allocator.stats().slabCnt, 1);
+    // releasing thread never allocated, so it has no heap of its own
+    BOOST_CHECK_EQUAL(allocator.heapCount(), 1);
+}
+
+// Producers allocate and hand objects to one consumer that releases them;
+// producers reclaim lazily when their local free list runs dry.
+BOOST_AUTO_TEST_CASE(test_allocator_mt_concurrent_handoff) {
+    using Allocator = AllocatorMT<PooledOrder>;
+    Allocator allocator;
+    constexpr size_t PRODUCERS = 4;
+    constexpr size_t ITERATIONS = 200'000;
+    constexpr size_t QUEUE_SIZE = 1024;
+
+    struct Queue {
+        std::atomic<PooledOrder*> slots[QUEUE_SIZE] {};
+        std::atomic<size_t> head {0};
+        std::atomic<size_t> tail {0};
+    };
+    std::vector<std::unique_ptr<Queue>> queues;
+    for (size_t i = 0; i < PRODUCERS; ++i) queues.emplace_back(std::make_unique<Queue>());
+
+    std::atomic<size_t> done {0};
+    std::atomic<bool> error {false};
+    std::vector<size_t> slabs(PRODUCERS);
+
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&, p] {
+            Queue& q = *queues[p];
+            for (size_t i = 0; i < ITERATIONS; ++i) {
+                PooledOrder* order = allocator.allocate();
+                allocator.construct(order, PooledOrder{p * ITERATIONS + i, 1.0, 'S'});
+                size_t tail = q.tail.load(std::memory_order_relaxed);
+                while (tail - q.head.load(std::memory_order_acquire) >= QUEUE_SIZE) {
+                    std::this_thread::yield();
+                }
+                q.slots[tail % QUEUE_SIZE].store(order, std::memory_order_relaxed);
+                q.tail.store(tail + 1, std::memory_order_release);
+            }
+            slabs[p] = allocator.stats().slabCnt;
+            ++done;
+        });
+    }
+
+    std::thread consumer([&] {
+        size_t received = 0;
+        while (received < PRODUCERS * ITERATIONS) {
+            for (auto& q : queues) {
+                size_t head = q->head.load(std::memory_order_relaxed);
+                if (head != q->tail.load(std::memory_order_acquire)) {
+                    PooledOrder* order = q->slots[head % QUEUE_SIZE].load(std::memory_order_relaxed);
+                    if (order->side != 'S') error = true;
+                    allocator.destroy(order);
+                    allocator.free(order);
+                    q->head.store(head + 1, std::memory_order_release);
+                    ++received;
+                }
+            }
+        }
+    });
+
+    for (auto& t : producers) t.join();
+    consumer.join();
+
+    BOOST_CHECK(!error);
+    // at most QUEUE_SIZE objects are in flight per producer, so memory stays bounded
+    const size_t maxSlabs = (QUEUE_SIZE + Allocator::BLOCKS_PER_SLAB - 1) / Allocator::BLOCKS_PER_SLAB + 2;
+    for (size_t p = 0; p < PRODUCERS; ++p) {
+        BOOST_CHECK_LE(slabs[p], maxSlabs);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,131 @@
+#include <boost/test/unit_test.hpp>
+#include <hw/utility/Allocator.hpp>
+#include <hw/utility/Arena.hpp>
+#include <cstdint>
+#include <set>
+#include <vector>
+
+using namespace hw::utility;
+
+namespace {
+struct ArenaOrder {
+    uint64_t id;
+    double price;
+    char side;
+};
+
+struct alignas(32) WideBlock {
+    uint64_t words[4];
+};
+}
+
+BOOST_AUTO_TEST_SUITE(ArenaTests)
+
+BOOST_AUTO_TEST_CASE(test_allocator_trivial_slab_fallback) {
+    AllocatorTrivial<ArenaOrder> allocator(4, 8);
+    std::vector<ArenaOrder*> orders;
+    for (int i = 0; i < 4; ++i) {
+        orders.push_back(allocator.allocate());
+    }
+    BOOST_CHECK_EQUAL(allocator.stats().fallbackCnt, 0);
+    BOOST_CHECK_EQUAL(allocator.stats().capacity, 4);
+
+    // 5th allocation adds one slab of 8 blocks; the next 7 come from the same slab
+    for (int i = 0; i < 8; ++i) {
+        orders.push_back(allocator.allocate());
+    }
+    BOOST_CHECK_EQUAL(allocator.stats().fallbackCnt, 1);
+    BOOST_CHECK_EQUAL(allocator.stats().slabCnt, 1);
+    BOOST_CHECK_EQUAL(allocator.stats().capacity, 12);
+    BOOST_CHECK_EQUAL(allocator.stats().inUse, 12);
+
+    std::set<ArenaOrder*> unique(orders.begin(), orders.end());
+    BOOST_CHECK_EQUAL(unique.size(), orders.size());
+
+    for (auto* order : orders) {
+        allocator.free(order);
+    }
+    BOOST_CHECK_EQUAL(allocator.stats().inUse, 0);
+    BOOST_CHECK_EQUAL(allocator.stats().highWater, 12);
+}
+
+BOOST_AUTO_TEST_CASE(test_slab_pool_alignment_and_growth) {
+    SlabPool pool(sizeof(WideBlock), 4, alignof(WideBlock));
+    BOOST_CHECK_EQUAL(pool.blockSize() % alignof(WideBlock), 0);
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 10; ++i) {
+        void* ptr = pool.allocate();
+        BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(ptr) % alignof(WideBlock), 0);
+        blocks.push_back(ptr);
+    }
+    BOOST_CHECK_EQUAL(pool.stats().fallbackCnt, 2);
+    BOOST_CHECK_EQUAL(pool.stats().capacity, 12);
+
+    pool.free(blocks.back());
+    BOOST_CHECK(pool.allocate() == blocks.back());
+    for (auto* ptr : blocks) {
+        pool.free(ptr);
+    }
+    BOOST_CHECK_EQUAL(pool.stats().inUse, 0);
+    BOOST_CHECK_THROW(SlabPool(16, 4, 24), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(test_size_class_allocator) {
+    using Allocator = SizeClassAllocator<16, 64, 256>;
+    static_assert(Allocator::classOf(1) == 0);
+    static_assert(Allocator::classOf(16) == 0);
+    static_assert(Allocator::classOf(17) == 1);
+    static_assert(Allocator::classOf(64) == 1);
+    static_assert(Allocator::classOf(200) == 2);
+    static_assert(Allocator::classOf(257) == Allocator::OVERSIZE);
+
+    Allocator allocator(8);
+    void* small = allocator.allocate(10);
+    void* medium = allocator.allocate(50);
+    void* large = allocator.allocate(1000);
+    BOOST_CHECK_EQUAL(allocator.stats(0).inUse, 1);
+    BOOST_CHECK_EQUAL(allocator.stats(1).inUse, 1);
+    BOOST_CHECK_EQUAL(allocator.oversizeCount(), 1);
+
+    allocator.free(small, 10);
+    allocator.free(medium, 50);
+    allocator.free(large, 1000);
+    BOOST_CHECK_EQUAL(allocator.stats(0).inUse, 0);
+    BOOST_CHECK_EQUAL(allocator.stats(1).inUse, 0);
+
+    ArenaOrder* order = allocator.allocate<ArenaOrder>();
+    allocator.construct(order, ArenaOrder{7, 1.5, 'B'});
+    BOOST_CHECK_EQUAL(order->id, 7ULL);
+    allocator.destroy(order);
+    allocator.free(order);
+    BOOST_CHECK_EQUAL(allocator.stats(Allocator::classOf(sizeof(ArenaOrder))).inUse, 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_bump_arena_reset) {
+    BumpArena arena(256);
+    char* first = static_cast<char*>(arena.allocate(10, 1));
+    uint64_t* second = arena.allocate<uint64_t>(4);
+    BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(second) % alignof(uint64_t), 0);
+    BOOST_CHECK_EQUAL(arena.stats().fallbackCnt, 0);
+
+    // spill into a second chunk, then an oversized dedicated chunk
+    arena.allocate(200, 8);
+    void* big = arena.allocate(4096);
+    BOOST_CHECK(big != nullptr);
+    BOOST_CHECK_EQUAL(arena.stats().fallbackCnt, 2);
+    const size_t used = arena.used();
+    BOOST_CHECK_EQUAL(used, 10 + 32 + 200 + 4096);
+
+    // reset rewinds to the first chunk and reuses existing chunks without growing
+    arena.reset();
+    BOOST_CHECK_EQUAL(arena.used(), 0);
+    BOOST_CHECK(static_cast<char*>(arena.allocate(10, 1)) == first);
+    arena.allocate(32, 8);
+    arena.allocate(200, 8);
+    arena.allocate(4096);
+    BOOST_CHECK_EQUAL(arena.stats().fallbackCnt, 2);
+    BOOST_CHECK_EQUAL(arena.stats().highWater, used);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,427 @@
+#include <boost/test/unit_test.hpp>
+#include <hw/type/beacon/Numeric.hpp>
+#include <hw/type/beacon/String.hpp>
+#include <hw/type/beacon/Opaque.hpp>
+#include <hw/type/beacon/Message.hpp>
+#include <hw/type/beacon/Columnar.hpp>
+#include <hw/type/beacon/Json.hpp>
+#include <array>
+#include <string>
+#include <vector>
+
+using namespace hw::type;
+using namespace hw::type::beacon;
+
+namespace {
+
+using NewOrder = NamedMessageType<"NewOrder", type_list<
+    NamedNumericType<"OrderId", Long>,
+    NamedNumericType<"Price", Price>,
+    NamedNumericType<"Qty", Int>,
+    NamedNumericType<"Side", Char>,
+    NamedFixedStringType<"Symbol", 8>,
+    NamedVariableStringType<"Account", 16>,
+    NamedOpaqueType<"Tag", 32>,
+    NamedVariableStringType<"Text", 4>
+>>;
+
+static_assert(NewOrder::FIELD_CNT == 8);
+static_assert(NewOrder::FIXED_CNT == 5);
+static_assert(NewOrder::OFFSET<"OrderId"> == 0);
+static_assert(NewOrder::OFFSET<"Price"> == 8);
+static_assert(NewOrder::OFFSET<"Qty"> == 16);
+static_assert(NewOrder::OFFSET<"Side"> == 20);
+static_assert(NewOrder::OFFSET<"Symbol"> == 21);
+static_assert(NewOrder::FIXED_SIZE == 29);
+static_assert(NewOrder::MAX_SIZE == 29 + 16 + 34 + 4);
+static_assert(NewOrder::IS_TAIL<"Account"> && !NewOrder::IS_TAIL<"Symbol">);
+static_assert(std::is_same_v<NewOrder::Field<"Qty">, NamedNumericType<"Qty", Int>>);
+static_assert(NewOrder::BITMAP_SIZE == 0);
+
+// Sparse amend: only the changed fields travel.
+using OrderAmend = NamedMessageType<"OrderAmend", type_list<
+    NamedNumericType<"OrderId", Long>,
+    Optional<NamedNumericType<"Price", Price>>,
+    Optional<NamedNumericType<"Qty", Int>>,
+    Optional<NamedNumericType<"Side", Char>, OptionalPolicy::SLOT>,
+    Optional<NamedNumericType<"Flags", Short>>,
+    Optional<NamedVariableStringType<"Text", 8>>,
+    Optional<NamedOpaqueType<"Tag", 16>>
+>>;
+
+static_assert(OrderAmend::OPTIONAL_CNT == 6);
+static_assert(OrderAmend::BITMAP_SIZE == 1);
+static_assert(OrderAmend::OFFSET<"OrderId"> == 1);
+static_assert(OrderAmend::OFFSET<"Side"> == 9);
+static_assert(OrderAmend::FIXED_SIZE == 10);
+static_assert(OrderAmend::MAX_SIZE == 10 + 8 + 4 + 2 + 8 + 18);
+
+using Trade = NamedMessageType<"Trade", type_list<
+    NamedNumericType<"TradeId", Long>,
+    NamedNumericType<"Side", Char>,
+    NamedNumericType<"Price", Price>,
+    NamedNumericType<"Qty", Int>,
+    NamedNumericType<"Venue", Short>,
+    NamedNumericType<"Yield", Double>
+>>;
+
+// Free text that is usually short: costs 2 + length bytes instead of its capacity.
+using Reject = NamedMessageType<"Reject", type_list<
+    NamedNumericType<"OrderId", Long>,
+    NamedPrefixedStringType<"Reason", 200>,
+    Optional<NamedPrefixedStringType<"Detail", 40>>
+>>;
+
+static_assert(Reject::IS_TAIL<"Reason">);
+static_assert(Reject::MAX_SIZE == 1 + 8 + 202 + 42);
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(BeaconMessageTests)
+
+BOOST_AUTO_TEST_CASE(test_fixed_fields) {
+    std::array<std::byte, NewOrder::MAX_SIZE + 1> buffer {};
+    std::byte * msg = buffer.data() + 1; // deliberately unaligned
+    NewOrder::set<"OrderId">(msg, 1234567890123LL);
+    NewOrder::set<"Price">(msg, 1005000);
+    NewOrder::set<"Qty">(msg, 300);
+    NewOrder::set<"Side">(msg, 'B');
+    NewOrder::set<"Symbol">(msg, std::string_view("MSFT"));
+
+    BOOST_CHECK_EQUAL(NewOrder::get<"OrderId">(msg), 1234567890123LL);
+    BOOST_CHECK_EQUAL(NewOrder::get<"Price">(msg), 1005000);
+    BOOST_CHECK_EQUAL(NewOrder::get<"Qty">(msg), 300);
+    BOOST_CHECK_EQUAL(NewOrder::get<"Side">(msg), 'B');
+    BOOST_CHECK_EQUAL(NewOrder::get<"Symbol">(msg), "MSFT    ");
+}
+
+BOOST_AUTO_TEST_CASE(test_tail_fields) {
+    std::array<std::byte, NewOrder::MAX_SIZE> msg {};
+    NewOrder::set<"Qty">(msg.data(), 7);
+
+    NewOrder::Writer writer(msg.data());
+    writer.set<"Account">("ACC-1");
+    auto tag = writer.opaque<"Tag">();
+    tag.append(uint32_t{0xdeadbeef});
+    tag.append(uint16_t{0x0102});
+    writer.set<"Text">("abcdef"); // truncated to the field's capacity, no terminator
+    const size_t size = writer.size();
+    BOOST_CHECK_EQUAL(size, NewOrder::FIXED_SIZE + 6 + 8 + 4);
+    BOOST_CHECK_EQUAL(NewOrder::size(msg.data()), size);
+
+    BOOST_CHECK_EQUAL(NewOrder::get<"Account">(msg.data()), "ACC-1");
+    BOOST_CHECK_EQUAL(NewOrder::get<"Text">(msg.data()), "abcd");
+
+    NewOrder::Reader reader(msg.data());
+    BOOST_CHECK_EQUAL(reader.get<"Qty">(), 7);
+    BOOST_CHECK_EQUAL(reader.get<"Account">(), "ACC-1");
+    BOOST_CHECK_EQUAL(reader.get<"Tag">().toString(), "efbeadde0201");
+    BOOST_CHECK_EQUAL(reader.get<"Text">(), "abcd");
+    BOOST_CHECK_THROW(reader.get<"Account">(), std::logic_error);
+
+    size_t visited = 0;
+    NewOrder::forEach(msg.data(), [&] (auto field, const std::byte * ptr) {
+        using FieldType = typename decltype(field)::type;
+        if constexpr (std::is_same_v<QueryTrait<FieldType>, trait::VarString>) {
+            BOOST_CHECK(FieldType::get(ptr) == "ACC-1" || FieldType::get(ptr) == "abcd");
+        }
+        ++visited;
+    });
+    BOOST_CHECK_EQUAL(visited, NewOrder::FIELD_CNT);
+}
+
+BOOST_AUTO_TEST_CASE(test_skipped_tail_fields) {
+    std::array<std::byte, NewOrder::MAX_SIZE> msg;
+    msg.fill(std::byte{0x55});
+
+    NewOrder::Writer writer(msg.data());
+    writer.set<"Text">("xy"); // Account and Tag are written empty
+    BOOST_CHECK_EQUAL(writer.size(), NewOrder::FIXED_SIZE + 1 + 2 + 3);
+    BOOST_CHECK_EQUAL(NewOrder::get<"Account">(msg.data()), "");
+    BOOST_CHECK_EQUAL(NewOrder::get<"Tag">(msg.data()).payloadSize(), 0u);
+    BOOST_CHECK_EQUAL(NewOrder::get<"Text">(msg.data()), "xy");
+
+    NewOrder::Writer empty(msg.data());
+    BOOST_CHECK_EQUAL(empty.size(), NewOrder::FIXED_SIZE + 1 + 2 + 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_optional_fields) {
+    std::array<std::byte, OrderAmend::MAX_SIZE> msg;
+    msg.fill(std::byte{0xff});
+    OrderAmend::Writer writer(msg.data());
+    OrderAmend::set<"OrderId">(msg.data(), 42);
+    writer.set<"Qty">(300);
+    OrderAmend::set<"Side">(msg.data(), 'B');
+    writer.set<"Text">("hi");
+    BOOST_CHECK(OrderAmend::has<"Side">(msg.data())); // not lost by later writer fields
+    OrderAmend::clear<"Side">(msg.data());
+    BOOST_CHECK_EQUAL(writer.size(), OrderAmend::FIXED_SIZE + 4 + 3);
+    BOOST_CHECK_EQUAL(OrderAmend::size(msg.data()), OrderAmend::FIXED_SIZE + 4 + 3);
+
+    BOOST_CHECK_EQUAL(OrderAmend::get<"OrderId">(msg.data()), 42);
+    BOOST_CHECK(!OrderAmend::has<"Price">(msg.data()));
+    BOOST_CHECK(!OrderAmend::get<"Price">(msg.data()));
+    BOOST_CHECK_EQUAL(*OrderAmend::get<"Qty">(msg.data()), 300);
+    BOOST_CHECK(!OrderAmend::get<"Side">(msg.data()));
+    BOOST_CHECK(!OrderAmend::get<"Flags">(msg.data()));
+    BOOST_CHECK_EQUAL(*OrderAmend::get<"Text">(msg.data()), "hi");
+    BOOST_CHECK(!OrderAmend::get<"Tag">(msg.data()));
+
+    // slotted optional fields are set and cleared in place without moving anything
+    OrderAmend::set<"Side">(msg.data(), 'S');
+    BOOST_CHECK_EQUAL(*OrderAmend::get<"Side">(msg.data()), 'S');
+    BOOST_CHECK_EQUAL(OrderAmend::size(msg.data()), OrderAmend::FIXED_SIZE + 4 + 3);
+    OrderAmend::clear<"Side">(msg.data());
+    BOOST_CHECK(!OrderAmend::has<"Side">(msg.data()));
+
+    size_t present = 0;
+    OrderAmend::forEach(msg.data(), [&] (auto, const std::byte * ptr) { present += ptr != nullptr; });
+    BOOST_CHECK_EQUAL(present, 3u);
+}
+
+BOOST_AUTO_TEST_CASE(test_optional_fields_all_present) {
+    std::array<std::byte, OrderAmend::MAX_SIZE> msg {};
+    OrderAmend::Writer writer(msg.data());
+    writer.set<"Price">(1005000);
+    writer.set<"Qty">(7);
+    writer.set<"Flags">(Short{0x0102});
+    writer.set<"Text">("amend");
+    writer.opaque<"Tag">().append(uint32_t{0x01020304});
+    BOOST_CHECK_EQUAL(writer.size(), OrderAmend::FIXED_SIZE + 8 + 4 + 2 + 6 + 6);
+
+    // packed fields are located from the bitmap: Price, Qty, Flags in declaration order
+    OrderAmend::Reader reader(msg.data());
+    BOOST_CHECK_EQUAL(*reader.get<"Flags">(), 0x0102);
+    BOOST_CHECK_EQUAL(*reader.get<"Price">(), 1005000);
+    BOOST_CHECK_EQUAL(*reader.get<"Qty">(), 7);
+    BOOST_CHECK_EQUAL(*reader.get<"Text">(), "amend");
+    BOOST_CHECK_EQUAL(reader.get<"Tag">()->toString(), "04030201");
+
+    Int qty;
+    std::memcpy(&qty, msg.data() + OrderAmend::FIXED_SIZE + 8, sizeof(qty));
+    BOOST_CHECK_EQUAL(qty, 7);
+
+    // rewriting the message drops the packed fields that are not written again
+    OrderAmend::Writer rewrite(msg.data());
+    rewrite.set<"Flags">(Short{3});
+    BOOST_CHECK_EQUAL(rewrite.size(), OrderAmend::FIXED_SIZE + 2);
+    BOOST_CHECK(!OrderAmend::has<"Price">(msg.data()));
+    BOOST_CHECK_EQUAL(*OrderAmend::get<"Flags">(msg.data()), 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_column_batch) {
+    constexpr size_t COUNT = 1003; // not a multiple of the SIMD width or the block
+    constexpr size_t STRIDE = Trade::FIXED_SIZE + 3;
+    std::vector<std::byte> replay(COUNT * STRIDE);
+    std::vector<const std::byte *> msgs;
+    for (size_t i = 0; i < COUNT; ++i) {
+        std::byte * msg = replay.data() + i * STRIDE;
+        Trade::set<"TradeId">(msg, 1'000'000'000'000LL + i);
+        Trade::set<"Side">(msg, i % 2 ? 'B' : 'S');
+        Trade::set<"Price">(msg, 1'000'000 - static_cast<Price>(i) * 25);
+        Trade::set<"Qty">(msg, static_cast<Int>(i * 3));
+        Trade::set<"Venue">(msg, static_cast<Short>(i % 7));
+        Trade::set<"Yield">(msg, 0.5 * static_cast<double>(i));
+        msgs.push_back(msg);
+    }
+
+    ColumnBatch<Trade, "TradeId", "Price", "Qty", "Venue", "Yield"> batch;
+    batch.decode(replay.data(), STRIDE, COUNT);
+    batch.decode(msgs.data(), COUNT);
+    BOOST_REQUIRE_EQUAL(batch.size(), 2 * COUNT);
+    for (size_t row = 0; row < 2 * COUNT; ++row) {
+        const std::byte * msg = msgs[row % COUNT];
+        BOOST_REQUIRE_EQUAL(batch.column<"TradeId">()[row], Trade::get<"TradeId">(msg));
+        BOOST_REQUIRE_EQUAL(batch.column<"Price">()[row], Trade::get<"Price">(msg));
+        BOOST_REQUIRE_EQUAL(batch.column<"Qty">()[row], Trade::get<"Qty">(msg));
+        BOOST_REQUIRE_EQUAL(batch.column<"Venue">()[row], Trade::get<"Venue">(msg));
+        BOOST_REQUIRE_EQUAL(batch.column<"Yield">()[row], Trade::get<"Yield">(msg));
+    }
+
+    std::vector<Char> sides(COUNT);
+    decodeColumn<Trade, "Side">(msgs.data(), COUNT, sides.data());
+    BOOST_CHECK_EQUAL(sides[0], 'S');
+    BOOST_CHECK_EQUAL(sides[COUNT - 1], 'S');
+    BOOST_CHECK_EQUAL(sides[COUNT - 2], 'B');
+
+    batch.clear();
+    BOOST_CHECK_EQUAL(batch.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(test_column_gather_paths) {
+    // the AVX2 gathers are picked at run time; check them against the memcpy path directly
+    static_assert(!hw::type::beacon::detail::uniqueNames<"Price", "Qty", "Price">());
+    constexpr size_t COUNT = 37;
+    constexpr size_t STRIDE = 13;
+    std::vector<std::byte> buf(COUNT * STRIDE);
+    std::vector<const std::byte *> msgs;
+    for (size_t i = 0; i < buf.size(); ++i) {
+        buf[i] = static_cast<std::byte>(i * 7 + 1);
+    }
+    for (size_t i = 0; i < COUNT; ++i) {
+        msgs.push_back(buf.data() + (COUNT - 1 - i) * STRIDE);
+    }
+    auto check = [&] <size_t SIZE> (std::integral_constant<size_t, SIZE>) {
+        std::vector<std::byte> scalar(COUNT * SIZE), simd(COUNT * SIZE);
+        hw::type::beacon::detail::gatherStrided<SIZE>(buf.data() + 1, STRIDE, COUNT, scalar.data(), false);
+        hw::type::beacon::detail::gatherStrided<SIZE>(buf.data() + 1, STRIDE, COUNT, simd.data(), hw::type::beacon::detail::hasAvx2());
+        BOOST_CHECK(scalar == simd);
+        BOOST_CHECK(std::memcmp(scalar.data() + SIZE, buf.data() + 1 + STRIDE, SIZE) == 0);
+        hw::type::beacon::detail::gatherIndirect<SIZE>(msgs.data(), 2, COUNT, scalar.data(), false);
+        hw::type::beacon::detail::gatherIndirect<SIZE>(msgs.data(), 2, COUNT, simd.data(), hw::type::beacon::detail::hasAvx2());
+        BOOST_CHECK(scalar == simd);
+        BOOST_CHECK(std::memcmp(scalar.data(), msgs[0] + 2, SIZE) == 0);
+    };
+    check(std::integral_constant<size_t, 4>{});
+    check(std::integral_constant<size_t, 8>{});
+    check(std::integral_constant<size_t, 2>{});
+#if defined(__x86_64__)
+    BOOST_CHECK_EQUAL(hw::type::beacon::detail::hasAvx2(), __builtin_cpu_supports("avx2") != 0);
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(test_field_text_round_trip) {
+    std::array<std::byte, 64> buf {};
+    auto roundTrip = [&] <typename FieldType> (FieldType, std::string_view text) {
+        FieldType::set(buf.data(), text);
+        char out[FieldType::MAX_CHARS];
+        const auto result = FieldType::toChars(buf.data(), out, out + sizeof(out));
+        BOOST_CHECK(result.ec == std::errc{});
+        BOOST_CHECK_EQUAL(std::string_view(out, result.ptr), text);
+        BOOST_CHECK_EQUAL(FieldType::toString(buf.data()), text);
+    };
+    roundTrip(NamedNumericType<"Side", Char>{}, "B");
+    roundTrip(NamedNumericType<"Side", Char>{}, "7");
+    roundTrip(NamedNumericType<"Side", Char>{}, "0x2d");
+    roundTrip(NamedNumericType<"Flag", UByte>{}, "0xff");
+    roundTrip(NamedNumericType<"Qty", Int>{}, "-2147483648");
+    roundTrip(NamedNumericType<"Price", Price>{}, "9223372036854775807");
+    roundTrip(NamedNumericType<"Yield", Double>{}, "0.1");
+    roundTrip(NamedNumericType<"Big", LLong>{}, "0");
+    roundTrip(NamedNumericType<"Big", LLong>{}, "-170141183460469231731687303715884105728");
+    roundTrip(NamedNumericType<"Big", LLong>{}, "100000000000000000000000000000000000007");
+
+    using Qty = NamedNumericType<"Qty", Int>;
+    Qty::set(buf.data(), std::string_view("0x10"));
+    BOOST_CHECK_EQUAL(Qty::get(buf.data()), 16);
+    BOOST_CHECK_THROW(Qty::set(buf.data(), std::string_view("1 0")), std::invalid_argument);
+
+    Qty::set(buf.data(), 12345);
+    char small[3];
+    BOOST_CHECK(Qty::toChars(buf.data(), small, small + sizeof(small)).ec == std::errc::value_too_large);
+
+    Opaque<32> tag(buf.data());
+    tag.fromString("0xDEADbeef0011223344556677");
+    BOOST_CHECK_EQUAL(tag.payloadSize(), 12u);
+    BOOST_CHECK_EQUAL(tag.toString(), "deadbeef0011223344556677");
+    tag.fromString("  de ad be ef  ");
+    BOOST_CHECK_EQUAL(tag.toString(), "deadbeef");
+    tag.fromString("0102030");
+    BOOST_CHECK_EQUAL(tag.toString(), "010203");
+    BOOST_CHECK_THROW(tag.fromString("01 2 03"), std::invalid_argument);
+    BOOST_CHECK_THROW(tag.fromString("01zz"), std::invalid_argument);
+
+    Opaque<4> shortTag(buf.data());
+    shortTag.fromString("00112233445566");
+    BOOST_CHECK_EQUAL(shortTag.toString(), "00112233");
+}
+
+BOOST_AUTO_TEST_CASE(test_json_codec) {
+    std::array<std::byte, NewOrder::MAX_SIZE> msg {};
+    NewOrder::set<"OrderId">(msg.data(), 42);
+    NewOrder::set<"Price">(msg.data(), -1005000);
+    NewOrder::set<"Qty">(msg.data(), 300);
+    NewOrder::set<"Side">(msg.data(), 'B');
+    NewOrder::set<"Symbol">(msg.data(), "IBM");
+    NewOrder::Writer writer(msg.data());
+    writer.set<"Account">("a\"b\\c\n");
+    writer.opaque<"Tag">().append(uint16_t{0xbeef});
+    const size_t size = writer.size();
+
+    char json[256];
+    char* end = JsonCodec<NewOrder>::encode(msg.data(), json, json + sizeof(json));
+    BOOST_REQUIRE(end);
+    const std::string_view text(json, static_cast<size_t>(end - json));
+    BOOST_CHECK_EQUAL(text, R"({"OrderId":42,"Price":-1005000,"Qty":300,"Side":"B","Symbol":"IBM     ",)"
+                            R"("Account":"a\"b\\c\n","Tag":"efbe","Text":""})");
+    BOOST_CHECK(!JsonCodec<NewOrder>::encode(msg.data(), json, json + text.size() - 1));
+
+    std::array<std::byte, NewOrder::MAX_SIZE> copy;
+    copy.fill(std::byte{0xff});
+    BOOST_CHECK_EQUAL(JsonCodec<NewOrder>::decode(text, copy.data()), size);
+    BOOST_CHECK(std::memcmp(copy.data(), msg.data(), size) == 0);
+
+    // any member order, whitespace, unknown members and unicode escapes
+    std::array<std::byte, OrderAmend::MAX_SIZE> amend;
+    const size_t amendSize = JsonCodec<OrderAmend>::decode(R"( { "Text" : "\u00e9t\u00e9", "Extra": {"a":[1,"}"]},
+      "Qty": 7, "OrderId": 9, "Price": null, "Side": "S" } )", amend.data());
+    BOOST_CHECK_EQUAL(amendSize, OrderAmend::FIXED_SIZE + 4 + 6);
+    BOOST_CHECK_EQUAL(OrderAmend::get<"OrderId">(amend.data()), 9);
+    BOOST_CHECK(!OrderAmend::has<"Price">(amend.data()));
+    BOOST_CHECK_EQUAL(*OrderAmend::get<"Qty">(amend.data()), 7);
+    BOOST_CHECK_EQUAL(*OrderAmend::get<"Side">(amend.data()), 'S');
+    BOOST_CHECK_EQUAL(*OrderAmend::get<"Text">(amend.data()), "\xc3\xa9t\xc3\xa9");
+
+    end = JsonCodec<OrderAmend>::encode(amend.data(), json, json + sizeof(json));
+    BOOST_REQUIRE(end);
+    BOOST_CHECK_EQUAL(std::string_view(json, static_cast<size_t>(end - json)),
+                      "{\"OrderId\":9,\"Qty\":7,\"Side\":\"S\",\"Text\":\"\xc3\xa9t\xc3\xa9\"}");
+
+    BOOST_CHECK_THROW(JsonCodec<OrderAmend>::decode(R"({"Qty": 7)", amend.data()), std::invalid_argument);
+    BOOST_CHECK_THROW(JsonCodec<OrderAmend>::decode(R"({"Qty": [7]})", amend.data()), std::invalid_argument);
+    BOOST_CHECK_THROW(JsonCodec<OrderAmend>::decode(R"({"Qty": "x"})", amend.data()), std::invalid_argument);
+    BOOST_CHECK_THROW(JsonCodec<OrderAmend>::decode(R"({"Qty": 7} x)", amend.data()), std::invalid_argument);
+    BOOST_CHECK_THROW(JsonCodec<OrderAmend>::decode(R"({}{"Qty": 7})", amend.data()), std::invalid_argument);
+    BOOST_CHECK_EQUAL(JsonCodec<OrderAmend>::decode("{}\r\n", amend.data()), OrderAmend::FIXED_SIZE);
+
+    static_assert(OrderAmend::FIELD_NAMES.find("Flags") == 4);
+    static_assert(OrderAmend::FIELD_NAMES.find("flags") == OrderAmend::FIELD_CNT);
+}
+
+BOOST_AUTO_TEST_CASE(test_prefixed_strings) {
+    std::array<std::byte, Reject::MAX_SIZE> msg {};
+    Reject::Writer writer(msg.data());
+    Reject::set<"OrderId">(msg.data(), 5);
+    writer.set<"Reason">("price");
+    BOOST_CHECK_EQUAL(writer.size(), Reject::FIXED_SIZE + 2 + 5);
+    BOOST_CHECK_EQUAL(Reject::get<"Reason">(msg.data()), "price");
+    BOOST_CHECK(!Reject::get<"Detail">(msg.data()));
+
+    Reject::Writer full(msg.data());
+    full.set<"Reason">("price");
+    full.set<"Detail">(std::string(50, 'x'));
+    const size_t size = full.size();
+    BOOST_CHECK_EQUAL(size, Reject::FIXED_SIZE + 2 + 5 + 2 + 40);
+    BOOST_CHECK_EQUAL(Reject::get<"Detail">(msg.data())->size(), 40u);
+
+    char json[512];
+    char* end = JsonCodec<Reject>::encode(msg.data(), json, json + sizeof(json));
+    BOOST_REQUIRE(end);
+    std::array<std::byte, Reject::MAX_SIZE> copy;
+    copy.fill(std::byte{0xff});
+    BOOST_CHECK_EQUAL(JsonCodec<Reject>::decode(std::string_view(json, static_cast<size_t>(end - json)), copy.data()), size);
+    BOOST_CHECK(std::memcmp(copy.data(), msg.data(), size) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_string_scans) {
+    // lengths around the 16-byte blocks; the byte after the field is never a terminator
+    for (size_t cap = 0; cap <= 40; ++cap) {
+        std::string buf(cap + 1, 'a');
+        BOOST_CHECK_EQUAL(beacon::detail::simd_strnlen(buf.data(), cap), cap);
+        for (size_t len = 0; len < cap; ++len) {
+            std::string text = buf;
+            text[len] = '\0';
+            BOOST_CHECK_EQUAL(beacon::detail::simd_strnlen(text.data(), cap), len);
+            std::string padded(cap, ' ');
+            padded.replace(0, len, len, 'b');
+            BOOST_CHECK_EQUAL(beacon::detail::simd_trimmed_length(padded.data(), cap, ' '), len);
+        }
+    }
+
+    std::array<std::byte, NewOrder::MAX_SIZE> msg {};
+    NewOrder::set<"Symbol">(msg.data(), "IBM");
+    using Symbol = NewOrder::Field<"Symbol">;
+    BOOST_CHECK_EQUAL(Symbol::trimmed(msg.data() + NewOrder::OFFSET<"Symbol">), "IBM");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
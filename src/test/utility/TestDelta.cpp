@@ -0,0 +1,184 @@
+#include <boost/test/unit_test.hpp>
+#include <hw/type/beacon/Numeric.hpp>
+#include <hw/type/beacon/String.hpp>
+#include <hw/type/beacon/Opaque.hpp>
+#include <hw/type/beacon/Message.hpp>
+#include <hw/type/beacon/Delta.hpp>
+#include <array>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace hw::type;
+using namespace hw::type::beacon;
+
+namespace {
+
+using Quote = NamedMessageType<"Quote", type_list<
+    NamedFixedStringType<"Symbol", 8>,
+    NamedNumericType<"Seq", Long>,
+    NamedNumericType<"Bid", Double>,
+    NamedNumericType<"BidQty", Int>,
+    Optional<NamedNumericType<"Side", Char>, OptionalPolicy::SLOT>,
+    Optional<NamedNumericType<"Ask", Price>>,
+    NamedVariableStringType<"Venue", 8>,
+    Optional<NamedPrefixedStringType<"Note", 32>>,
+    Optional<NamedOpaqueType<"Tag", 8>>
+>>;
+
+using Codec = DeltaCodec<Quote, "Symbol">;
+
+struct Journal {
+    std::vector<std::byte> records;
+    std::vector<std::vector<std::byte>> msgs;
+    Codec::Encoder encoder;
+
+    void add(const std::byte* msg, size_t size) {
+        const size_t at = records.size();
+        records.resize(at + Codec::MAX_RECORD_SIZE);
+        std::byte* end = encoder.encode(msg, records.data() + at);
+        records.resize(static_cast<size_t>(end - records.data()));
+        msgs.emplace_back(msg, msg + size);
+    }
+};
+
+size_t makeQuote(std::byte* msg, int i) {
+    static const char* symbols[] = {"IBM", "MSFT", "AAPL"};
+    static const char* venues[] = {"XNYS", "ARCX"};
+    std::memset(msg, 0, Quote::MAX_SIZE);
+    Quote::Writer writer(msg);
+    Quote::set<"Symbol">(msg, symbols[i % 3]);
+    Quote::set<"Seq">(msg, 1000 + i);
+    Quote::set<"Bid">(msg, 100.25 + (i / 3) * 0.01);
+    Quote::set<"BidQty">(msg, 100 * (i % 4));
+    if (i % 5) {
+        Quote::set<"Side">(msg, i % 2 ? 'B' : 'S');
+    }
+    if (i % 4 == 1) {
+        writer.set<"Ask">(1005000 - i);
+    }
+    writer.set<"Venue">(venues[(i / 7) % 2]);
+    if (i % 6 == 0) {
+        writer.set<"Note">("note " + std::to_string(i % 12));
+    }
+    if (i % 9 == 0) {
+        writer.opaque<"Tag">().append(static_cast<uint32_t>(i));
+    }
+    return writer.size();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(DeltaTests)
+
+BOOST_AUTO_TEST_CASE(test_delta_round_trip) {
+    Journal journal;
+    size_t wire = 0;
+    std::array<std::byte, Quote::MAX_SIZE> msg;
+    for (int i = 0; i < 300; ++i) {
+        const size_t size = makeQuote(msg.data(), i);
+        journal.add(msg.data(), size);
+        wire += size;
+    }
+    BOOST_CHECK_LT(journal.records.size() * 2, wire);
+
+    Codec::Decoder decoder;
+    const std::byte* ptr = journal.records.data();
+    const std::byte* end = ptr + journal.records.size();
+    for (const auto& expected : journal.msgs) {
+        std::array<std::byte, Quote::MAX_SIZE> decoded;
+        decoded.fill(std::byte{0xff});
+        BOOST_REQUIRE_EQUAL(decoder.decode(ptr, end, decoded.data()), expected.size());
+        BOOST_REQUIRE(std::memcmp(decoded.data(), expected.data(), expected.size()) == 0);
+    }
+    BOOST_CHECK(ptr == end);
+}
+
+BOOST_AUTO_TEST_CASE(test_delta_repeats) {
+    std::array<std::byte, Quote::MAX_SIZE> msg;
+    const size_t size = makeQuote(msg.data(), 6);
+    Journal journal;
+    journal.add(msg.data(), size);
+    const size_t first = journal.records.size();
+    journal.add(msg.data(), size);
+    BOOST_CHECK_EQUAL(journal.records.size() - first, 2u); // slot and an empty change mask
+
+    // one changed numeric: slot, change mask and a 1-byte delta
+    Quote::set<"Seq">(msg.data(), Quote::get<"Seq">(msg.data()) + 1);
+    journal.add(msg.data(), size);
+    BOOST_CHECK_EQUAL(journal.records.size() - first, 2u + 3u);
+
+    // a new key comes with its bytes, after which it is a slot number like the others
+    journal.encoder.reset();
+    journal.records.clear();
+    journal.add(msg.data(), size);
+    BOOST_CHECK_GT(journal.records.size(), Codec::KEY_SIZE);
+    BOOST_CHECK(journal.records[0] == std::byte{0});
+}
+
+BOOST_AUTO_TEST_CASE(test_delta_zero_wide_numeric) {
+    // absent -> present with value 0 is a change whose XOR diff is all zero bytes
+    using Wide = NamedMessageType<"Wide", type_list<
+            NamedFixedStringType<"Symbol", 8>,
+            Optional<NamedNumericType<"Big", LLong>>,
+            Optional<NamedNumericType<"Yield", Double>>
+    >>;
+    using WideCodec = DeltaCodec<Wide, "Symbol">;
+    std::vector<std::vector<std::byte>> msgs;
+    auto add = [&] (std::optional<LLong> big, std::optional<Double> yield) {
+        std::vector<std::byte> msg(Wide::MAX_SIZE);
+        Wide::Writer writer(msg.data());
+        Wide::set<"Symbol">(msg.data(), "IBM");
+        if (big) writer.set<"Big">(*big);
+        if (yield) writer.set<"Yield">(*yield);
+        msg.resize(writer.size());
+        msgs.push_back(std::move(msg));
+    };
+    add(std::nullopt, std::nullopt);
+    add(0, 0.0);
+    add(std::nullopt, std::nullopt);
+    add(static_cast<LLong>(1) << 100, 0.0);
+    add(0, 1.5);
+
+    WideCodec::Encoder encoder;
+    std::vector<std::byte> records(msgs.size() * WideCodec::MAX_RECORD_SIZE);
+    std::byte* out = records.data();
+    for (const auto& msg : msgs) {
+        out = encoder.encode(msg.data(), out);
+    }
+    WideCodec::Decoder decoder;
+    const std::byte* ptr = records.data();
+    for (const auto& expected : msgs) {
+        std::array<std::byte, Wide::MAX_SIZE> decoded;
+        BOOST_REQUIRE_EQUAL(decoder.decode(ptr, out, decoded.data()), expected.size());
+        BOOST_REQUIRE(std::memcmp(decoded.data(), expected.data(), expected.size()) == 0);
+    }
+    BOOST_CHECK(ptr == out);
+}
+
+BOOST_AUTO_TEST_CASE(test_delta_corrupt) {
+    Journal journal;
+    std::array<std::byte, Quote::MAX_SIZE> msg;
+    for (int i = 0; i < 10; ++i) {
+        journal.add(msg.data(), makeQuote(msg.data(), i));
+    }
+    // every truncation of the journal stops on an exception, never past the end
+    for (size_t len = 0; len < journal.records.size(); ++len) {
+        Codec::Decoder decoder;
+        const std::byte* ptr = journal.records.data();
+        const std::byte* end = ptr + len;
+        size_t decoded = 0;
+        BOOST_CHECK_THROW(while (true) { decoder.decode(ptr, end, msg.data()); ++decoded; }, std::invalid_argument);
+        BOOST_CHECK_LE(decoded, journal.msgs.size());
+    }
+
+    // a slot that was never introduced
+    Codec::Decoder decoder;
+    const std::byte bad[] = {std::byte{5}, std::byte{0}};
+    const std::byte* ptr = bad;
+    BOOST_CHECK_THROW(decoder.decode(ptr, bad + sizeof(bad), msg.data()), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
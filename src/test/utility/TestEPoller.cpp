@@ -0,0 +1,546 @@
+#include <boost/test/unit_test.hpp>
+#include <hw/utility/EPoller.hpp>
+#include <hw/utility/URingPoller.hpp>
+#include <hw/assembly/EtherIngest.hpp>
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <vector>
+#include <string>
+#include <sys/resource.h>
+#include <unistd.h>
+
+using namespace hw::utility;
+
+namespace {
+
+uint16_t testPort(uint16_t offset) {
+    return static_cast<uint16_t>(20000 + (::getpid() % 20000) + offset);
+}
+
+enum class ReadMode {
+    Poller,   // handlers read through poller.read()
+    Staged,   // same, sockets marked with stageReads()
+    Raw,      // handlers call ::read themselves
+};
+
+// Loopback echo: the server echoes whatever it reads; the client sends a short message
+// and then a payload spanning many receive buffers.
+template <typename Poller>
+void echoRoundTrip(Poller & poller, uint16_t port, ReadMode mode = ReadMode::Poller) {
+    auto read = [&poller, mode] (int fd, char * buf, size_t len, size_t & n) {
+        if (mode != ReadMode::Raw) {
+            return poller.read(fd, buf, len, n);
+        }
+        const ssize_t rc = ::read(fd, buf, len);
+        n = rc > 0 ? static_cast<size_t>(rc) : 0;
+        return rc >= 0 ? 0 : EAGAIN;
+    };
+    int accepted = 0;
+    bool serverSawEof = false;
+    EventHandler echo = [&] (int fd, SocketState state, int) {
+        if (state != SocketState::DATA_READY) return;
+        char buf[1500];
+        size_t n = 0;
+        while (read(fd, buf, sizeof(buf), n) == 0) {
+            if (n == 0) {
+                serverSawEof = true;
+                poller.close(fd);
+                return;
+            }
+            size_t written = 0;
+            BOOST_REQUIRE_EQUAL(poller.write(fd, buf, n, written), 0);
+            BOOST_REQUIRE_EQUAL(written, n);
+        }
+    };
+    auto [server, serr] = poller.listen("127.0.0.1", port, [&] (int fd, SocketState state, int) {
+        if (state == SocketState::ACCEPT_READY) {
+            for (int sock; (sock = poller.accept(fd, echo).first) >= 0; ++accepted) {
+                if (mode == ReadMode::Staged) poller.stageReads(sock);
+            }
+        }
+    });
+    BOOST_REQUIRE_MESSAGE(server >= 0, "listen failed: " << serr);
+
+    bool connected = false;
+    std::string received;
+    auto [client, cerr] = poller.connect("127.0.0.1", port, [&] (int fd, SocketState state, int) {
+        if (state == SocketState::CONNECTED) {
+            connected = true;
+        }
+        else if (state == SocketState::DATA_READY) {
+            char buf[4096];
+            size_t n = 0;
+            while (read(fd, buf, sizeof(buf), n) == 0 && n > 0) {
+                received.append(buf, n);
+            }
+        }
+    });
+    BOOST_REQUIRE_MESSAGE(client >= 0, "connect failed: " << cerr);
+    if (mode == ReadMode::Staged) {
+        BOOST_CHECK_EQUAL(poller.stageReads(client), 0);
+    }
+
+    auto pollUntil = [&poller] (auto && done) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!done() && std::chrono::steady_clock::now() < deadline) {
+            poller.poll(1);
+        }
+        return done();
+    };
+
+    BOOST_REQUIRE(pollUntil([&] { return connected && accepted == 1; }));
+    BOOST_CHECK(poller.connected(client));
+
+    size_t written = 0;
+    BOOST_REQUIRE_EQUAL(poller.write(client, "hello", 5, written), 0);
+    poller.flush();
+    BOOST_REQUIRE(pollUntil([&] { return received.size() == 5; }));
+    BOOST_CHECK_EQUAL(received, "hello");
+
+    std::string payload(256 * 1024, '\0');
+    for (size_t i = 0; i < payload.size(); ++i) payload[i] = static_cast<char>('a' + i % 26);
+    received.clear();
+    size_t offset = 0;
+    BOOST_REQUIRE(pollUntil([&] {
+        if (offset < payload.size()) {
+            size_t n = 0;
+            if (poller.write(client, payload.data() + offset, std::min<size_t>(16384, payload.size() - offset), n) == 0) {
+                offset += n;
+            }
+        }
+        return received.size() == payload.size();
+    }));
+    BOOST_CHECK(received == payload);
+
+    BOOST_CHECK_EQUAL(poller.close(client), 0);
+    BOOST_CHECK_EQUAL(poller.close(client), -1);
+    BOOST_REQUIRE(pollUntil([&] { return serverSawEof; }));
+    BOOST_CHECK_EQUAL(poller.close(server), 0);
+}
+
+// Framed echo: the server sends back every frame it gets; the client pushes frames of growing
+// size until several megabytes went through, so send rings fill and EPOLLOUT gets armed.
+void framedEchoRoundTrip(EPoller & poller, uint16_t port) {
+    using Framer32 = LengthPrefixFramer<uint32_t>;
+    static constexpr int SMALL_BUFFER = 8192; // socket buffers small enough for the kernel to push back
+    // frames the send ring could not take wait here until WRITE_READY
+    std::deque<std::string> parked;
+    auto resend = [&] (int fd) {
+        while (!parked.empty() && poller.send(fd, parked.front().data(), parked.front().size()) == 0) {
+            parked.pop_front();
+        }
+    };
+    EventHandler serverEvents = [&] (int fd, SocketState state, int) {
+        if (state == SocketState::DISCONNECTED) poller.close(fd);
+        if (state == SocketState::WRITE_READY) resend(fd);
+    };
+    FrameHandler echo = [&] (int fd, const char * frame, size_t len) {
+        resend(fd);
+        if (!parked.empty() || poller.send(fd, frame, len) == ENOBUFS) {
+            parked.emplace_back(frame, len);
+        }
+    };
+    auto [server, serr] = poller.listen("127.0.0.1", port, [&] (int fd, SocketState state, int) {
+        if (state != SocketState::ACCEPT_READY) return;
+        for (int sock; (sock = poller.accept(fd, serverEvents).first) >= 0;) {
+            ::setsockopt(sock, SOL_SOCKET, SO_SNDBUF, &SMALL_BUFFER, sizeof(SMALL_BUFFER));
+            BOOST_REQUIRE_EQUAL(poller.frame(sock, Framer32{}, echo), 0);
+        }
+    });
+    BOOST_REQUIRE_MESSAGE(server >= 0, "listen failed: " << serr);
+
+    auto makeFrame = [] (uint32_t seq) {
+        std::string body(1 + seq * 7 % 3000, static_cast<char>('a' + seq % 26));
+        std::memcpy(body.data(), &seq, std::min(sizeof(seq), body.size()));
+        const uint32_t len = htonl(static_cast<uint32_t>(body.size()));
+        return std::string(reinterpret_cast<const char *>(&len), sizeof(len)) + body;
+    };
+
+    bool connected = false;
+    int writeReady = 0;
+    uint32_t received = 0;
+    auto [client, cerr] = poller.connect("127.0.0.1", port, [&] (int, SocketState state, int) {
+        if (state == SocketState::CONNECTED) connected = true;
+        if (state == SocketState::WRITE_READY) ++writeReady;
+    });
+    BOOST_REQUIRE_MESSAGE(client >= 0, "connect failed: " << cerr);
+    ::setsockopt(client, SOL_SOCKET, SO_SNDBUF, &SMALL_BUFFER, sizeof(SMALL_BUFFER));
+    BOOST_REQUIRE_EQUAL(poller.frame(client, Framer32{}, [&] (int, const char * frame, size_t len) {
+        BOOST_REQUIRE(std::string(frame, len) == makeFrame(received));
+        ++received;
+    }), 0);
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!connected && std::chrono::steady_clock::now() < deadline) poller.poll(1);
+    BOOST_REQUIRE(connected);
+
+    constexpr uint32_t FRAMES = 4000;
+    uint32_t sent = 0;
+    while (received < FRAMES && std::chrono::steady_clock::now() < deadline) {
+        while (sent < FRAMES) {
+            const std::string frame = makeFrame(sent);
+            if (poller.send(client, frame.data(), frame.size()) != 0) break;
+            ++sent;
+        }
+        poller.flush();
+        poller.poll(1);
+        poller.flush();
+    }
+    BOOST_CHECK_EQUAL(received, FRAMES);
+    BOOST_CHECK_GT(writeReady, 0);
+
+    BOOST_CHECK_EQUAL(poller.close(client), 0);
+    BOOST_CHECK_EQUAL(poller.close(server), 0);
+}
+
+// Sends seq numbers as 8-byte datagrams to group/host:port from a plain socket.
+void sendSequence(const char * host, uint16_t port, const std::vector<uint64_t> & seqs, bool multicast) {
+    int sock = ::socket(AF_INET, SOCK_DGRAM, 0);
+    BOOST_REQUIRE(sock >= 0);
+    if (multicast) {
+        in_addr iface {};
+        ::inet_pton(AF_INET, "127.0.0.1", &iface);
+        ::setsockopt(sock, IPPROTO_IP, IP_MULTICAST_IF, &iface, sizeof(iface));
+        int loop = 1;
+        ::setsockopt(sock, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+    }
+    sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    ::inet_pton(AF_INET, host, &addr.sin_addr);
+    for (uint64_t seq : seqs) {
+        BOOST_REQUIRE_EQUAL(::sendto(sock, &seq, sizeof(seq), 0, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)), 8);
+    }
+    ::close(sock);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(EPollerTests)
+
+BOOST_AUTO_TEST_CASE(test_sequence_gap_detector) {
+    std::vector<std::pair<uint64_t, uint64_t>> gaps;
+    SequenceGapDetector detector([&] (uint64_t from, uint64_t to) { gaps.emplace_back(from, to); });
+    BOOST_CHECK_EQUAL(detector.check(100), SequenceGapDetector::IN_ORDER);
+    BOOST_CHECK_EQUAL(detector.check(101), SequenceGapDetector::IN_ORDER);
+    BOOST_CHECK_EQUAL(detector.check(105), SequenceGapDetector::GAP);
+    BOOST_CHECK_EQUAL(detector.check(103), SequenceGapDetector::STALE);
+    BOOST_CHECK_EQUAL(detector.check(106), SequenceGapDetector::IN_ORDER);
+    BOOST_REQUIRE_EQUAL(gaps.size(), 1u);
+    BOOST_CHECK_EQUAL(gaps[0].first, 102u);
+    BOOST_CHECK_EQUAL(gaps[0].second, 105u);
+    BOOST_CHECK_EQUAL(detector.missing(), 3u);
+    BOOST_CHECK_EQUAL(detector.stale(), 1u);
+    detector.reset(1);
+    BOOST_CHECK_EQUAL(detector.check(1), SequenceGapDetector::IN_ORDER);
+}
+
+BOOST_AUTO_TEST_CASE(test_epoller_udp_unicast) {
+    EPoller poller;
+    const uint16_t port = testPort(6);
+    std::vector<uint64_t> received;
+    size_t batches = 0;
+    bool timestamped = true;
+    SequenceGapDetector detector;
+    auto [sock, err] = poller.bindUdp(UdpConfig{.address = "127.0.0.1", .port = port, .rcvBuf = 1 << 20, .batch = 4},
+        [&] (int, const Datagram * batch, size_t count) {
+            ++batches;
+            for (size_t i = 0; i < count; ++i) {
+                uint64_t seq;
+                BOOST_REQUIRE_EQUAL(batch[i].len, sizeof(seq));
+                std::memcpy(&seq, batch[i].data, sizeof(seq));
+                received.push_back(seq);
+                detector.check(seq);
+                timestamped = timestamped && batch[i].rxTime > 0;
+            }
+        },
+        [] (int, SocketState, int) {});
+    BOOST_REQUIRE_MESSAGE(sock >= 0, "bindUdp failed: " << err);
+
+    std::vector<uint64_t> seqs;
+    for (uint64_t seq = 1; seq <= 10; ++seq) {
+        if (seq != 7) seqs.push_back(seq);
+    }
+    sendSequence("127.0.0.1", port, seqs, false);
+    for (int i = 0; i < 100 && received.size() < seqs.size(); ++i) poller.poll(10);
+
+    BOOST_CHECK(received == seqs);
+    BOOST_CHECK_GE(batches, 3u); // 9 datagrams in batches of at most 4
+    BOOST_CHECK(timestamped);
+    BOOST_CHECK_EQUAL(detector.gaps(), 1u);
+    BOOST_CHECK_EQUAL(detector.missing(), 1u);
+    BOOST_CHECK_EQUAL(poller.close(sock), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_epoller_udp_multicast) {
+    EPoller poller(BusyPollConfig{.enabled = true});
+    const uint16_t port = testPort(7);
+    std::vector<uint64_t> received;
+    auto [sock, err] = poller.bindUdp(UdpConfig{.port = port, .group = "239.255.0.42", .interface = "127.0.0.1"},
+        [&] (int, const Datagram * batch, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                uint64_t seq;
+                std::memcpy(&seq, batch[i].data, sizeof(seq));
+                received.push_back(seq);
+            }
+        },
+        [] (int, SocketState, int) {});
+    if (sock < 0) {
+        BOOST_TEST_MESSAGE("multicast unavailable on loopback, skipping: " << err);
+        return;
+    }
+    sendSequence("239.255.0.42", port, {1, 2, 3}, true);
+    for (int i = 0; i < 100000 && received.size() < 3; ++i) poller.poll();
+    BOOST_CHECK(received == std::vector<uint64_t>({1, 2, 3}));
+
+    BOOST_CHECK_EQUAL(poller.leave(sock, "239.255.0.42", "127.0.0.1"), 0);
+    BOOST_CHECK_NE(poller.leave(sock, "239.255.0.42", "127.0.0.1"), 0);
+    BOOST_CHECK_EQUAL(poller.join(sock, "239.255.0.42", "127.0.0.1"), 0);
+    BOOST_CHECK_EQUAL(poller.close(sock), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_ether_ingest) {
+    struct Tick { uint64_t seq; };
+    struct Quote { uint64_t seq; char pad[56]; };
+    using FeedEther = hw::assembly::Ether<"Feed", hw::type::type_list<Tick, Quote>, 64, hw::assembly::PrivateEther>;
+    using Ingest = hw::assembly::EtherIngest<FeedEther, 4>;
+    static_assert(Ingest::SLOT_SIZE == sizeof(Quote));
+
+    std::unique_ptr<uint8_t, decltype(&std::free)> memory(
+        static_cast<uint8_t *>(std::aligned_alloc(4096, (FeedEther::REQUIRED_MEM_SIZE + 4095) & ~size_t(4095))), &std::free);
+    FeedEther ether;
+    ether.initialize(memory.get(), FeedEther::REQUIRED_MEM_SIZE, true);
+    FeedEther::Cursor writer(ether);
+    FeedEther::Cursor reader(ether);
+    std::vector<uint64_t> received;
+    auto drain = [&] {
+        while (reader.readMsg([&] (FeedEther::EtherMsg & msg) {
+            BOOST_REQUIRE(std::holds_alternative<Tick *>(msg.selector));
+            received.push_back(reinterpret_cast<const Tick *>(msg.data)->seq);
+        }) > 0);
+    };
+
+    // allocMsg + abortMsg: the slot is skipped, the next message is read
+    writer.abortMsg(writer.allocMsg<Tick>(Tick{100}));
+    Tick & tick = writer.allocMsg<Tick>(Tick{101});
+    Tick & dropped = writer.allocMsg<Tick>(Tick{102});
+    writer.commitMsg(tick);
+    writer.abortMsg(dropped);
+    drain();
+    BOOST_CHECK(received == std::vector<uint64_t>({101}));
+    received.clear();
+
+    // datagrams land in the slots; multiples of 4 are rejected in place
+    EPoller poller(BusyPollConfig{.enabled = true});
+    Ingest ingest;
+    const uint16_t port = testPort(8);
+    int published = 0;
+    auto [sock, err] = poller.bindUdp(UdpConfig{.address = "127.0.0.1", .port = port}, {},
+        [&] (int fd, SocketState state, int) {
+            if (state != SocketState::DATA_READY) return;
+            int n;
+            while ((n = ingest.receive(writer, fd, [] (Ingest::Slot & slot) {
+                if (slot.size() == sizeof(Tick) && slot.as<Tick>().seq % 4 != 0) {
+                    slot.commit<Tick>();
+                }
+            })) > 0) {
+                published += n;
+            }
+        });
+    BOOST_REQUIRE_MESSAGE(sock >= 0, "bindUdp failed: " << err);
+    sendSequence("127.0.0.1", port, {1, 2, 3, 4, 5, 6, 7, 8, 9, 10}, false);
+    for (int i = 0; i < 100000 && published < 8; ++i) {
+        poller.poll();
+        drain();
+    }
+    drain();
+    BOOST_CHECK_EQUAL(published, 8);
+    BOOST_CHECK(received == std::vector<uint64_t>({1, 2, 3, 5, 6, 7, 9, 10}));
+    BOOST_CHECK_EQUAL(reader.queueLength(), 0u);
+    BOOST_CHECK_EQUAL(poller.close(sock), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_ether_ingest_prefix) {
+    // the newer binary ingests into an ether created by an older one: Trade is dropped
+    struct Tick { uint64_t seq; };
+    struct Quote { uint64_t seq; char pad[56]; };
+    struct Trade { uint64_t seq; int64_t price; };
+    using OldEther = hw::assembly::Ether<"Feed", hw::type::type_list<Tick, Quote>, 64, hw::assembly::PrivateEther>;
+    using NewEther = hw::assembly::Ether<"Feed", hw::type::type_list<Tick, Quote, Trade>, 64, hw::assembly::PrivateEther>;
+    using Ingest = hw::assembly::EtherIngest<NewEther, 4>;
+    static_assert(OldEther::REQUIRED_MEM_SIZE == NewEther::REQUIRED_MEM_SIZE);
+
+    std::unique_ptr<uint8_t, decltype(&std::free)> memory(
+        static_cast<uint8_t *>(std::aligned_alloc(4096, (OldEther::REQUIRED_MEM_SIZE + 4095) & ~size_t(4095))), &std::free);
+    OldEther old;
+    old.initialize(memory.get(), OldEther::REQUIRED_MEM_SIZE, true);
+    OldEther::Cursor reader(old);
+    NewEther ether;
+    ether.initialize(memory.get(), NewEther::REQUIRED_MEM_SIZE);
+    NewEther::Cursor writer(ether);
+    BOOST_REQUIRE_EQUAL(ether.peerMsgCnt(), 2u);
+
+    std::vector<uint64_t> received;
+    auto drain = [&] {
+        while (reader.readMsg([&] (OldEther::EtherMsg & msg) {
+            BOOST_REQUIRE(std::holds_alternative<Tick *>(msg.selector));
+            received.push_back(reinterpret_cast<const Tick *>(msg.data)->seq);
+        }) > 0);
+    };
+
+    // even sequence numbers parse as Trade, which the old binary cannot read
+    EPoller poller(BusyPollConfig{.enabled = true});
+    Ingest ingest;
+    const uint16_t port = testPort(11);
+    int published = 0;
+    int refused = 0;
+    auto [sock, err] = poller.bindUdp(UdpConfig{.address = "127.0.0.1", .port = port}, {},
+        [&] (int fd, SocketState state, int) {
+            if (state != SocketState::DATA_READY) return;
+            int n;
+            while ((n = ingest.receive(writer, fd, [&] (Ingest::Slot & slot) {
+                if (slot.size() != sizeof(uint64_t)) return;
+                if (slot.as<Tick>().seq % 2) {
+                    slot.commit<Tick>();
+                } else if (!slot.commit<Trade>()) {
+                    ++refused;
+                }
+            })) > 0) {
+                published += n;
+            }
+        });
+    BOOST_REQUIRE_MESSAGE(sock >= 0, "bindUdp failed: " << err);
+    sendSequence("127.0.0.1", port, {1, 2, 3, 4, 5, 6}, false);
+    for (int i = 0; i < 100000 && published + refused < 6; ++i) {
+        poller.poll();
+        drain();
+    }
+    drain();
+    BOOST_CHECK_EQUAL(published, 3);
+    BOOST_CHECK_EQUAL(refused, 3);
+    BOOST_CHECK(received == std::vector<uint64_t>({1, 3, 5}));
+    BOOST_CHECK_EQUAL(reader.queueLength(), 0u);
+    BOOST_CHECK_EQUAL(poller.close(sock), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_framers) {
+    const char prefixed[] = {0, 3, 'a', 'b', 'c', 0, 5, 'x'};
+    LengthPrefixFramer<uint16_t> framer;
+    BOOST_CHECK_EQUAL(framer(prefixed, 1), 0u);
+    BOOST_CHECK_EQUAL(framer(prefixed, 4), 0u);
+    BOOST_CHECK_EQUAL(framer(prefixed, sizeof(prefixed)), 5u);
+    BOOST_CHECK_EQUAL(framer(prefixed + 5, 3), 0u);
+
+    // length counts a one-byte type plus the header itself
+    const char typed[] = {'T', 5, 0, 'h', 'i', 'T', 1, 0};
+    LengthPrefixFramer<uint16_t, false, true, 1> inclusive;
+    BOOST_CHECK_EQUAL(inclusive(typed, sizeof(typed)), 5u);
+    BOOST_CHECK_EQUAL(inclusive(typed + 5, 3), FRAME_ERROR);
+
+    DelimiterFramer lines;
+    BOOST_CHECK_EQUAL(lines("abc", 3), 0u);
+    BOOST_CHECK_EQUAL(lines("ab\ncd\n", 6), 3u);
+    BOOST_CHECK_EQUAL((DelimiterFramer{'\x01'}("8=FIX\x01", 6)), 6u);
+}
+
+BOOST_AUTO_TEST_CASE(test_bounded_buffer_wrap) {
+    BoundedBuffer<4096> buffer("test_bounded_buffer_wrap");
+    BOOST_CHECK_EQUAL(buffer.available(), 4096u);
+    std::string chunk(3000, 'q');
+    for (int round = 0; round < 5; ++round) {
+        // every other round straddles the end of the ring; the mirror keeps it contiguous
+        BOOST_REQUIRE_GE(buffer.available(), chunk.size());
+        std::memcpy(buffer.beginWrite(), chunk.data(), chunk.size());
+        buffer.commitWrite(chunk.size());
+        BOOST_CHECK_EQUAL(buffer.size(), chunk.size());
+        BOOST_CHECK(std::string(buffer.beginRead(), buffer.size()) == chunk);
+        buffer.commitRead(chunk.size());
+        BOOST_CHECK_EQUAL(buffer.size(), 0u);
+        chunk.assign(chunk.size(), static_cast<char>('a' + round));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_epoller_framed) {
+    EPoller poller;
+    framedEchoRoundTrip(poller, testPort(4));
+}
+
+BOOST_AUTO_TEST_CASE(test_epoller_framed_busy_poll) {
+    EPoller poller(BusyPollConfig{.enabled = true});
+    framedEchoRoundTrip(poller, testPort(5));
+}
+
+BOOST_AUTO_TEST_CASE(test_epoller_echo) {
+    EPoller poller;
+    echoRoundTrip(poller, testPort(0));
+}
+
+BOOST_AUTO_TEST_CASE(test_epoller_busy_poll) {
+    EPoller poller(BusyPollConfig{.enabled = true, .rxBufferSize = 4096});
+    echoRoundTrip(poller, testPort(3));
+}
+
+BOOST_AUTO_TEST_CASE(test_epoller_busy_poll_staged) {
+    EPoller poller(BusyPollConfig{.enabled = true, .rxBufferSize = 4096});
+    echoRoundTrip(poller, testPort(9), ReadMode::Staged);
+}
+
+BOOST_AUTO_TEST_CASE(test_epoller_busy_poll_raw_read) {
+    // handlers written for default mode keep working when the dispatcher switches to busy poll
+    EPoller poller(BusyPollConfig{.enabled = true});
+    echoRoundTrip(poller, testPort(10), ReadMode::Raw);
+}
+
+BOOST_AUTO_TEST_CASE(test_uring_poller_echo) {
+    std::unique_ptr<URingPoller> poller;
+    try {
+        poller = std::make_unique<URingPoller>(URingConfig{.entries = 64, .bufferCount = 16, .bufferSize = 2048});
+    }
+    catch (const std::exception & ex) {
+        BOOST_TEST_MESSAGE("io_uring unavailable, skipping: " << ex.what());
+        return;
+    }
+    echoRoundTrip(*poller, testPort(1));
+}
+
+BOOST_AUTO_TEST_CASE(test_uring_poller_sqpoll) {
+    std::unique_ptr<URingPoller> poller;
+    try {
+        poller = std::make_unique<URingPoller>(URingConfig{.sqpoll = true});
+    }
+    catch (const std::exception & ex) {
+        BOOST_TEST_MESSAGE("io_uring unavailable, skipping: " << ex.what());
+        return;
+    }
+    BOOST_TEST_MESSAGE("sqpoll active: " << poller->sqpoll());
+    echoRoundTrip(*poller, testPort(2));
+}
+
+BOOST_AUTO_TEST_CASE(test_uring_poller_socket_failure) {
+    std::unique_ptr<URingPoller> poller;
+    try {
+        poller = std::make_unique<URingPoller>(URingConfig{.entries = 64, .bufferCount = 16, .bufferSize = 2048});
+    }
+    catch (const std::exception & ex) {
+        BOOST_TEST_MESSAGE("io_uring unavailable, skipping: " << ex.what());
+        return;
+    }
+    // no descriptor can be opened: connect and listen report the error instead of using fd -1
+    rlimit limit;
+    BOOST_REQUIRE_EQUAL(::getrlimit(RLIMIT_NOFILE, &limit), 0);
+    rlimit none = limit;
+    none.rlim_cur = 0;
+    BOOST_REQUIRE_EQUAL(::setrlimit(RLIMIT_NOFILE, &none), 0);
+    const auto [client, clientErr] = poller->connect("127.0.0.1", testPort(12), [] (int, SocketState, int) {});
+    const auto [server, serverErr] = poller->listen("127.0.0.1", testPort(12), [] (int, SocketState, int) {});
+    ::setrlimit(RLIMIT_NOFILE, &limit);
+    BOOST_CHECK_EQUAL(client, -1);
+    BOOST_CHECK_EQUAL(clientErr, EMFILE);
+    BOOST_CHECK_EQUAL(server, -1);
+    BOOST_CHECK_EQUAL(serverErr, EMFILE);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,116 @@
+#include <boost/test/unit_test.hpp>
+#include <hw/utility/HandlePool.hpp>
+#include <memory>
+#include <stdexcept>
+
+using namespace hw::utility;
+
+namespace {
+struct PooledQuote {
+    uint64_t id;
+    double bid;
+    double ask;
+};
+
+struct ThrowingQuote {
+    explicit ThrowingQuote(bool fail) {
+        if (fail) throw std::runtime_error("construct");
+    }
+};
+}
+
+BOOST_AUTO_TEST_SUITE(HandlePoolTests)
+
+BOOST_AUTO_TEST_CASE(test_handle_pool_stale_handle) {
+    HandlePool<PooledQuote> pool(4);
+    auto h1 = pool.allocate();
+    BOOST_REQUIRE(h1 != pool.NULL_HANDLE);
+    pool.construct(h1, PooledQuote{1, 99.5, 100.5});
+    BOOST_CHECK_EQUAL(pool.get(h1)->id, 1ULL);
+    BOOST_CHECK_EQUAL(pool[h1].ask, 100.5);
+
+    BOOST_CHECK(pool.free(h1));
+    BOOST_CHECK(!pool.free(h1));          // double free detected
+    BOOST_CHECK(pool.get(h1) == nullptr); // stale
+
+    // same slot, new generation
+    auto h2 = pool.allocate();
+    BOOST_CHECK_EQUAL(pool.slotOf(h2), pool.slotOf(h1));
+    BOOST_CHECK(h2 != h1);
+    BOOST_CHECK(pool.get(h1) == nullptr);
+    BOOST_CHECK(pool.get(h2) != nullptr);
+    BOOST_CHECK(pool.get(HandlePool<PooledQuote>::NULL_HANDLE) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_handle_pool_exhaustion) {
+    HandlePool<PooledQuote, 8> pool(3);
+    BOOST_CHECK_THROW((HandlePool<PooledQuote, 8>(256)), std::invalid_argument);
+    auto a = pool.allocate();
+    auto b = pool.allocate();
+    auto c = pool.allocate();
+    BOOST_CHECK(a && b && c);
+    BOOST_CHECK_EQUAL(pool.allocate(), pool.NULL_HANDLE);
+    BOOST_CHECK_EQUAL(pool.stats().fallbackCnt, 1);
+    BOOST_CHECK_EQUAL(pool.stats().inUse, 3);
+    pool.free(b);
+    BOOST_CHECK_EQUAL(pool.slotOf(pool.allocate()), pool.slotOf(b));
+
+    // generation wraps within its bits and never leaks into the index
+    for (int i = 0; i < 1000; ++i) {
+        pool.free(a);
+        a = pool.allocate();
+        BOOST_CHECK_EQUAL(pool.slotOf(a), 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_handle_pool_generation_wrap) {
+    // 28 index bits leave 16 generations: a stale handle is caught for 15 reuses of its slot
+    HandlePool<PooledQuote, 28> pool(2);
+    const auto stale = pool.allocate();
+    auto h = stale;
+    for (int i = 1; i < 16; ++i) {
+        pool.free(h);
+        h = pool.allocate();
+        BOOST_CHECK(!pool.valid(stale));
+    }
+    pool.free(h);
+    h = pool.allocate();
+    BOOST_CHECK_EQUAL(h, stale);
+}
+
+BOOST_AUTO_TEST_CASE(test_pooled_hashmap_throwing_construct) {
+    PooledHashmap<ThrowingQuote, 16> map(4);
+    BOOST_CHECK_THROW(map.emplace(7, true), std::runtime_error);
+    BOOST_CHECK_EQUAL(map.size(), 0);
+    BOOST_CHECK(map.find(7) == nullptr);
+    BOOST_CHECK_EQUAL(map.pool().stats().inUse, 0);
+    BOOST_CHECK(map.emplace(7, false).second);
+}
+
+BOOST_AUTO_TEST_CASE(test_pooled_hashmap) {
+    using Map = PooledHashmap<PooledQuote, 1024>;
+    auto map = std::make_unique<Map>(512);
+
+    for (uint64_t id = 1; id <= 512; ++id) {
+        auto [quote, inserted] = map->emplace(id * 1000, PooledQuote{id, 1.0, 2.0});
+        BOOST_REQUIRE(inserted);
+        BOOST_CHECK_EQUAL(quote->id, id);
+    }
+    BOOST_CHECK_EQUAL(map->size(), 512);
+    BOOST_CHECK(map->emplace(1000).second == false);
+    BOOST_CHECK(map->emplace(1).first == nullptr); // pool exhausted
+
+    BOOST_CHECK_EQUAL(map->find(5000)->id, 5ULL);
+    auto kept = map->handle(5000);
+    BOOST_CHECK(map->get(kept) != nullptr);
+    BOOST_CHECK(map->erase(5000));
+    BOOST_CHECK(map->find(5000) == nullptr);
+    BOOST_CHECK(map->get(kept) == nullptr);
+    BOOST_CHECK(!map->erase(5000));
+
+    auto [quote, inserted] = map->emplace(1, PooledQuote{1, 3.0, 4.0});
+    BOOST_CHECK(inserted);
+    BOOST_CHECK_EQUAL(map->find(1)->bid, 3.0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,79 @@
+#include <boost/test/unit_test.hpp>
+#include <hw/utility/Hex.hpp>
+#include <hw/utility/Text.hpp>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace hw::utility;
+
+BOOST_AUTO_TEST_SUITE(HexTests)
+
+BOOST_AUTO_TEST_CASE(test_hex_round_trip) {
+    // lengths around the 16-byte encode and 8-byte decode steps
+    for (size_t len = 0; len <= 40; ++len) {
+        std::vector<uint8_t> bytes(len);
+        std::string expected;
+        for (size_t i = 0; i < len; ++i) {
+            bytes[i] = static_cast<uint8_t>(i * 37 + 11);
+            static constexpr char digits[] = "0123456789abcdef";
+            expected += digits[bytes[i] >> 4];
+            expected += digits[bytes[i] & 0x0f];
+        }
+        std::string text(2 * len, '?');
+        BOOST_CHECK(hexEncode(bytes.data(), len, text.data()) == text.data() + text.size());
+        BOOST_CHECK_EQUAL(text, expected);
+
+        std::vector<uint8_t> decoded(len);
+        BOOST_CHECK(hexDecode(text.data(), len, decoded.data()));
+        BOOST_CHECK(decoded == bytes);
+
+        for (auto& c : text) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        std::fill(decoded.begin(), decoded.end(), 0);
+        BOOST_CHECK(hexDecode(text.data(), len, decoded.data()));
+        BOOST_CHECK(decoded == bytes);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_hex_decode_rejects) {
+    const std::string valid = "00112233445566778899aabbccddeeff";
+    std::vector<uint8_t> out(valid.size() / 2);
+    for (char bad : {'g', 'G', '/', ':', '@', '`', ' ', '\0', '\xff'}) {
+        for (size_t pos = 0; pos < valid.size(); ++pos) {
+            std::string text = valid;
+            text[pos] = bad;
+            BOOST_CHECK(!hexDecode(text.data(), out.size(), out.data()));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_from_chars) {
+    BOOST_CHECK_EQUAL(fromChars<int>("-42"), -42);
+    BOOST_CHECK_EQUAL(fromChars<uint8_t>("0x41"), 0x41);
+    BOOST_CHECK_EQUAL(fromChars<double>("1.5"), 1.5);
+    BOOST_CHECK_EQUAL(fromChars<bool>("TRUE"), true);
+    BOOST_CHECK_EQUAL(fromChars<bool>("0"), false);
+    BOOST_CHECK_EQUAL(fromChars<bool>("1"), true);
+    BOOST_CHECK_EQUAL(fromChars<bool>("False"), false);
+    BOOST_CHECK_THROW(fromChars<int>("12x"), std::invalid_argument);
+    BOOST_CHECK_THROW(fromChars<uint8_t>("256"), std::invalid_argument);
+    BOOST_CHECK_THROW(fromChars<double>(""), std::invalid_argument);
+
+    // bool takes the same forms as fromString<bool>, which only trims whitespace on top
+    for (const char* text : {"2", "-1", "0x1", "yes", ""}) {
+        BOOST_CHECK_THROW(fromChars<bool>(text), std::invalid_argument);
+        BOOST_CHECK_THROW(fromString<bool>(text), std::invalid_argument);
+    }
+    BOOST_CHECK_EQUAL(fromString<bool>(" TRUE "), true);
+    BOOST_CHECK_EQUAL(fromString<bool>("0"), false);
+
+    const __int128_t big = static_cast<__int128_t>(0x7fffffffffffffffll) * 1'000'000'000'000ll + 7;
+    BOOST_CHECK(fromChars<__int128_t>("9223372036854775807000000000007") == big);
+    BOOST_CHECK(fromChars<__int128_t>("-9223372036854775807000000000007") == -big);
+    BOOST_CHECK(fromChars<__uint128_t>("0xffffffffffffffffffffffffffffffff") == ~__uint128_t{0});
+    BOOST_CHECK_THROW(fromChars<__uint128_t>("0x1ffffffffffffffffffffffffffffffff"), std::invalid_argument);
+    BOOST_CHECK_THROW(fromChars<__int128_t>("-"), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -140,6 +140,9 @@ BOOST_AUTO_TEST_CASE(test_match_list) {
     
     // Empty
     static_assert(!BuilderAB::matchList(""));
+
+    // Same field twice
+    static_assert(!BuilderAB::matchList("FieldA, FieldA"));
 }
 
 // -----------------------------------------------------------------------------
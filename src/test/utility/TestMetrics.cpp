@@ -0,0 +1,153 @@
+#include <boost/test/unit_test.hpp>
+#include <hw/utility/Metrics.hpp>
+#include <hw/utility/MMap.hpp>
+#include <hw/utility/SwissTable.hpp>
+#include <hw/utility/OrderBurstControl.hpp>
+#include <hw/utility/cce/OrderCounter.hpp>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+using namespace hw::utility;
+
+BOOST_AUTO_TEST_SUITE(MetricsTests)
+
+BOOST_AUTO_TEST_CASE(test_metrics_registry) {
+    MetricsRegistry registry("", 16, 4, 256);
+    MetricShard & first = registry.shard("first");
+    MetricShard & second = registry.shard("second");
+
+    Counter messages = first.counter("ether.messages");
+    Gauge lag = first.gauge("ether.lag");
+    Histogram batch = first.histogram("ether.batch_size");
+    messages.add(5);
+    messages.add();
+    lag.set(-3);
+    batch.record(0);
+    batch.record(1);
+    batch.record(100);
+
+    // same name in another shard is the same metric
+    Counter other = second.counter("ether.messages");
+    other.add(10);
+    second.gauge("ether.lag").set(7);
+    second.histogram("ether.batch_size").record(100);
+
+    const MetricsView view(registry);
+    BOOST_CHECK_EQUAL(view.metricCnt(), 3u);
+    BOOST_CHECK_EQUAL(view.shardCnt(), 2u);
+    BOOST_CHECK_EQUAL(view.shardName(1), "second");
+
+    const size_t m = view.find("ether.messages");
+    BOOST_REQUIRE(m != MetricsView::NOT_FOUND);
+    BOOST_CHECK(view.kind(m) == MetricKind::Counter);
+    BOOST_CHECK_EQUAL(view.value(m, 0), 6u);
+    BOOST_CHECK_EQUAL(view.value(m, 1), 10u);
+    BOOST_CHECK_EQUAL(view.total(m), 16u);
+
+    const size_t g = view.find("ether.lag");
+    BOOST_CHECK_EQUAL(static_cast<int64_t>(view.value(g, 0)), -3);
+    BOOST_CHECK_EQUAL(static_cast<int64_t>(view.total(g)), 4);
+
+    const MetricsView::HistogramValue hist = view.histogram(view.find("ether.batch_size"));
+    BOOST_CHECK_EQUAL(hist.count, 4u);
+    BOOST_CHECK_EQUAL(hist.sum, 201u);
+    BOOST_CHECK_EQUAL(hist.buckets[0], 1u);
+    BOOST_CHECK_EQUAL(hist.buckets[1], 1u);
+    BOOST_CHECK_EQUAL(hist.buckets[7], 2u);   // 64 <= 100 < 128
+    BOOST_CHECK_EQUAL(hist.percentile(0.99), 127u);
+    BOOST_CHECK_EQUAL(view.histogram(view.find("ether.batch_size"), 1).count, 1u);
+
+    BOOST_CHECK(view.find("missing") == MetricsView::NOT_FOUND);
+}
+
+BOOST_AUTO_TEST_CASE(test_metrics_registry_errors) {
+    MetricsRegistry registry("", 2, 1, 8);
+    MetricShard & shard = registry.shard("only");
+    BOOST_CHECK_THROW(registry.shard("another"), std::length_error);
+
+    shard.counter("count");
+    BOOST_CHECK_THROW(shard.gauge("count"), std::invalid_argument);
+    BOOST_CHECK_THROW(shard.counter(""), std::invalid_argument);
+    BOOST_CHECK_THROW(shard.counter(std::string(metrics::NAME_SIZE, 'x')), std::invalid_argument);
+    BOOST_CHECK_THROW(shard.histogram("hist"), std::length_error);   // 67 words in a shard of 8
+    shard.gauge("level");
+    BOOST_CHECK_THROW(shard.counter("third"), std::length_error);
+
+    // unregistered handles write to the sink
+    Counter counter;
+    counter.add(3);
+    Histogram hist;
+    hist.record(UINT64_MAX);
+}
+
+BOOST_AUTO_TEST_CASE(test_metrics_file) {
+    const std::string path = "/tmp/hw_test_metrics_" + std::to_string(::getpid());
+    {
+        MetricsRegistry registry(path);
+        MetricShard & shard = registry.shard("dispatcher");
+        Counter counter = shard.counter("component.orders");
+
+        // writer thread updates while this thread reads the file through its own mapping
+        std::thread writer([&counter] {
+            for (int i = 0; i < 100000; ++i) {
+                counter.add();
+            }
+        });
+        const ReadableMmap file(path);
+        const MetricsView view(file.data(), file.size());
+        const size_t m = view.find("component.orders");
+        uint64_t last = 0;
+        while (last < 100000) {
+            const uint64_t value = view.total(m);
+            BOOST_REQUIRE_GE(value, last);   // single writer: never goes back
+            last = value;
+        }
+        writer.join();
+        BOOST_CHECK_EQUAL(view.pid(), ::getpid());
+        BOOST_CHECK_EQUAL(view.shardName(0), "dispatcher");
+    }
+    std::remove(path.c_str());
+
+    uint8_t garbage[256] = {};
+    BOOST_CHECK_THROW(MetricsView(garbage, sizeof(garbage)), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(test_metrics_sources) {
+    // tombstones of the Swiss table
+    uint64_t values[10];
+    swisstable::HashmapST<uint64_t, 64, swisstable::DuplicatePolicy::Reject> table;
+    for (uint64_t i = 0; i < 10; ++i) {
+        table.insert(i + 1, &values[i]);
+    }
+    BOOST_CHECK_EQUAL(table.tombstones(), 0u);
+    table.erase(3);
+    table.erase(4);
+    table.erase(4);
+    BOOST_CHECK_EQUAL(table.tombstones(), 2u);
+    BOOST_CHECK_EQUAL(table.size(), 8u);
+    table.clear();
+    BOOST_CHECK_EQUAL(table.tombstones(), 0u);
+
+    // rejects of the rate limiters
+    using namespace std::chrono_literals;
+    OrderBurstControl<16> control(100ms, 2, 100ms, 1);
+    int64_t now = 1'000'000;
+    BOOST_CHECK(control.evaluate(now));
+    BOOST_CHECK(control.evaluate(now + 1000));
+    BOOST_CHECK(!control.evaluate(now + 2000));
+    BOOST_CHECK(!control.evaluate(now + 3000));
+    BOOST_CHECK_EQUAL(control.rejected(), 2u);
+
+    cce::OrderCounter<10> counter(10ms, 2);
+    BOOST_CHECK(counter.increment(now));
+    BOOST_CHECK(counter.increment(now + 1000));
+    BOOST_CHECK(!counter.increment(now + 2000));
+    BOOST_CHECK_EQUAL(counter.rejected(), 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
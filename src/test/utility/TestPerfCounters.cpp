@@ -0,0 +1,52 @@
+#include <boost/test/unit_test.hpp>
+#include <hw/utility/PerfCounters.hpp>
+#include <hw/assembly/PerfStats.hpp>
+#include <cstdint>
+#include <string_view>
+
+using namespace hw::utility;
+
+BOOST_AUTO_TEST_SUITE(PerfCounterTests)
+
+BOOST_AUTO_TEST_CASE(test_perf_counter_group) {
+    PerfCounterGroup group;
+    PerfSample first, second;
+    first.fill(~0ull);
+    group.read(first);
+    volatile uint64_t sum = 0;
+    for (uint64_t i = 0; i < 100000; ++i) {
+        sum = sum + i;
+    }
+    group.read(second);
+
+    if (!group.available()) {
+        // no PMU here: reads are zero and the reason is kept
+        BOOST_CHECK(!group.error().empty());
+        BOOST_CHECK(first == PerfSample{});
+        BOOST_CHECK(second == PerfSample{});
+        return;
+    }
+    BOOST_CHECK_GT(second[static_cast<size_t>(PerfEvent::Cycles)], first[static_cast<size_t>(PerfEvent::Cycles)]);
+    if (group.available(PerfEvent::Instructions)) {
+        BOOST_CHECK_GT(second[static_cast<size_t>(PerfEvent::Instructions)] - first[static_cast<size_t>(PerfEvent::Instructions)], 100000u);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_perf_stats_cells) {
+    using Stats = hw::assembly::PerfStats<2, 3>;
+    Stats stats;
+    BOOST_CHECK_EQUAL(stats.magic, Stats::MAGIC);
+    BOOST_CHECK_EQUAL(stats.cells[0].size(), 4u); // message types plus BATCH_END
+
+    const PerfSample from {10, 20, 0, 0, 1};
+    const PerfSample to {15, 32, 1, 0, 1};
+    stats.cells[1][Stats::BATCH_END].add(from, to);
+    stats.cells[1][Stats::BATCH_END].add(from, to);
+    BOOST_CHECK_EQUAL(stats.cells[1][Stats::BATCH_END].calls, 2u);
+    BOOST_CHECK_EQUAL(stats.cells[1][Stats::BATCH_END].counts[static_cast<size_t>(PerfEvent::Instructions)], 24u);
+
+    Stats::setName(stats.components[0], std::string_view("AVeryLongComponentNameThatDoesNotFitInTheFixedNameField"));
+    BOOST_CHECK_EQUAL(std::string_view(stats.components[0].data()).size(), Stats::NAME_SIZE - 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
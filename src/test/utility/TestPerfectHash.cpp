@@ -0,0 +1,40 @@
+#include <boost/test/unit_test.hpp>
+#include <hw/type/PerfectHash.hpp>
+#include <hw/type/TypeList.hpp>
+#include <hw/type/NamedType.hpp>
+#include <array>
+#include <string>
+#include <vector>
+
+using namespace hw::type;
+
+namespace {
+    using Prices = type_list<NamedType<"Bid", int>, NamedType<"Ask", int>, NamedType<"Last", double>>;
+    static_assert(FindTypeByName<Prices>("Last") == 2);
+    static_assert(FindTypeByName<Prices>("Mid") == 3);
+
+    static_assert(NAME_TAG_HASH<"Symbol", "Side", "Account">.find("Account") == 2);
+    static_assert(!NAME_TAG_HASH<"Symbol", "Side", "Account">.contains("account"));
+}
+
+BOOST_AUTO_TEST_SUITE(PerfectHashTests)
+
+BOOST_AUTO_TEST_CASE(test_many_keys) {
+    constexpr size_t N = 1000;
+    std::vector<std::string> storage;
+    storage.reserve(N);
+    std::array<std::string_view, N> keys;
+    for (size_t i = 0; i < N; ++i) {
+        storage.push_back("key_" + std::to_string(i * 7919));
+        keys[i] = storage.back();
+    }
+    const PerfectHash<N> table(keys);
+    for (size_t i = 0; i < N; ++i) {
+        BOOST_REQUIRE_EQUAL(table.find(keys[i]), i);
+    }
+    BOOST_CHECK_EQUAL(table.find("key_"), table.NOT_FOUND);
+    BOOST_CHECK_EQUAL(table.find(""), table.NOT_FOUND);
+    BOOST_CHECK_EQUAL(table.find("key_7919x"), table.NOT_FOUND);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,183 @@
+#include <boost/test/unit_test.hpp>
+#include <hw/type/beacon/Numeric.hpp>
+#include <hw/type/beacon/String.hpp>
+#include <hw/type/beacon/Opaque.hpp>
+#include <hw/type/beacon/Message.hpp>
+#include <hw/type/beacon/Schema.hpp>
+#include <hw/assembly/Ether.hpp>
+#include <array>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+using namespace hw::type;
+using namespace hw::type::beacon;
+
+namespace {
+
+using AmendV1 = NamedMessageType<"Amend", type_list<
+    NamedNumericType<"OrderId", Long>,
+    Optional<NamedNumericType<"Price", Price>>,
+    Optional<NamedNumericType<"Qty", Int>>,
+    NamedVariableStringType<"Text", 8>
+>>;
+
+// adds fields that V1 messages simply do not have
+using AmendV2 = NamedMessageType<"Amend", type_list<
+    NamedNumericType<"OrderId", Long>,
+    Optional<NamedNumericType<"Price", Price>>,
+    Optional<NamedNumericType<"Qty", Int>>,
+    Optional<NamedNumericType<"Flags", Short>>,
+    NamedVariableStringType<"Text", 8>,
+    Optional<NamedOpaqueType<"Tag", 8>>
+>>;
+
+// widens Qty and moves it
+using AmendV3 = NamedMessageType<"Amend", type_list<
+    NamedNumericType<"OrderId", Long>,
+    Optional<NamedNumericType<"Qty", Long>>,
+    Optional<NamedNumericType<"Price", Price>>,
+    NamedVariableStringType<"Text", 4>
+>>;
+
+static_assert(MessageAdapter<AmendV1, AmendV1>::DIRECT);
+static_assert(MessageAdapter<AmendV1, AmendV2>::DIRECT);
+static_assert(!MessageAdapter<AmendV1, AmendV3>::DIRECT);
+static_assert(!MessageAdapter<AmendV2, AmendV1>::DIRECT);
+
+struct Tick { int64_t price; int32_t qty; };
+struct Quote { int64_t bid; int64_t ask; };
+struct Trade { int64_t price; int32_t qty; char side; };
+
+using FeedV1 = hw::assembly::Ether<"Feed", type_list<Tick, Quote>, 16, hw::assembly::PrivateEther>;
+using FeedV2 = hw::assembly::Ether<"Feed", type_list<Tick, Quote, Trade>, 16, hw::assembly::PrivateEther>;
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(SchemaTests)
+
+BOOST_AUTO_TEST_CASE(test_message_compatibility) {
+    const MessageSchema v1 = describeMessage<AmendV1>();
+    BOOST_CHECK(checkMessage(v1, describeMessage<AmendV1>()).result == Compatibility::IDENTICAL);
+    BOOST_CHECK(checkMessage(v1, describeMessage<AmendV2>()).result == Compatibility::READABLE);
+
+    const SchemaCheck reordered = checkMessage(v1, describeMessage<AmendV3>());
+    BOOST_CHECK(reordered.result == Compatibility::INCOMPATIBLE);
+    BOOST_CHECK_EQUAL(reordered.reason, "field Qty is reordered");
+    BOOST_CHECK(!checkMessage(describeMessage<AmendV2>(), describeMessage<AmendV1>()));
+}
+
+BOOST_AUTO_TEST_CASE(test_registry_file) {
+    SchemaRegistry recorded;
+    recorded.addMessage<AmendV1>();
+    recorded.addEther<FeedV1>();
+    const std::string path = (std::filesystem::temp_directory_path() / "hw_test_schema.txt").string();
+    recorded.save(path);
+
+    const SchemaRegistry registry = SchemaRegistry::load(path);
+    std::filesystem::remove(path);
+    BOOST_REQUIRE(registry.findMessage("Amend"));
+    BOOST_CHECK_EQUAL(registry.findMessage("Amend")->fields.size(), 4u);
+    BOOST_CHECK(registry.findMessage("Amend")->fields == describeMessage<AmendV1>().fields);
+    BOOST_CHECK(registry.checkMessage<AmendV1>().result == Compatibility::IDENTICAL);
+    BOOST_CHECK(registry.checkMessage<AmendV2>().result == Compatibility::READABLE);
+    BOOST_CHECK(registry.checkMessage<AmendV3>().result == Compatibility::INCOMPATIBLE);
+    BOOST_CHECK(registry.checkEther<FeedV1>().result == Compatibility::IDENTICAL);
+    BOOST_CHECK(registry.checkEther<FeedV2>().result == Compatibility::READABLE);
+
+    const std::string code = registry.generate("Amend", "AmendRecorded");
+    BOOST_CHECK_EQUAL(code,
+        "using AmendRecorded = hw::type::beacon::NamedMessageType<\"Amend\", hw::type::type_list<\n"
+        "    hw::type::beacon::NamedNumericType<\"OrderId\", long int>,\n"
+        "    hw::type::beacon::Optional<hw::type::beacon::NamedNumericType<\"Price\", long int>>,\n"
+        "    hw::type::beacon::Optional<hw::type::beacon::NamedNumericType<\"Qty\", int>>,\n"
+        "    hw::type::beacon::NamedVariableStringType<\"Text\", 8>\n"
+        ">>;\n");
+}
+
+BOOST_AUTO_TEST_CASE(test_message_adapter) {
+    std::array<std::byte, AmendV1::MAX_SIZE> v1 {};
+    AmendV1::Writer writer(v1.data());
+    AmendV1::set<"OrderId">(v1.data(), 7);
+    writer.set<"Qty">(250);
+    writer.set<"Text">("refill");
+    writer.size();
+
+    std::array<std::byte, AmendV3::MAX_SIZE> scratch {};
+    using Upgrade = MessageAdapter<AmendV1, AmendV2>;
+    BOOST_CHECK(Upgrade::view(v1.data(), scratch.data()) == v1.data());
+    BOOST_CHECK_EQUAL(*AmendV2::get<"Qty">(v1.data()), 250);
+    BOOST_CHECK(!AmendV2::get<"Flags">(v1.data()));
+    BOOST_CHECK_EQUAL(AmendV2::get<"Text">(v1.data()), "refill");
+    BOOST_CHECK(!AmendV2::get<"Tag">(v1.data()));
+
+    const std::byte* v3 = MessageAdapter<AmendV1, AmendV3>::view(v1.data(), scratch.data());
+    BOOST_CHECK(v3 == scratch.data());
+    BOOST_CHECK_EQUAL(AmendV3::get<"OrderId">(v3), 7);
+    BOOST_CHECK_EQUAL(*AmendV3::get<"Qty">(v3), 250);
+    BOOST_CHECK(!AmendV3::get<"Price">(v3));
+    BOOST_CHECK_EQUAL(AmendV3::get<"Text">(v3), "refi");
+}
+
+BOOST_AUTO_TEST_CASE(test_ether_upgrade) {
+    static_assert(FeedV1::SLOT_SIZE == FeedV2::SLOT_SIZE && FeedV1::REQUIRED_MEM_SIZE == FeedV2::REQUIRED_MEM_SIZE);
+    std::unique_ptr<uint8_t, decltype(&std::free)> memory(
+        static_cast<uint8_t *>(std::aligned_alloc(4096, (FeedV1::REQUIRED_MEM_SIZE + 4095) & ~size_t(4095))), &std::free);
+
+    FeedV1 v1;
+    v1.initialize(memory.get(), FeedV1::REQUIRED_MEM_SIZE, true);
+    FeedV1::Cursor writer(v1);
+    FeedV2 v2;
+    v2.initialize(memory.get(), FeedV2::REQUIRED_MEM_SIZE);
+    BOOST_CHECK_EQUAL(v2.peerMsgCnt(), 2u);
+    FeedV2::Cursor reader(v2);
+
+    writer.commitMsg(writer.allocMsg<Quote>(Quote{100, 101}));
+    int64_t ask = 0;
+    BOOST_CHECK_EQUAL(reader.readMsg([&] (FeedV2::EtherMsg & msg) {
+        std::visit([&] (auto * type) {
+            if constexpr (std::is_same_v<std::remove_pointer_t<decltype(type)>, Quote>) {
+                ask = reinterpret_cast<const Quote *>(msg.data)->ask;
+            }
+        }, msg.selector);
+    }), 1);
+    BOOST_CHECK_EQUAL(ask, 101);
+
+    // an ether created by the newer binary is not one the older binary can read
+    v2.initialize(memory.get(), FeedV2::REQUIRED_MEM_SIZE, true);
+    BOOST_CHECK_EQUAL(v2.peerMsgCnt(), 3u);
+    BOOST_CHECK_THROW(v1.initialize(memory.get(), FeedV1::REQUIRED_MEM_SIZE), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(test_ether_prefix_publish) {
+    std::unique_ptr<uint8_t, decltype(&std::free)> memory(
+        static_cast<uint8_t *>(std::aligned_alloc(4096, (FeedV1::REQUIRED_MEM_SIZE + 4095) & ~size_t(4095))), &std::free);
+
+    // the newer binary attached to an ether of the older one publishes only the shared prefix
+    FeedV1 v1;
+    v1.initialize(memory.get(), FeedV1::REQUIRED_MEM_SIZE, true);
+    FeedV1::Cursor reader(v1);
+    FeedV2 v2;
+    v2.initialize(memory.get(), FeedV2::REQUIRED_MEM_SIZE);
+    FeedV2::Cursor writer(v2);
+    BOOST_CHECK(writer.canPublish<Tick>());
+    BOOST_CHECK(writer.canPublish<Quote>());
+    BOOST_CHECK(!writer.canPublish<Trade>());
+
+    writer.commitMsg(writer.allocMsg<Quote>(Quote{100, 101}));
+    int64_t bid = 0;
+    BOOST_CHECK_EQUAL(reader.readMsg([&] (FeedV1::EtherMsg & msg) {
+        std::visit([&] (auto * type) {
+            if constexpr (std::is_same_v<std::remove_pointer_t<decltype(type)>, Quote>) {
+                bid = reinterpret_cast<const Quote *>(msg.data)->bid;
+            }
+        }, msg.selector);
+    }), 1);
+    BOOST_CHECK_EQUAL(bid, 100);
+
+    v2.initialize(memory.get(), FeedV2::REQUIRED_MEM_SIZE, true);
+    BOOST_CHECK(writer.canPublish<Trade>());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,136 @@
+#include <boost/test/unit_test.hpp>
+#include <hw/utility/SharedPool.hpp>
+#include <hw/utility/MMap.hpp>
+#include <array>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+
+using namespace hw::utility;
+
+namespace {
+struct Instrument {
+    uint64_t id;
+    double tickSize;
+    char symbol[16];
+};
+
+using Symbol = std::array<char, 16>;
+
+Symbol makeSymbol(const char* text) {
+    Symbol symbol {};
+    std::strncpy(symbol.data(), text, symbol.size());
+    return symbol;
+}
+
+std::string tempFile(const char* name) {
+    return "/tmp/hw_" + std::string(name) + "_" + std::to_string(::getpid()) + ".shm";
+}
+}
+
+BOOST_AUTO_TEST_SUITE(SharedPoolTests)
+
+BOOST_AUTO_TEST_CASE(test_shared_pool_recycle) {
+    std::vector<uint8_t> region(SharedPool<Instrument>::requiredSize(4) + ALIGNAS);
+    uint8_t* buffer = reinterpret_cast<uint8_t*>(detail::shmAlign(reinterpret_cast<uintptr_t>(region.data())));
+
+    SharedPool<Instrument> pool;
+    pool.initialize(buffer, SharedPool<Instrument>::requiredSize(4), 4);
+    std::vector<ShmHandle> handles;
+    for (int i = 0; i < 4; ++i) {
+        handles.push_back(pool.allocate());
+        BOOST_CHECK(handles.back() != SHM_NULL);
+    }
+    BOOST_CHECK_EQUAL(pool.allocate(), SHM_NULL);
+    BOOST_CHECK_EQUAL(pool.handle(pool.get(handles[2])), handles[2]);
+
+    pool.free(handles[1]);
+    BOOST_CHECK_EQUAL(pool.size(), 3);
+    BOOST_CHECK_EQUAL(pool.allocate(), handles[1]);
+}
+
+BOOST_AUTO_TEST_CASE(test_shared_table_mmap) {
+    using Table = SharedTable<uint64_t, Instrument>;
+    const std::string filename = tempFile("instruments");
+    constexpr size_t CAPACITY = 10'000;
+    const size_t size = Table::requiredSize(CAPACITY);
+    {
+        WritableMmap shmem(filename, size);
+        Table table;
+        table.initialize(shmem.data(), shmem.size(), CAPACITY);
+        for (uint64_t id = 1; id <= CAPACITY; ++id) {
+            Instrument instrument {id * 7, 0.01 * id, {}};
+            std::snprintf(instrument.symbol, sizeof(instrument.symbol), "SYM%lu", id);
+            auto [value, inserted] = table.emplace(id * 7, instrument);
+            BOOST_REQUIRE(inserted);
+            BOOST_CHECK_EQUAL(value->id, id * 7);
+        }
+        BOOST_CHECK_EQUAL(table.size(), CAPACITY);
+        BOOST_CHECK(table.emplace(7).second == false);
+        BOOST_CHECK(table.emplace(CAPACITY * 100).first == nullptr);  // full
+    }
+    {
+        // second mapping, likely at another address, read-only
+        ReadableMmap shmem(filename);
+        Table table;
+        table.attach(std::as_const(shmem).data(), shmem.size());
+        BOOST_CHECK(table.readOnly());
+        BOOST_CHECK_EQUAL(table.size(), CAPACITY);
+        for (uint64_t id = 1; id <= CAPACITY; ++id) {
+            const Instrument* instrument = table.find(id * 7);
+            BOOST_REQUIRE(instrument != nullptr);
+            BOOST_CHECK_EQUAL(instrument->id, id * 7);
+            BOOST_CHECK_EQUAL(instrument->symbol, ("SYM" + std::to_string(id)).c_str());
+        }
+        BOOST_CHECK(table.find(8) == nullptr);
+        BOOST_CHECK_THROW(table.emplace(8), std::logic_error);
+    }
+    {
+        // writable attach keeps the data and allows updates
+        WritableMmap shmem(filename, size, false);
+        Table table;
+        table.attach(shmem.data(), shmem.size());
+        BOOST_CHECK(table.erase(7));
+        BOOST_CHECK(!table.erase(7));
+        BOOST_CHECK(table.find(7) == nullptr);
+        BOOST_CHECK(table.find(14) != nullptr);
+        BOOST_CHECK_EQUAL(table.size(), CAPACITY - 1);
+    }
+    ::unlink(filename.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_shared_index_string_key) {
+    using Index = SharedIndex<Symbol>;
+    std::vector<uint8_t> region(Index::requiredSize(100) + ALIGNAS);
+    uint8_t* buffer = reinterpret_cast<uint8_t*>(detail::shmAlign(reinterpret_cast<uintptr_t>(region.data())));
+
+    Index index;
+    index.initialize(buffer, Index::requiredSize(100), 100);
+    BOOST_CHECK(index.insert(makeSymbol("AAPL"), 1));
+    BOOST_CHECK(index.insert(makeSymbol("MSFT"), 2));
+    BOOST_CHECK(!index.insert(makeSymbol("AAPL"), 3));
+
+    Index reader;
+    reader.attach(static_cast<const uint8_t*>(buffer), Index::requiredSize(100));
+    BOOST_CHECK_EQUAL(reader.find(makeSymbol("AAPL")), 1);
+    BOOST_CHECK_EQUAL(reader.find(makeSymbol("MSFT")), 2);
+    BOOST_CHECK_EQUAL(reader.find(makeSymbol("IBM")), SHM_NULL);
+
+    size_t count = 0;
+    reader.forEach([&count] (const Symbol&, ShmHandle) { ++count; });
+    BOOST_CHECK_EQUAL(count, 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_shared_table_signature_mismatch) {
+    const size_t size = SharedTable<uint64_t, Instrument>::requiredSize(16);
+    std::vector<uint8_t> region(size + ALIGNAS);
+    uint8_t* buffer = reinterpret_cast<uint8_t*>(detail::shmAlign(reinterpret_cast<uintptr_t>(region.data())));
+
+    SharedTable<uint64_t, Instrument> table;
+    table.initialize(buffer, size, 16);
+    SharedTable<uint32_t, Instrument> other;
+    BOOST_CHECK_THROW(other.attach(buffer, size), std::invalid_argument);
+    BOOST_CHECK_THROW(table.initialize(buffer, size - 1, 16), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,110 @@
+#include <boost/test/unit_test.hpp>
+#include <hw/type/beacon/Numeric.hpp>
+#include <hw/type/beacon/String.hpp>
+#include <hw/type/beacon/Message.hpp>
+#include <hw/type/beacon/Snapshot.hpp>
+#include <array>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+
+using namespace hw::type;
+using namespace hw::type::beacon;
+
+namespace {
+
+using Instrument = NamedMessageType<"Instrument", type_list<
+    NamedFixedStringType<"Symbol", 8>,
+    NamedNumericType<"InstrumentId", Int>,
+    NamedNumericType<"TickSize", Price>,
+    Optional<NamedNumericType<"LotSize", Int>>,
+    NamedVariableStringType<"Description", 32>
+>>;
+
+using Account = NamedMessageType<"Account", type_list<
+    NamedNumericType<"AccountId", Long>,
+    NamedVariableStringType<"Name", 16>
+>>;
+
+std::string symbolOf(int i) {
+    return "S" + std::to_string(i);
+}
+
+std::string tempPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(SnapshotTests)
+
+BOOST_AUTO_TEST_CASE(test_snapshot_lookup) {
+    constexpr int COUNT = 1000;
+    SnapshotBuilder<Instrument, "Symbol"> builder;
+    std::array<std::byte, Instrument::MAX_SIZE> msg;
+    for (int i = 0; i < COUNT; ++i) {
+        Instrument::Writer writer(msg.data());
+        Instrument::set<"Symbol">(msg.data(), symbolOf(i));
+        Instrument::set<"InstrumentId">(msg.data(), i);
+        Instrument::set<"TickSize">(msg.data(), 100 + i % 3);
+        if (i % 2) {
+            writer.set<"LotSize">(10 * i);
+        }
+        writer.set<"Description">("instrument " + std::to_string(i));
+        writer.size();
+        builder.add(msg.data());
+    }
+    const std::string path = tempPath("hw_test_snapshot.bin");
+    builder.save(path);
+
+    const Snapshot<Instrument, "Symbol"> snapshot(path);
+    BOOST_REQUIRE_EQUAL(snapshot.size(), size_t{COUNT});
+    const auto ids = snapshot.column<"InstrumentId">();
+    for (int i = 0; i < COUNT; ++i) {
+        const size_t row = snapshot.find(symbolOf(i));
+        BOOST_REQUIRE_EQUAL(row, size_t(i));
+        BOOST_CHECK_EQUAL(ids[row], i);
+        BOOST_CHECK_EQUAL(snapshot.get<"Description">(row), "instrument " + std::to_string(i));
+        BOOST_CHECK_EQUAL(snapshot.get<"LotSize">(row).has_value(), i % 2 == 1);
+    }
+    BOOST_CHECK_EQUAL(snapshot.find("S1000"), snapshot.NOT_FOUND);
+    BOOST_CHECK_EQUAL(snapshot.find(""), snapshot.NOT_FOUND);
+
+    // a mapping owned elsewhere
+    const hw::utility::ReadableMmap map(path);
+    const Snapshot<Instrument, "Symbol"> borrowed(map);
+    BOOST_CHECK_EQUAL(borrowed.find("S7"), 7u);
+    BOOST_CHECK_EQUAL(borrowed.messageSize(7), Instrument::size(borrowed.message(7)));
+
+    // another layout or another key
+    BOOST_CHECK_THROW((Snapshot<Account, "AccountId">(path)), std::invalid_argument);
+    using ById = Snapshot<Instrument, "InstrumentId">;
+    BOOST_CHECK_THROW(ById{path}, std::invalid_argument);
+    std::filesystem::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(test_snapshot_builder) {
+    using Accounts = Snapshot<Account, "AccountId">;
+    const std::string path = tempPath("hw_test_snapshot_accounts.bin");
+    SnapshotBuilder<Account, "AccountId"> builder;
+    builder.save(path);
+    BOOST_CHECK_EQUAL(Accounts(path).find(1), Accounts::NOT_FOUND);
+
+    std::array<std::byte, Account::MAX_SIZE> msg {};
+    Account::set<"AccountId">(msg.data(), 42);
+    builder.add(msg.data());
+    builder.add(msg.data());
+    std::filesystem::remove(path);
+    BOOST_CHECK_THROW(builder.save(path), std::invalid_argument);
+    BOOST_CHECK(!std::filesystem::exists(path));
+
+    SnapshotBuilder<Account, "AccountId"> single;
+    single.add(msg.data());
+    single.save(path);
+    BOOST_CHECK_EQUAL(Accounts(path).find(42), 0u);
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    BOOST_CHECK_THROW(Accounts{path}, std::invalid_argument);
+    std::filesystem::remove(path);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,206 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <hw/utility/Format.hpp>
+#include <hw/utility/MMap.hpp>
+#include <hw/utility/Metrics.hpp>
+#include <hw/utility/Text.hpp>
+
+using namespace hw::utility;
+
+namespace {
+
+struct Options {
+  std::string file;
+  std::string filter;
+  bool shards = false;
+  bool json = false;
+  int64_t watchMs = 0;
+};
+
+void usage() {
+  std::cerr <<
+    "usage: hw_metrics [options] <metrics file>\n"
+    "  --filter=<text>   metrics whose name contains text (all by default)\n"
+    "  --shards          one column per shard (dispatcher) instead of totals\n"
+    "  --json            print a JSON object instead of a table\n"
+    "  --watch=<ms>      print every interval; counters as rates per second\n";
+}
+
+std::string_view kindName(MetricKind kind) {
+  switch (kind) {
+    case MetricKind::Counter:   return "counter";
+    case MetricKind::Gauge:     return "gauge";
+    case MetricKind::Histogram: return "histogram";
+  }
+  return "?";
+}
+
+std::string histogramText(const MetricsView::HistogramValue & hist) {
+  if (hist.count == 0) {
+    return "count 0";
+  }
+  return frmt::format("count {} mean {:.1f} p50<={} p99<={} p99.9<={}", hist.count,
+    static_cast<double>(hist.sum) / static_cast<double>(hist.count),
+    hist.percentile(0.5), hist.percentile(0.99), hist.percentile(0.999));
+}
+
+// Counter rates need the previous sample: totals indexed by metric, per shard with --shards.
+using Sample = std::vector<std::vector<uint64_t>>;
+
+Sample sample(const MetricsView & view) {
+  Sample values(view.metricCnt());
+  for (size_t m = 0; m < values.size(); ++m) {
+    for (size_t s = 0, cnt = view.shardCnt(); s < cnt; ++s) {
+      values[m].push_back(view.value(m, s));
+    }
+  }
+  return values;
+}
+
+std::string scalarText(const MetricsView & view, size_t metric, uint64_t value, uint64_t previous, double seconds) {
+  if (view.kind(metric) == MetricKind::Gauge) {
+    return std::to_string(static_cast<int64_t>(value));
+  }
+  if (seconds > 0) {
+    return frmt::format("{:.0f}/s", static_cast<double>(value - previous) / seconds);
+  }
+  return std::to_string(value);
+}
+
+void printTable(const MetricsView & view, const Options & options, const Sample & now, const Sample & before, double seconds) {
+  const size_t shardCnt = view.shardCnt();
+  std::cout << frmt::format("pid {}  metrics {}  shards {}\n", view.pid(), view.metricCnt(), shardCnt);
+  for (size_t m = 0; m < now.size(); ++m) {
+    const std::string_view name = view.name(m);
+    if (name.find(options.filter) == std::string_view::npos) {
+      continue;
+    }
+    std::cout << frmt::format("{:<48} {:<9}", name, kindName(view.kind(m)));
+    if (view.kind(m) == MetricKind::Histogram) {
+      if (options.shards) {
+        for (size_t s = 0; s < shardCnt; ++s) {
+          std::cout << frmt::format("\n  {:<46} {}", view.shardName(s), histogramText(view.histogram(m, s)));
+        }
+      }
+      else {
+        std::cout << ' ' << histogramText(view.histogram(m));
+      }
+    }
+    else if (options.shards) {
+      for (size_t s = 0; s < shardCnt && s < now[m].size(); ++s) {
+        const uint64_t previous = m < before.size() && s < before[m].size() ? before[m][s] : 0;
+        std::cout << frmt::format("  {}={}", view.shardName(s), scalarText(view, m, now[m][s], previous, seconds));
+      }
+    }
+    else {
+      uint64_t total = 0, previous = 0;
+      for (size_t s = 0; s < now[m].size(); ++s) {
+        total += now[m][s];
+        previous += m < before.size() && s < before[m].size() ? before[m][s] : 0;
+      }
+      std::cout << ' ' << scalarText(view, m, total, previous, seconds);
+    }
+    std::cout << '\n';
+  }
+  std::cout << std::flush;
+}
+
+void printJson(const MetricsView & view, const Options & options) {
+  const size_t shardCnt = view.shardCnt();
+  std::cout << frmt::format("{{\"pid\": {}, \"metrics\": {{", view.pid());
+  bool first = true;
+  for (size_t m = 0, cnt = view.metricCnt(); m < cnt; ++m) {
+    const std::string_view name = view.name(m);
+    if (name.find(options.filter) == std::string_view::npos) {
+      continue;
+    }
+    std::cout << frmt::format("{}\n  \"{}\": {{\"kind\": \"{}\"", first ? "" : ",", name, kindName(view.kind(m)));
+    first = false;
+    if (view.kind(m) == MetricKind::Histogram) {
+      const MetricsView::HistogramValue hist = view.histogram(m);
+      std::cout << frmt::format(", \"count\": {}, \"sum\": {}, \"p50\": {}, \"p99\": {}, \"p999\": {}",
+        hist.count, hist.sum, hist.percentile(0.5), hist.percentile(0.99), hist.percentile(0.999));
+    }
+    else {
+      const bool gauge = view.kind(m) == MetricKind::Gauge;
+      auto text = [gauge] (uint64_t value) {
+        return gauge ? std::to_string(static_cast<int64_t>(value)) : std::to_string(value);
+      };
+      std::cout << ", \"value\": " << text(view.total(m));
+      if (options.shards) {
+        std::cout << ", \"shards\": {";
+        for (size_t s = 0; s < shardCnt; ++s) {
+          std::cout << frmt::format("{}\"{}\": {}", s ? ", " : "", view.shardName(s), text(view.value(m, s)));
+        }
+        std::cout << '}';
+      }
+    }
+    std::cout << '}';
+  }
+  std::cout << "\n}}\n" << std::flush;
+}
+
+}
+
+int main(int argc, char ** argv) {
+  Options options;
+  try {
+    for (int i = 1; i < argc; ++i) {
+      const std::string_view arg(argv[i]);
+      const size_t eq = arg.find('=');
+      const std::string_view key = arg.substr(0, eq);
+      const std::string value(eq == std::string_view::npos ? std::string_view() : arg.substr(eq + 1));
+      if (key == "--filter") options.filter = value;
+      else if (key == "--shards") options.shards = true;
+      else if (key == "--json") options.json = true;
+      else if (key == "--watch") options.watchMs = fromString<int64_t>(value);
+      else if (!arg.starts_with("--") && options.file.empty()) options.file = arg;
+      else {
+        usage();
+        return arg == "--help" ? 0 : 1;
+      }
+    }
+    if (options.file.empty()) {
+      usage();
+      return 1;
+    }
+
+    const ReadableMmap file(options.file);
+    const MetricsView view(file.data(), file.size());
+    if (options.watchMs <= 0) {
+      if (options.json) {
+        printJson(view, options);
+      }
+      else {
+        printTable(view, options, sample(view), {}, 0);
+      }
+      return 0;
+    }
+
+    Sample before = sample(view);
+    auto last = std::chrono::steady_clock::now();
+    for (;;) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(options.watchMs));
+      const auto now = std::chrono::steady_clock::now();
+      Sample current = sample(view);
+      if (options.json) {
+        printJson(view, options);
+      }
+      else {
+        printTable(view, options, current, before, std::chrono::duration<double>(now - last).count());
+      }
+      before = std::move(current);
+      last = now;
+    }
+  }
+  catch (const std::exception & ex) {
+    std::cerr << "hw_metrics: " << ex.what() << std::endl;
+    return 1;
+  }
+}